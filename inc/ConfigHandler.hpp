@@ -11,22 +11,50 @@ class ConfigHandler {
 private:
     string configFilePath;
     map<string, string> settings;
+    map<string, string> defaults;
     
     void loadDefaults();
     string trim(const string& str) const;
     
+    // Integer setting in [minValue, maxValue]; anything else is reported on
+    // cerr and the default is used instead
+    int getInt(const string& key, int minValue, int maxValue) const;
+    
 public:
     ConfigHandler(const string& filePath = "../data/config.ini");
     
     // Load and save
     bool loadConfig();
     bool saveConfig();
+    void applyEnvironment();    // Server settings from environment variables
     
     // Getters
     bool getColorsEnabled() const;
     Priority getDefaultPriority() const;
     bool getAutoSaveEnabled() const;
     int getDefaultViewCount() const;
+    string getSqliteSynchronous() const;
+    int getSqliteReadConnections() const;
+    string getStorageBackend() const;
+    int getCacheMemoryMB() const;
+    bool getCacheWriteBack() const;
+    string getPostgresHost() const;
+    string getPostgresPort() const;
+    string getPostgresDatabase() const;
+    string getPostgresUser() const;
+    string getPostgresPassword() const;     // Empty: libpq uses PGPASSWORD or ~/.pgpass
+    int getCompressMinBytes() const;
+    int getMaxEventSubscribers() const;
+    int getChangeLogEvents() const;
+    string getHost() const;
+    int getPort() const;
+    int getServerThreads() const;
+    int getMaxInFlight() const;
+    int getKeepAliveMaxCount() const;
+    int getKeepAliveTimeoutSec() const;
+    int getReadTimeoutSec() const;
+    int getWriteTimeoutSec() const;
+    bool getTcpNodelay() const;
     
     // Setters
     void setColorsEnabled(bool enabled);
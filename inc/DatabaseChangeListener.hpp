@@ -0,0 +1,47 @@
+#ifndef DATABASECHANGELISTENER_HPP
+#define DATABASECHANGELISTENER_HPP
+
+#include "DatabaseHandler.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+
+using namespace std;
+
+// Background thread on a dedicated connection that LISTENs for task writes
+// committed by any process and hands them to a callback, e.g.
+//   listener.start([&](const vector<TaskChange>& changes) {
+//       for (const auto& change : changes) manager.applyChange(change);
+//   });
+// The callback runs on the listener thread.
+class DatabaseChangeListener {
+private:
+    string host, port, dbname, user, password;
+    unique_ptr<DatabaseHandler> connection;
+    atomic<int> ignoredBackend;     // 0: none
+    thread worker;
+    atomic<bool> running;
+
+    bool openConnection();
+    void run(function<void(const vector<TaskChange>&)> onChanges);
+
+public:
+    DatabaseChangeListener(const string& host = "localhost",
+                           const string& port = "5432",
+                           const string& dbname = "taskmanager",
+                           const string& user = "postgres",
+                           const string& password = "");
+    ~DatabaseChangeListener();
+
+    // Skip writes made by this server process (DatabaseHandler::backendPid),
+    // e.g. the caller's own connection. Replaces the previous one; may be
+    // called while running, such as after that connection reconnected.
+    void setIgnoredBackend(int backendPid);
+
+    bool start(function<void(const vector<TaskChange>&)> onChanges);
+    void stop();
+    bool isRunning() const;
+};
+
+#endif // DATABASECHANGELISTENER_HPP
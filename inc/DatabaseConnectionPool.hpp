@@ -0,0 +1,70 @@
+#ifndef DATABASECONNECTIONPOOL_HPP
+#define DATABASECONNECTIONPOOL_HPP
+
+#include "DatabaseHandler.hpp"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Fixed set of PostgreSQL connections shared by worker threads. Each
+// DatabaseHandler (and its prepared statements) is used by one thread at a
+// time; the server handles the concurrency between connections.
+class DatabaseConnectionPool {
+public:
+    // Exclusive use of one connection; returned to the pool on destruction
+    class Lease {
+    private:
+        DatabaseConnectionPool* pool;
+        DatabaseHandler* handler;
+
+    public:
+        Lease(DatabaseConnectionPool* owner, DatabaseHandler* conn);
+        Lease(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+        ~Lease();
+
+        DatabaseHandler& operator*() const { return *handler; }
+        DatabaseHandler* operator->() const { return handler; }
+    };
+
+private:
+    string host, port, dbname, user, password;
+    size_t connectionCount;
+
+    vector<unique_ptr<DatabaseHandler>> connections;
+    vector<DatabaseHandler*> idleConnections;
+    mutex poolMutex;
+    condition_variable connectionAvailable;
+
+    void release(DatabaseHandler* handler);
+
+public:
+    DatabaseConnectionPool(size_t size = 4,
+                           const string& host = "localhost",
+                           const string& port = "5432",
+                           const string& dbname = "taskmanager",
+                           const string& user = "postgres",
+                           const string& password = "");
+    ~DatabaseConnectionPool();
+
+    DatabaseConnectionPool(const DatabaseConnectionPool&) = delete;
+    DatabaseConnectionPool& operator=(const DatabaseConnectionPool&) = delete;
+
+    // Opens every connection and creates the schema once
+    bool open();
+    void close();
+    bool isOpen() const;
+
+    // Blocks until a connection is free
+    Lease acquire();
+
+    size_t size() const;
+};
+
+#endif // DATABASECONNECTIONPOOL_HPP
@@ -2,6 +2,9 @@
 #define DATABASEHANDLER_HPP
 
 #include "Task.hpp"
+#include "TaskChange.hpp"
+#include <functional>
+#include <optional>
 #include <vector>
 #include <string>
 #include <libpq-fe.h>
@@ -12,6 +15,8 @@ class DatabaseHandler {
 private:
     PGconn* conn;
     string connectionString;
+    bool statementsPrepared;    // Named statements exist on this connection
+    function<bool(int)> ignoreBackend;  // Drops notifications sent by a session
     
     bool executeQuery(const string& query);
     PGresult* executeSelect(const string& query);
@@ -19,6 +24,28 @@ private:
     Status parseStatus(const string& str);
     string priorityToString(Priority priority);
     string statusToString(Status status);
+    Task rowToTask(PGresult* res, int row);
+
+    // Named prepared statements, created on first use per connection
+    bool prepareStatements();
+    vector<string> taskParams(const Task& task, bool withId);
+    PGresult* executePrepared(const char* name, const vector<string>& params);
+
+    // Statements sent per pipeline window before reading the replies
+    static const size_t PIPELINE_WINDOW = 256;
+    int runPipelined(const char* name, const vector<vector<string>>& paramSets,
+                     const function<void(size_t, PGresult*)>& onResult);
+
+    // Binary COPY helpers; rows are sent to the server in chunks of this size
+    static const size_t COPY_CHUNK_BYTES = 1 << 20;
+    bool copyTasksIn(const vector<Task>& tasks);
+    bool sendCopyChunk(string& buffer);
+    void appendCopyRow(string& buffer, const Task& task);
+    size_t decodeCopyRow(const char* data, size_t length, Task& task);
+    bool finishCommand(const char* context);
+    
+    // settings.next_id and the id sequence, inside the caller's transaction
+    bool storeNextId(int nextId);
     
 public:
     DatabaseHandler(const string& host = "localhost", 
@@ -38,16 +65,41 @@ public:
     bool createSchema();
     bool dropSchema();
     
-    // Task operations
+    // Task operations; both run as a single binary COPY
     bool saveTasks(const vector<Task>& tasks, int nextId);
     bool loadTasks(vector<Task>& tasks, int& nextId);
     
+    // One transaction that upserts written (keeping their ids) and deletes
+    // deleted; each row write is announced to listeners
+    bool saveChanges(const vector<Task>& written, const vector<int>& deleted, int nextId);
+
+    // Visit rows in id order as they arrive instead of buffering the result
+    bool streamTasks(const function<bool(const Task&)>& onTask);
+    
+    // Change feed: triggers NOTIFY every committed task write. A connection
+    // that listens must not be used for anything else while waiting.
+    bool listenForChanges();
+    // Blocks up to timeoutMs; returns the changes received (with current rows)
+    vector<TaskChange> waitForChanges(int timeoutMs);
+    // Server process of this connection; a listener told to ignore it skips
+    // the connection's own writes. The filter is asked about every
+    // notification, on the waiting thread.
+    int backendPid();
+    void setNotificationFilter(function<bool(int backendPid)> ignore);
+    
     // Individual task operations (for API)
     int insertTask(const Task& task);
     bool updateTask(const Task& task);
     bool deleteTask(int id);
-    Task* getTaskById(int id);
+    optional<Task> getTaskById(int id);
     vector<Task> getAllTasks();
+
+    // Many single-row operations pipelined: sent without waiting for each
+    // reply. insertTasks returns the new ids (-1 where an insert failed);
+    // the others return how many statements succeeded, or -1.
+    vector<int> insertTasks(const vector<Task>& tasks);
+    int updateTasks(const vector<Task>& tasks);
+    int deleteTasks(const vector<int>& ids);
 };
 
 #endif // DATABASEHANDLER_HPP
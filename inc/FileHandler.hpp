@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <functional>
 
 using namespace std;
 
@@ -26,6 +27,10 @@ public:
     // Save and load operations
     bool saveTasks(const vector<Task>& tasks, int nextId);
     bool loadTasks(vector<Task>& tasks, int& nextId);
+
+    // Parse the file one task at a time without holding the whole list.
+    // Stops early if onTask returns false.
+    bool streamTasks(const function<bool(const Task&)>& onTask, int& nextId);
     
     // Utility
     bool fileExists() const;
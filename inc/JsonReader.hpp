@@ -0,0 +1,65 @@
+#ifndef JSONREADER_HPP
+#define JSONREADER_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Receives the parts of a JSON document in order (SAX style). Strings and
+// numbers are views that are only valid during the call: unescaped strings
+// point into the input, escaped ones into a buffer the reader reuses.
+// Returning false stops the parse.
+class JsonHandler {
+public:
+    virtual ~JsonHandler() = default;
+
+    virtual bool startObject() { return true; }
+    virtual bool endObject() { return true; }
+    virtual bool startArray() { return true; }
+    virtual bool endArray() { return true; }
+    virtual bool key(string_view /*name*/) { return true; }
+    virtual bool stringValue(string_view /*value*/) { return true; }
+    virtual bool numberValue(string_view /*text*/) { return true; }   // Valid JSON number text
+    virtual bool boolValue(bool /*value*/) { return true; }
+    virtual bool nullValue() { return true; }
+
+    // Why the handler stopped the parse
+    virtual string stopReason() const { return "rejected by handler"; }
+};
+
+// Strict RFC 8259 parser that builds nothing itself: it validates the input
+// and passes each token to a JsonHandler, so a handler can decode straight
+// into its own structures.
+class JsonReader {
+public:
+    static const int MAX_DEPTH = 64;
+
+    // Parses exactly one JSON value (surrounding whitespace allowed). On
+    // failure error says what was wrong and at which byte.
+    static bool parse(string_view json, JsonHandler& handler, string& error);
+
+private:
+    string_view input;
+    size_t pos;
+    JsonHandler& handler;
+    string scratch;     // Decoded text of the current escaped string
+    string error;
+
+    JsonReader(string_view json, JsonHandler& handler);
+
+    bool fail(const string& message);
+    void skipWhitespace();
+    bool parseValue(int depth);
+    bool parseObject(int depth);
+    bool parseArray(int depth);
+    size_t plainRunEnd(size_t from) const;
+    bool parseString(string_view& out);
+    bool parseNumber();
+    bool parseLiteral(const char* word, size_t length);
+    bool parseHex4(unsigned& code);
+    static void appendUtf8(string& out, unsigned code);
+};
+
+#endif // JSONREADER_HPP
@@ -0,0 +1,44 @@
+#ifndef POSTGRESTASKSTORE_HPP
+#define POSTGRESTASKSTORE_HPP
+
+#include "DatabaseChangeListener.hpp"
+#include "DatabaseHandler.hpp"
+#include "TaskManager.hpp"
+#include <string>
+
+using namespace std;
+
+// Runs a TaskManager on PostgreSQL (storage_backend=postgresql). The manager
+// keeps every task in memory. One writer connection loads and saves it, and a
+// DatabaseChangeListener applies the writes other processes commit.
+class PostgresTaskStore {
+private:
+    DatabaseHandler writer;
+    DatabaseChangeListener listener;
+
+    // Reopens the writer after the server dropped it
+    bool ensureConnected();
+
+public:
+    PostgresTaskStore(const string& host = "localhost",
+                      const string& port = "5432",
+                      const string& dbname = "taskmanager",
+                      const string& user = "postgres",
+                      const string& password = "");
+    ~PostgresTaskStore();
+
+    // Connects the writer and creates the schema
+    bool open();
+
+    // Load and save callbacks for TaskManager(ExternalStore). The manager
+    // calls them under its lock, which also serializes the writer connection.
+    TaskManager::ExternalStore binding();
+
+    // Applies changes from other processes to manager, reloading it when the
+    // feed asks for that. The writer's own writes are skipped. manager must
+    // outlive stop().
+    bool startListening(TaskManager& manager);
+    void stop();
+};
+
+#endif // POSTGRESTASKSTORE_HPP
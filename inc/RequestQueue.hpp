@@ -0,0 +1,104 @@
+#ifndef REQUESTQUEUE_HPP
+#define REQUESTQUEUE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Worker pool for the API server's connections, with admission control.
+// At most `workers` jobs run at once and the rest wait in FIFO order, but
+// no more than `maxInFlight` are ever running or waiting: a job past that is
+// not queued behind the backlog. It runs straight away on one of a few
+// overflow threads with shedding() true, so it can be answered "busy" at
+// once. If the overflow queue is full as well, enqueue() refuses the job.
+//
+// A job that will hold its thread for a long time (an event stream) calls
+// markLongLived(); it then stops counting against either limit, and a
+// worker thread is started in its place if none is idle. Up to `longLived`
+// such replacements run at once; each exits again once a long-lived job
+// ends and leaves a thread to spare, so only `workers` threads plus the
+// overflow threads exist while nothing streams. Thread-safe.
+class RequestQueue {
+public:
+    static const size_t OVERFLOW_THREADS = 2;
+    static const size_t OVERFLOW_QUEUE = 64;
+
+    struct Stats {
+        uint64_t admitted = 0;          // Jobs queued for a worker
+        uint64_t shed = 0;              // Jobs sent to the overflow threads
+        uint64_t refused = 0;           // Jobs refused because those were busy too
+        uint64_t running = 0;
+        uint64_t queued = 0;
+        uint64_t maxQueued = 0;
+        uint64_t longLived = 0;
+        uint64_t threads = 0;           // Worker threads, replacements included
+        double avgQueueWaitMicros = 0;  // Enqueue to start on a worker
+        double p99QueueWaitMicros = 0;  // Upper bound, to a power of two
+        double maxQueueWaitMicros = 0;
+    };
+
+private:
+    struct Job {
+        function<void()> run;
+        chrono::steady_clock::time_point queuedAt;
+    };
+
+    // Queue wait histogram: bucket i counts waits below 2^(i+1) microseconds
+    static const size_t WAIT_BUCKETS = 32;
+
+    size_t workers;
+    size_t maxInFlight;
+    size_t maxLongLived;
+
+    mutable mutex queueMutex;
+    condition_variable workReady;
+    condition_variable overflowReady;
+    deque<Job> jobs;
+    deque<Job> overflowJobs;
+    size_t running;
+    size_t workerThreads;
+    bool stopping;
+    list<thread> threads;
+    vector<thread::id> exited;      // Replacements that finished; joined on the next start
+
+    Stats stats;
+    double totalQueueWaitMicros;
+    uint64_t waitBuckets[WAIT_BUCKETS];
+
+    // Expect queueMutex to be held
+    void startWorker();
+    void joinExited();
+
+    void work();
+    void workOverflow();
+    void recordWait(double micros);
+
+public:
+    RequestQueue(size_t workers, size_t maxInFlight, size_t longLived = 0);
+    ~RequestQueue();
+
+    RequestQueue(const RequestQueue&) = delete;
+    RequestQueue& operator=(const RequestQueue&) = delete;
+
+    // False if the job could not be taken at all
+    bool enqueue(function<void()> job);
+
+    // Runs the jobs already queued, then joins the threads
+    void shutdown();
+
+    // Called from inside a job
+    static bool shedding();
+    static void markLongLived();
+
+    Stats getStats() const;
+};
+
+#endif // REQUESTQUEUE_HPP
@@ -0,0 +1,106 @@
+#ifndef RESPONSECACHE_HPP
+#define RESPONSECACHE_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+// Serialized API responses keyed by path, each valid for one store version.
+// A body that depends on the clock (isOverdue) also carries the time it
+// stops being correct. Entries from older versions are dropped as soon as
+// a newer one is stored. Within a version, at most maxEntries entries and
+// about capacityBytes of keys and bodies are kept; the least recently used
+// go first. Thread-safe.
+class ResponseCache {
+public:
+    enum class Encoding {
+        IDENTITY,
+        GZIP,
+        DEFLATE
+    };
+
+    struct Entry {
+        uint64_t version;
+        time_t validUntil;      // 0 = does not depend on the clock
+        string etag;            // Quoted, derived from the body
+        string body;
+
+        // Body in a compressed encoding, made on first use and kept with
+        // the entry; empty if compression failed
+        const string& compressed(Encoding encoding) const;
+
+    private:
+        mutable once_flag gzipOnce;
+        mutable once_flag deflateOnce;
+        mutable string gzipBody;
+        mutable string deflateBody;
+    };
+
+    static const size_t DEFAULT_MAX_ENTRIES = 1024;
+    static const size_t DEFAULT_CAPACITY_BYTES = 64 * 1024 * 1024;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+private:
+    struct Slot {
+        shared_ptr<const Entry> entry;
+        list<string>::iterator recent;
+        size_t bytes;
+    };
+
+    mutable mutex cacheMutex;
+    unordered_map<string, Slot> entries;
+    mutable list<string> lru;   // Keys, front = most recently used
+    size_t maxEntries;
+    size_t capacityBytes;
+    size_t usedBytes;
+    uint64_t newestVersion;
+    mutable Stats stats;
+
+    void removeAll();
+    void evictIfNeeded();
+
+    static void acceptedQualities(const string& acceptEncoding, double& gzip, double& deflate,
+                                  double& identity, bool& identityListed);
+
+public:
+    explicit ResponseCache(size_t maxEntries = DEFAULT_MAX_ENTRIES,
+                           size_t capacityBytes = DEFAULT_CAPACITY_BYTES);
+
+    // Null unless the entry was built at this version and is still current
+    shared_ptr<const Entry> get(const string& key, uint64_t version, time_t now) const;
+
+    shared_ptr<const Entry> put(const string& key, uint64_t version, time_t validUntil, string body);
+
+    void clear();
+    Stats getStats() const;
+
+    static string makeETag(const string& body);
+    // True if an If-None-Match header value matches etag
+    static bool matchesETag(const string& ifNoneMatch, const string& etag);
+
+    // Preferred encoding allowed by an Accept-Encoding header. IDENTITY
+    // when no coding is acceptable, even if identity;q=0 refused it too.
+    static Encoding negotiate(const string& acceptEncoding);
+    // True if the header refuses an uncompressed body (identity;q=0, or
+    // *;q=0 without an identity entry)
+    static bool refusesIdentity(const string& acceptEncoding);
+    static const char* encodingName(Encoding encoding);
+    // Each encoding is a different representation, so it gets its own tag
+    static string encodedETag(const string& etag, Encoding encoding);
+    static bool compress(const string& input, Encoding encoding, string& output);
+};
+
+#endif // RESPONSECACHE_HPP
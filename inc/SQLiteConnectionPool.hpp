@@ -0,0 +1,73 @@
+#ifndef SQLITECONNECTIONPOOL_HPP
+#define SQLITECONNECTIONPOOL_HPP
+
+#include "SQLiteHandler.hpp"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Shares one SQLite database across threads: a fixed set of read-only
+// connections that run in parallel (WAL), plus one writer connection that
+// callers take in turn. Every SQLiteHandler is used by one thread at a time.
+class SQLiteConnectionPool {
+public:
+    // Exclusive use of one connection; returned to the pool on destruction
+    class Lease {
+    private:
+        SQLiteConnectionPool* pool;
+        SQLiteHandler* handler;
+        bool writer;
+
+    public:
+        Lease(SQLiteConnectionPool* owner, SQLiteHandler* conn, bool isWriter);
+        Lease(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+        ~Lease();
+
+        SQLiteHandler& operator*() const { return *handler; }
+        SQLiteHandler* operator->() const { return handler; }
+    };
+
+private:
+    string dbPath;
+    string synchronousMode;
+    size_t readerCount;
+
+    unique_ptr<SQLiteHandler> writerConnection;
+    mutex writerMutex;
+
+    vector<unique_ptr<SQLiteHandler>> readerConnections;
+    vector<SQLiteHandler*> idleReaders;
+    mutex readerMutex;
+    condition_variable readerAvailable;
+
+    void release(SQLiteHandler* handler, bool isWriter);
+
+public:
+    SQLiteConnectionPool(const string& path = "../data/tasks.db",
+                         size_t readers = 4,
+                         const string& synchronous = "NORMAL");
+    ~SQLiteConnectionPool();
+
+    SQLiteConnectionPool(const SQLiteConnectionPool&) = delete;
+    SQLiteConnectionPool& operator=(const SQLiteConnectionPool&) = delete;
+
+    // Opens the writer first (creates schema, enables WAL), then the readers
+    bool open();
+    void close();
+    bool isOpen() const;
+
+    // Block until a connection is free
+    Lease acquireReader();
+    Lease acquireWriter();
+
+    size_t getReaderCount() const;
+};
+
+#endif // SQLITECONNECTIONPOOL_HPP
@@ -2,44 +2,140 @@
 #define SQLITEHANDLER_HPP
 
 #include "Task.hpp"
+#include "TaskQuery.hpp"
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <sqlite3.h>
 
 using namespace std;
 
+// A full-text search hit: lower rank is a better match (bm25)
+struct TaskSearchResult {
+    Task task;
+    double rank;
+    string snippet;
+};
+
 class SQLiteHandler {
 private:
     sqlite3* db;
     string dbPath;
-    
+    string synchronousMode;
+    bool ftsAvailable;
+    bool readOnly;
+    int schemaVersion;      // PRAGMA user_version of the tasks layout
+
     Priority parsePriority(const string& str);
     Status parseStatus(const string& str);
     string priorityToString(Priority priority);
     string statusToString(Status status);
-    
+
+    // Enum encoding for the current layout: TEXT names in v1, integer
+    // codes from v2 on; decoding accepts either
+    void bindPriority(sqlite3_stmt* stmt, int index, Priority priority);
+    void bindStatus(sqlite3_stmt* stmt, int index, Status status);
+    Priority decodePriority(sqlite3_stmt* stmt, int column);
+    Status decodeStatus(sqlite3_stmt* stmt, int column);
+
+    // Schema versioning
+    int readUserVersion();
+    bool tableExists(const char* name);
+    bool createIndexes();
+    bool migrateToV2(int batchSize);
+    bool createSyncStateTable();
+
+    // Statement helpers
+    bool execute(const char* sql, const char* context);
+    bool commitOrRollback();
+    int queryInt(const char* sql, int fallback);
+    void bindTaskFields(sqlite3_stmt* stmt, const Task& task, int firstIndex);
+    Task rowToTask(sqlite3_stmt* stmt);
+    string sortColumn(TaskSortField field) const;
+    string buildWhereClause(const TaskQuery& query) const;
+    void bindQueryParams(sqlite3_stmt* stmt, const TaskQuery& query);
+    bool createSearchIndex();
+    string buildMatchExpression(const string& keywords) const;
+    vector<TaskSearchResult> searchTasksLike(const string& keywords, int limit);
+
 public:
     SQLiteHandler(const string& path = "../data/tasks.db");
     ~SQLiteHandler();
-    
-    // Connection management
-    bool connect();
+
+    // Connection management; read-only connections skip schema creation
+    // and require the database (and its schema) to already exist
+    bool connect(bool openReadOnly = false);
     void disconnect();
     bool isConnected();
-    
+    bool isReadOnly() const;
+
+    // PRAGMA synchronous level applied at connect(): OFF, NORMAL, FULL or EXTRA
+    bool setSynchronous(const string& level);
+    string getSynchronous() const;
+
     // Schema operations
     bool createSchema();
-    
+    int getSchemaVersion() const;
+
+    // Upgrades an older layout to the latest version. Rows are copied in
+    // batches of batchSize, each in its own transaction, so readers keep
+    // working on the old layout until the final switch-over commit.
+    bool migrateSchema(int batchSize = 10000);
+
+    // Transactions
+    bool beginTransaction();
+    bool commitTransaction();
+    bool rollbackTransaction();
+
     // Task operations
     bool saveTasks(const vector<Task>& tasks, int nextId);
     bool loadTasks(vector<Task>& tasks, int& nextId);
-    
+
+    // Insert or update tasks keeping their ids; returns rows written or -1.
+    // Runs inside the caller's transaction, if any.
+    int upsertTasks(const vector<Task>& tasks);
+
+    // Bulk loading: drop secondary indexes and search triggers, then rebuild
+    // them once at the end. The pending state survives restarts, so an
+    // interrupted load is finished by calling finishBulkLoad() later.
+    bool beginBulkLoad();
+    bool finishBulkLoad();
+    bool isBulkLoadPending();
+
+    // Key/value rows in the settings table
+    bool setSetting(const string& key, const string& value);
+    optional<string> getSetting(const string& key);
+    bool deleteSetting(const string& key);
+
+    // Content hash of each task as of the last JSON sync (see TaskSync)
+    unordered_map<int, int64_t> loadSyncState();
+    bool updateSyncState(const vector<pair<int, int64_t>>& changed, const vector<int>& removed);
+
     // Individual task operations (for API)
     int insertTask(const Task& task);
     bool updateTask(const Task& task);
     bool deleteTask(int id);
-    Task* getTaskById(int id);
+    optional<Task> getTaskById(int id);
     vector<Task> getAllTasks();
+    // Visit rows in id order without materializing the table; stops early
+    // if onTask returns false
+    bool streamTasks(const function<bool(const Task&)>& onTask);
+
+    // Bulk operations; return the number of affected rows or -1 on error
+    int markAllComplete();
+    int deleteTasksByStatus(Status status);
+    int deleteAllTasks();
+    int changePriority(Priority oldPriority, Priority newPriority);
+
+    // Filtered/sorted/paged reads evaluated inside SQLite
+    vector<Task> queryTasks(const TaskQuery& query);
+    int countTasks(const TaskQuery& query);
+
+    // Ranked full-text search over title and description (FTS5)
+    vector<TaskSearchResult> searchTasks(const string& keywords, int limit = 20);
 };
 
 #endif // SQLITEHANDLER_HPP
@@ -0,0 +1,73 @@
+#ifndef TASKCACHE_HPP
+#define TASKCACHE_HPP
+
+#include "Task.hpp"
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// LRU cache of tasks bounded by an approximate memory budget in bytes.
+// Pointers returned by get()/put() stay valid until that entry is evicted,
+// i.e. until the next put() or clear().
+class TaskCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t writeBacks = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t capacityBytes = 0;
+    };
+
+private:
+    struct Entry {
+        Task task;
+        size_t bytes;
+        size_t cleanHash;   // Fingerprint of the task as last persisted
+        bool dirty;
+    };
+
+    list<Entry> lru;        // Front = most recently used
+    unordered_map<int, list<Entry>::iterator> index;
+    size_t capacityBytes;
+    size_t usedBytes;
+    Stats stats;
+    function<bool(const Task&)> writeBackHandler;
+
+    static size_t fingerprint(const Task& task);
+    bool isModified(const Entry& entry) const;
+    void evictIfNeeded();
+
+public:
+    TaskCache(size_t capacityBytes);
+
+    // Called with each modified entry before it is evicted. If it returns
+    // false the entry stays cached (over budget) and is retried later.
+    void setWriteBackHandler(function<bool(const Task&)> handler);
+
+    // Lookup; counts a hit or miss and marks the entry most recently used.
+    // Callers may modify the returned task; collectModified() picks it up.
+    Task* get(int id);
+
+    // Insert or replace; `dirty` marks a task that is not yet persisted
+    Task* put(const Task& task, bool dirty = false);
+
+    bool erase(int id);
+    void clear();
+
+    // Every entry changed since it was stored. They stay modified until
+    // markClean() is given the copies that were persisted.
+    vector<Task> collectModified();
+    void markClean(const vector<Task>& persisted);
+
+    Stats getStats() const;
+    static size_t estimateSize(const Task& task);
+};
+
+#endif // TASKCACHE_HPP
@@ -0,0 +1,22 @@
+#ifndef TASKCHANGE_HPP
+#define TASKCHANGE_HPP
+
+#include "Task.hpp"
+#include <optional>
+
+using namespace std;
+
+// A task write made by another process sharing the same database
+struct TaskChange {
+    enum class Kind {
+        UPSERT,     // Task inserted or updated; `task` holds the new row
+        DELETE,     // Task removed
+        RELOAD      // Whole table replaced; drop everything cached
+    };
+
+    Kind kind = Kind::RELOAD;
+    int id = 0;                 // Unused for RELOAD
+    optional<Task> task;
+};
+
+#endif // TASKCHANGE_HPP
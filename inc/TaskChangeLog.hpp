@@ -0,0 +1,75 @@
+#ifndef TASKCHANGELOG_HPP
+#define TASKCHANGELOG_HPP
+
+#include "TaskChange.hpp"
+#include "Task.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// The most recent task writes in sequence order, for clients that follow
+// changes instead of re-reading the list. Each event is rendered to JSON once
+// when it is appended and shared by every reader, so fanning an event out
+// costs a pointer copy per subscriber. Only the newest `capacity` events are
+// kept; a reader that falls further behind is told to start over. Sequence
+// numbers restart with the process, so each log also has an epoch that
+// differs between runs. Thread-safe.
+class TaskChangeLog {
+public:
+    static const size_t DEFAULT_CAPACITY = 4096;
+
+    struct Event {
+        uint64_t seq;
+        TaskChange change;
+        string json;        // {"seq":..,"type":"upsert"|"delete"|"reload","id":..,"task":{..}}
+    };
+
+private:
+    mutable mutex logMutex;
+    mutable condition_variable appended;
+    deque<shared_ptr<const Event>> events;
+    size_t capacity;
+    uint64_t latestSeq;
+    uint64_t droppedSeq;    // Newest event no longer kept (0 = none)
+    uint64_t epoch;
+
+    static string render(uint64_t seq, const TaskChange& change);
+
+public:
+    explicit TaskChangeLog(size_t capacity = DEFAULT_CAPACITY);
+
+    // seq must increase with every call
+    void append(uint64_t seq, const TaskChange& change);
+
+    // Appends changes as seq firstSeq, firstSeq + 1, ... in one step, so no
+    // reader sees only part of them
+    void append(uint64_t firstSeq, const vector<TaskChange>& changes);
+
+    // Up to maxEvents events after `after`, oldest first. False if some of
+    // them were already dropped; the reader must then reload everything.
+    bool since(uint64_t after, size_t maxEvents, vector<shared_ptr<const Event>>& out) const;
+
+    // Net effect of the events after `after`: the last state of each task
+    // written since (by id) and the ids deleted since, up to and including
+    // seq upTo. False if the log cannot tell (events dropped, or a RELOAD in
+    // between); the caller must then send everything.
+    bool changesSince(uint64_t after, vector<Task>& changed, vector<int>& deleted, uint64_t& upTo) const;
+
+    void setCapacity(size_t count);
+
+    // Blocks until an event after `after` is appended or the timeout passes;
+    // true if there is one
+    bool waitFor(uint64_t after, chrono::milliseconds timeout) const;
+
+    uint64_t latest() const;
+    uint64_t getEpoch() const;
+};
+
+#endif // TASKCHANGELOG_HPP
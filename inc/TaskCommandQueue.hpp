@@ -0,0 +1,124 @@
+#ifndef TASKCOMMANDQUEUE_HPP
+#define TASKCOMMANDQUEUE_HPP
+
+#include "TaskManager.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+// Funnels every write to a TaskManager through one writer thread. Any
+// number of threads submit commands to a lock-free multi-producer queue;
+// the writer applies them in submission order, saves each batch once and
+// then completes the futures, e.g.
+//   future<int> id = queue.submit<int>([](TaskManager& m) { return m.addTask("Title", "Desc"); });
+// Reads can still go straight to the manager.
+class TaskCommandQueue {
+public:
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t applied = 0;
+        uint64_t batches = 0;
+        uint64_t depth = 0;             // Submitted but not yet applied
+        uint64_t maxDepth = 0;
+        double avgQueueWaitMicros = 0;  // Submit to start of apply
+        double maxQueueWaitMicros = 0;
+        double avgBatchMicros = 0;      // Applying and saving one batch
+        double maxBatchMicros = 0;
+        double avgBatchSize = 0;
+    };
+
+private:
+    struct Command {
+        function<void(TaskManager&)> apply;     // Runs on the writer, stores the result
+        function<void()> complete;              // Fulfils the future after the save
+        chrono::steady_clock::time_point submittedAt;
+    };
+
+    // Intrusive MPSC queue (Vyukov): producers swap `head` and link the
+    // previous node; only the writer thread follows `tail`
+    struct Node {
+        atomic<Node*> next;
+        Command command;
+        Node() : next(nullptr) {}
+    };
+
+    TaskManager& manager;
+    size_t maxBatch;
+
+    atomic<Node*> head;
+    Node* tail;
+    atomic<uint64_t> depth;     // Counted before the running check; see push()
+
+    // Only used to sleep while idle; producers take it when the queue was empty
+    mutex wakeMutex;
+    condition_variable wake;
+    atomic<bool> running;
+    thread writer;
+
+    // Producer-side counters, kept off statsMutex
+    atomic<uint64_t> submitted;
+    atomic<uint64_t> maxDepth;
+
+    // Writer-side counters
+    mutable mutex statsMutex;
+    Stats stats;
+    double totalQueueWaitMicros;
+    double totalBatchMicros;
+
+    void push(Command command);
+    bool pop(Command& command);
+    void run();
+
+public:
+    TaskCommandQueue(TaskManager& manager, size_t maxBatch = 256);
+    ~TaskCommandQueue();
+
+    TaskCommandQueue(const TaskCommandQueue&) = delete;
+    TaskCommandQueue& operator=(const TaskCommandQueue&) = delete;
+
+    // Applies whatever is still queued, then joins the writer
+    void stop();
+
+    template <typename T>
+    future<T> submit(function<T(TaskManager&)> command);
+
+    Stats getStats() const;
+};
+
+template <typename T>
+future<T> TaskCommandQueue::submit(function<T(TaskManager&)> command) {
+    auto done = make_shared<promise<T>>();
+    auto result = make_shared<T>();
+    auto error = make_shared<exception_ptr>();
+    future<T> pending = done->get_future();
+
+    Command queued;
+    queued.apply = [command, result, error](TaskManager& target) {
+        try {
+            *result = command(target);
+        } catch (...) {
+            *error = current_exception();
+        }
+    };
+    queued.complete = [done, result, error]() {
+        if (*error) {
+            done->set_exception(*error);
+        } else {
+            done->set_value(move(*result));
+        }
+    };
+    queued.submittedAt = chrono::steady_clock::now();
+    push(move(queued));
+    return pending;
+}
+
+#endif // TASKCOMMANDQUEUE_HPP
@@ -0,0 +1,55 @@
+#ifndef TASKINDEX_HPP
+#define TASKINDEX_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// Ordered (value, id) keys for one sort field, stored in sorted blocks of
+// bounded size. Copies share blocks and an insert or erase copies only the
+// block it touches, so each TaskSnapshot carries its indexes forward at the
+// cost of one block per write.
+class TaskIndex {
+public:
+    static const size_t BLOCK_SIZE = 4096;
+
+    struct Key {
+        long long value;
+        int id;
+
+        bool operator<(const Key& other) const {
+            return value != other.value ? value < other.value : id < other.id;
+        }
+        bool operator==(const Key& other) const {
+            return value == other.value && id == other.id;
+        }
+    };
+
+private:
+    using Block = vector<Key>;
+    vector<shared_ptr<const Block>> blocks;     // Never empty blocks, in key order
+    size_t keyCount;
+
+    // Block whose range should hold key (the last block if key is largest)
+    size_t blockFor(const Key& key) const;
+
+public:
+    TaskIndex();
+
+    static TaskIndex build(vector<Key> keys);
+
+    void insert(const Key& key);
+    void erase(const Key& key);
+    size_t size() const;
+    // Keys whose value lies in [low, high], without visiting them one by one
+    size_t count(long long low, long long high) const;
+
+    // Visits keys starting at `from` (ascending: keys >= from, descending:
+    // keys <= from, in reverse) until onKey returns false
+    void scan(const Key& from, bool descending, const function<bool(const Key&)>& onKey) const;
+};
+
+#endif // TASKINDEX_HPP
@@ -0,0 +1,82 @@
+#ifndef TASKJSONCACHE_HPP
+#define TASKJSONCACHE_HPP
+
+#include "Task.hpp"
+#include "TaskSnapshot.hpp"
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// API JSON for tasks, with each task's serialized fragment cached until that
+// task is written again. Fragments stop before "isOverdue", which depends on
+// the clock and is appended when a response is assembled. A field mask picks
+// a subset of fields; projections are written directly and skip the
+// excluded fields entirely. Thread-safe.
+class TaskJsonCache {
+public:
+    // Bits of a FieldMask, one per member of the task object
+    enum Field : uint32_t {
+        FIELD_ID = 1 << 0,
+        FIELD_TITLE = 1 << 1,
+        FIELD_DESCRIPTION = 1 << 2,
+        FIELD_PRIORITY = 1 << 3,
+        FIELD_STATUS = 1 << 4,
+        FIELD_CREATED_AT = 1 << 5,
+        FIELD_DUE_DATE = 1 << 6,
+        FIELD_IS_COMPLETED = 1 << 7,
+        FIELD_IS_OVERDUE = 1 << 8
+    };
+    using FieldMask = uint32_t;
+    static const FieldMask ALL_FIELDS = (1 << 9) - 1;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t entries = 0;
+    };
+
+private:
+    struct Fragment {
+        uint64_t revision;
+        string json;            // Object up to, not including, "isOverdue"
+        time_t dueDate;
+        bool completed;
+    };
+
+    mutable mutex cacheMutex;
+    unordered_map<int, Fragment> fragments;
+    Stats stats;
+
+    static void appendQuoted(string& out, const string& value);
+    static Fragment render(const Task& task, uint64_t revision);
+    static bool isOverdueAt(time_t dueDate, bool completed, time_t now, time_t& validUntil);
+    static void appendOverdue(string& out, const Fragment& fragment, time_t now, time_t& validUntil);
+    static void appendProjected(string& out, const Task& task, FieldMask fields, time_t now, time_t& validUntil);
+
+public:
+    // Comma-separated JSON member names ("id,title,status"); false if empty
+    // or a name is unknown
+    static bool parseFields(const string& list, FieldMask& fields);
+
+    // One task as a JSON object. validUntil is lowered to the first time an
+    // isOverdue flag in the output would flip (0 = never).
+    static string toJson(const Task& task, time_t now, time_t& validUntil, FieldMask fields = ALL_FIELDS);
+
+    // A JSON array
+    static string toJson(const vector<Task>& tasks, time_t now, time_t& validUntil,
+                         FieldMask fields = ALL_FIELDS);
+
+    // The snapshot as a JSON array, reusing fragments of unchanged tasks
+    // when every field is wanted
+    string toJson(const TaskSnapshot& snapshot, time_t now, time_t& validUntil,
+                  FieldMask fields = ALL_FIELDS);
+
+    Stats getStats() const;
+};
+
+#endif // TASKJSONCACHE_HPP
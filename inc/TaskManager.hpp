@@ -4,35 +4,171 @@
 #include "Task.hpp"
 #include "FileHandler.hpp"
 #include "CSVExporter.hpp"
+#include "TaskCache.hpp"
+#include "TaskChange.hpp"
+#include "TaskChangeLog.hpp"
+#include "TaskQuery.hpp"
+#include "TaskSnapshot.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
 #include <vector>
 #include <string>
+#include <unordered_set>
 
 using namespace std;
 
+class SQLiteConnectionPool;
+
 class TaskManager {
+public:
+    // One step of applyBatch(). Kinds avoid ADD/DELETE/UPDATE, which some system
+    // headers define as macros.
+    struct BatchStep {
+        enum class Kind { CREATE, EDIT, REMOVE, READ };
+        Kind kind = Kind::READ;
+        int id = 0;                         // EDIT, REMOVE and READ
+        string title;                       // CREATE
+        string description;                 // CREATE
+        Priority priority = Priority::MEDIUM;   // CREATE
+        function<void(Task&)> edit;         // EDIT
+    };
+    
+    // A store outside this library, such as the server's PostgreSQL backend.
+    // load fills the list. save gets the tasks written and the ids deleted
+    // since the last successful save. Bulk operations send only the tasks they
+    // touched, so rows other writers added meanwhile are left alone.
+    struct ExternalStore {
+        function<bool(vector<Task>& tasks, int& nextId)> load;
+        function<bool(const vector<Task>& written, const vector<int>& deleted, int nextId)> save;
+    };
+
 private:
     vector<Task> tasks;
     int nextId;
     FileHandler fileHandler;
     
-    // Auto-save after modifications
-    void autoSave();
+    // SQLite mode: a bounded cache of hot tasks over the pooled store
+    SQLiteConnectionPool* store;
+    unique_ptr<TaskCache> cache;
+    bool writeBack;
+    
+    // Between beginBatch() and endBatch(), autoSave() only notes the change
+    bool deferSaves;
+    bool pendingSave;
+    
+    // External store mode: ids written or deleted since the last save
+    ExternalStore external;
+    unordered_set<int> dirtyIds;
+    
+    // Guards tasks, nextId and the cache. JSON mode readers share it. A cache
+    // hit reorders the LRU list, so SQLite mode takes it exclusively around
+    // cache access and runs reader queries outside it.
+    mutable shared_mutex stateMutex;
+    
+    // JSON mode: immutable copy of tasks that readers load without locking.
+    // Writers publish the next one (atomic_store) while holding stateMutex.
+    // The version counts writes in both modes.
+    shared_ptr<const TaskSnapshot> snapshot;
+    atomic<uint64_t> version;
+    
+    // Every published write, numbered by the version it produced
+    TaskChangeLog changeLog;
+    
+    // Helpers below expect stateMutex to be held exclusively
+    
+    // Auto-save after modifications; changedId is the task written, or -1
+    // after markChanged() noted each one
+    void autoSave(int changedId = -1);
+    void markChanged(int id);
+    bool saveLocked();
+    Task* findLocked(int id);
+    
+    // Publish a write to snapshot readers and bump the version
+    void publishTask(const Task& task);
+    void publishErase(int id);
+    void publishAll();
+    void publishChanges(const vector<TaskChange>& changes);
+    
+    // SQLite mode helpers
+    bool persistTask(const Task& task);
+    bool flushCache();
 
 public:
-    // Constructor
+    // Constructor (JSON file mode: every task is held in memory)
     TaskManager();
+    
+    // SQLite mode: at most cacheBudgetBytes of tasks stay in memory. Misses
+    // read through from the store. Changes are written through on each
+    // modification, or with writeBackCache, on saveToFile() and eviction.
+    // getAllTasks() loads the whole table and the display/sort helpers work
+    // on what it loaded, so those are meant for small stores only. The pool
+    // must outlive the manager.
+    TaskManager(SQLiteConnectionPool& pool, size_t cacheBudgetBytes, bool writeBackCache = false);
+    
+    // Every task in memory as in JSON file mode, loaded from and saved to
+    // the given store. loadFromFile() reloads from it, after saving pending
+    // writes; if either fails the current list is kept.
+    explicit TaskManager(const ExternalStore& externalStore);
+    ~TaskManager();
 
     // Task management
     int addTask(const string& title, const string& description, 
                 Priority priority = Priority::MEDIUM);
     bool deleteTask(int id);
-    Task* findTaskById(int id);
     bool markTaskComplete(int id);
+    
+    // Copies for callers on several threads (the API server). updateTask()
+    // runs edit under the write lock, saves, and returns the updated task.
+    // In JSON mode the read calls use the current snapshot and never lock.
+    optional<Task> getTask(int id);
+    optional<Task> updateTask(int id, const function<void(Task&)>& edit);
+    vector<Task> snapshotTasks();
+    
+    // Applies every step or none, under one lock and with one save, and
+    // publishes the result at once (one snapshot, one block of change
+    // events). results[i] is the task step i added, edited or read (empty for
+    // REMOVE). Returns false without changing anything when a step's task
+    // does not exist (failedStep is its index) or when storing fails
+    // (failedStep is -1).
+    bool applyBatch(const vector<BatchStep>& steps, vector<optional<Task>>& results, int& failedStep);
+    
+    // Current immutable snapshot (null in SQLite mode, where reader
+    // connections already see a consistent WAL snapshot) and the version,
+    // which changes on every write
+    shared_ptr<const TaskSnapshot> getSnapshot() const;
+    uint64_t getVersion() const;
+    
+    // Recent writes for change feeds; an event's seq is the version it
+    // produced. Whole-list changes (load, saveToFile, bulk operations) are
+    // RELOAD events. The sortBy* methods only reorder the CLI's list, not
+    // any task or the id-ordered snapshot, so they publish nothing.
+    const TaskChangeLog& getChangeLog() const;
+    void setChangeLogCapacity(size_t events);
 
-    // Getters
+    // Pointer/reference into manager state, for single-threaded callers
+    // (the CLI); it is not protected once returned
+    Task* findTaskById(int id);
     vector<Task>& getAllTasks();
+
+    // Getters
     int getTaskCount() const;
     bool hasTasks() const;
+    
+    // Filtered/sorted/paged copies; pushed down to SQL in SQLite mode
+    vector<Task> queryTasks(const TaskQuery& query);
+    int countTasks(const TaskQuery& query);
+    
+    // Patch in-memory state after another process changed a task. Not saved
+    // locally. Returns false for a RELOAD in JSON mode: reload from the source.
+    bool applyChange(const TaskChange& change);
+    
+    // Storage mode and cache counters (all zero in JSON mode)
+    bool isStoreBacked() const;
+    TaskCache::Stats getCacheStats() const;
 
     // Display methods
     void displayAllTasks() const;
@@ -58,12 +194,17 @@ public:
     bool loadFromFile();
     bool saveToFile();
     
+    // Group commit: writes between the two calls are saved once, by
+    // endBatch(). Meant for a single writer such as TaskCommandQueue.
+    void beginBatch();
+    bool endBatch();
+    
     // Export operations
     bool exportToCSV(const string& filename = "tasks_export.csv");
     bool exportFilteredToCSV(Status status, const string& filename);
     bool exportFilteredToCSV(Priority priority, const string& filename);
     
-    // Bulk operations
+    // Bulk operations; the number of tasks changed, or -1 if storing failed
     int markAllComplete();
     int deleteAllCompleted();
     int deleteAllTasks();
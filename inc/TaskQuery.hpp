@@ -0,0 +1,102 @@
+#ifndef TASKQUERY_HPP
+#define TASKQUERY_HPP
+
+#include "Task.hpp"
+#include <ctime>
+#include <optional>
+#include <string>
+
+using namespace std;
+
+// Sort keys understood by storage backends; ties are broken by id in the
+// same direction
+enum class TaskSortField {
+    ID,
+    PRIORITY,
+    STATUS,
+    DUE_DATE,
+    CREATED_AT
+};
+
+// Sort field by its column name ("id", "priority", "status", "due_date",
+// "created_at"); false for anything else
+inline bool parseSortField(const string& name, TaskSortField& field) {
+    if (name == "id") field = TaskSortField::ID;
+    else if (name == "priority") field = TaskSortField::PRIORITY;
+    else if (name == "status") field = TaskSortField::STATUS;
+    else if (name == "due_date") field = TaskSortField::DUE_DATE;
+    else if (name == "created_at") field = TaskSortField::CREATED_AT;
+    else return false;
+    return true;
+}
+
+// Position of the last task on a page: its sort key and id. The next page
+// starts strictly after it, so pages stay stable while tasks are added.
+struct TaskCursor {
+    long long key = 0;
+    int id = 0;
+};
+
+// Filter, sort and paging options pushed down to the storage layer
+struct TaskQuery {
+    optional<Status> status;
+    optional<Priority> priority;
+    time_t dueFrom = 0;     // Inclusive lower due-date bound (0 = unbounded)
+    time_t dueTo = 0;       // Inclusive upper due-date bound (0 = unbounded)
+    optional<bool> overdue; // Same rule as Task::isOverdue()
+    time_t now = 0;         // Clock for the overdue filter (0 = current time)
+
+    TaskSortField sortBy = TaskSortField::ID;
+    bool descending = false;
+
+    optional<TaskCursor> after;     // Resume after this task in sort order
+    int limit = -1;         // -1 = no limit
+    int offset = 0;
+
+    time_t currentTime() const {
+        return now > 0 ? now : time(nullptr);
+    }
+
+    // Value a task is ordered by; tasks without a due date have key 0 and
+    // sort after every dated task in both directions
+    static long long sortKey(const Task& task, TaskSortField field) {
+        switch (field) {
+            case TaskSortField::PRIORITY: return static_cast<int>(task.getPriority());
+            case TaskSortField::STATUS: return static_cast<int>(task.getStatus());
+            case TaskSortField::DUE_DATE: return task.getDueDate();
+            case TaskSortField::CREATED_AT: return task.getCreatedAt();
+            case TaskSortField::ID:
+            default: return task.getId();
+        }
+    }
+
+    TaskCursor cursorAt(const Task& task) const {
+        return {sortKey(task, sortBy), task.getId()};
+    }
+
+    // True if the task sorts after the cursor (always true without one)
+    bool isAfterCursor(const Task& task) const {
+        if (!after) return true;
+        long long key = sortKey(task, sortBy);
+        if (sortBy == TaskSortField::DUE_DATE && (key == 0) != (after->key == 0)) {
+            return key == 0;
+        }
+        if (key != after->key) return descending ? key < after->key : key > after->key;
+        return descending ? task.getId() < after->id : task.getId() > after->id;
+    }
+
+    // Filter check for stores that evaluate queries in memory
+    bool matches(const Task& task) const {
+        if (status && task.getStatus() != *status) return false;
+        if (priority && task.getPriority() != *priority) return false;
+        if (dueFrom > 0 && task.getDueDate() < dueFrom) return false;
+        if (dueTo > 0 && (!task.hasDueDate() || task.getDueDate() > dueTo)) return false;
+        if (overdue) {
+            bool late = task.hasDueDate() && !task.isCompleted() && currentTime() > task.getDueDate();
+            if (late != *overdue) return false;
+        }
+        return isAfterCursor(task);
+    }
+};
+
+#endif // TASKQUERY_HPP
@@ -0,0 +1,33 @@
+#ifndef TASKREQUEST_HPP
+#define TASKREQUEST_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// The task fields of an API request body, decoded with JsonReader in one
+// pass and without building a document. Members not listed here are
+// skipped; a listed member of the wrong type is an error. null counts as
+// absent.
+struct TaskRequest {
+    optional<string> op;            // Batch operations only
+    optional<int> id;
+    optional<string> title;
+    optional<string> description;
+    optional<string> priority;
+    optional<string> status;
+
+    // One JSON object
+    static bool parse(string_view body, TaskRequest& request, string& error);
+
+    // A JSON array of objects. Reading stops after maxCount + 1 entries, so
+    // an oversized list is cut short instead of decoded in full; the caller
+    // checks requests.size() > maxCount.
+    static bool parseList(string_view body, vector<TaskRequest>& requests, size_t maxCount, string& error);
+};
+
+#endif // TASKREQUEST_HPP
@@ -0,0 +1,94 @@
+#ifndef TASKSNAPSHOT_HPP
+#define TASKSNAPSHOT_HPP
+
+#include "Task.hpp"
+#include "TaskIndex.hpp"
+#include "TaskQuery.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// Immutable view of every task at one version. Tasks are grouped by id into
+// fixed-size chunks, so a write copies only the chunk it touches and shares
+// the others with the previous snapshot. Each task also records the version
+// that last wrote it, so derived data can be cached per task. Ordered
+// indexes on the other sort fields are carried forward the same way. Safe to
+// read from any thread.
+class TaskSnapshot {
+public:
+    static const int CHUNK_SIZE = 256;
+
+private:
+    struct Entry {
+        Task task;
+        uint64_t revision;      // Version that last wrote this task
+    };
+    using Chunk = vector<Entry>;    // Sorted by id
+    struct ChunkSlot {
+        size_t key;                 // Holds ids key*CHUNK_SIZE..
+        shared_ptr<const Chunk> tasks;
+    };
+
+    uint64_t version;
+    // Non-empty chunks sorted by key. Only those are stored, so a sparse or
+    // very large id costs one slot rather than a slot per CHUNK_SIZE ids.
+    vector<ChunkSlot> chunks;
+    size_t taskCount;
+
+    TaskIndex byPriority;
+    TaskIndex byStatus;
+    TaskIndex byDueDate;        // 0 = no due date
+    TaskIndex byCreatedAt;
+
+    static size_t chunkIndex(int id);
+    // First slot whose key is not below k
+    vector<ChunkSlot>::const_iterator slotAt(size_t k) const;
+    // The chunk that would hold id, or null
+    const Chunk* chunkFor(int id) const;
+
+    // Moves a task's index keys; null = absent before/after the write
+    void reindexTask(const Task* before, const Task* after);
+
+    // Visits tasks by id from `from` onwards in the given direction
+    bool scanIds(int from, bool descending, const function<bool(const Task&)>& onTask) const;
+    // Visits tasks through an index, from `from` until the value leaves [low, high]
+    bool scanIndex(const TaskIndex& index, TaskIndex::Key from, long long low, long long high,
+                   bool descending, const function<bool(const Task&)>& onTask) const;
+
+public:
+    TaskSnapshot();
+
+    static shared_ptr<const TaskSnapshot> build(const vector<Task>& tasks, uint64_t version);
+
+    // Next version with one task inserted/replaced or removed
+    shared_ptr<const TaskSnapshot> withTask(const Task& task, uint64_t nextVersion) const;
+    shared_ptr<const TaskSnapshot> withoutTask(int id, uint64_t nextVersion) const;
+
+    uint64_t getVersion() const;
+    size_t size() const;
+
+    // Null when absent; valid for as long as the snapshot is held
+    const Task* find(int id) const;
+
+    // Visits tasks in id order until onTask returns false
+    void forEach(const function<bool(const Task&)>& onTask) const;
+    void forEachRevision(const function<bool(const Task&, uint64_t revision)>& onTask) const;
+
+    // Visits tasks in the query's sort order, starting after its cursor, until
+    // onTask returns false. Filters an index can answer narrow the walk; the
+    // caller still checks query.matches() on every task it is given.
+    void scan(const TaskQuery& query, const function<bool(const Task&)>& onTask) const;
+
+    // Matching tasks in order, after the offset and up to the limit
+    vector<Task> query(const TaskQuery& query) const;
+
+    // Number of matching tasks, ignoring sort and paging. A single status,
+    // priority or due-date filter is answered from its index; other filters
+    // (overdue, combinations, a cursor) fall back to an indexed scan.
+    size_t count(const TaskQuery& query) const;
+};
+
+#endif // TASKSNAPSHOT_HPP
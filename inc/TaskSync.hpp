@@ -0,0 +1,45 @@
+#ifndef TASKSYNC_HPP
+#define TASKSYNC_HPP
+
+#include "FileHandler.hpp"
+#include "SQLiteHandler.hpp"
+#include <cstdint>
+
+using namespace std;
+
+// Which side wins when a task changed in both stores since the last sync
+enum class SyncPreference {
+    SQLITE,
+    JSON
+};
+
+struct SyncReport {
+    int toSqlite = 0;           // Inserted or updated in SQLite
+    int toJson = 0;             // Inserted or updated in JSON
+    int deletedFromSqlite = 0;
+    int deletedFromJson = 0;
+    int conflicts = 0;
+    int unchanged = 0;
+};
+
+// Three-way sync between tasks.json and SQLite. The content hash of every
+// task as of the last sync is kept in SQLite; a side whose hash moved away
+// from it has been edited, so only those tasks are copied across.
+class TaskSync {
+private:
+    FileHandler& jsonStore;
+    SQLiteHandler& sqliteStore;
+    SyncPreference preference;
+
+public:
+    TaskSync(FileHandler& json, SQLiteHandler& sqlite,
+             SyncPreference prefer = SyncPreference::SQLITE);
+
+    // Aligns both stores; the JSON file is only rewritten if it changes
+    bool sync(SyncReport& report);
+
+    // Stable across runs and platforms (FNV-1a), unlike std::hash
+    static int64_t contentHash(const Task& task);
+};
+
+#endif // TASKSYNC_HPP
@@ -1,59 +1,260 @@
 #include <iostream>
-#include "../inc/TaskManager.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <sys/stat.h>
+#include "../inc/FileHandler.hpp"
 #include "../inc/SQLiteHandler.hpp"
+#include "../inc/ConfigHandler.hpp"
+#include "../inc/TaskSync.hpp"
 
 using namespace std;
 
-int main() {
+// Progress is stored in the settings table so an interrupted run resumes
+static const char* CHECKPOINT_SOURCE = "migrate_source";
+static const char* CHECKPOINT_ROWS = "migrate_rows_done";
+
+static void printUsage(const char* program) {
+    cout << "Usage: " << program << " [options]" << endl;
+    cout << "  --json PATH         Source JSON file (default ../data/tasks.json)" << endl;
+    cout << "  --db PATH           Target SQLite database (default ../data/tasks.db)" << endl;
+    cout << "  --batch-size N      Tasks per transaction (default 10000)" << endl;
+    cout << "  --restart           Ignore any saved checkpoint and start over" << endl;
+    cout << "  --no-bulk           Keep indexes live instead of rebuilding them at the end" << endl;
+    cout << "  --sync              Two-way incremental sync instead of a one-way migration" << endl;
+    cout << "  --prefer SIDE       Sync conflict winner: sqlite (default) or json" << endl;
+}
+
+// Identifies the source so a checkpoint is not applied to a different file
+static string sourceSignature(const string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return "";
+    }
+    return path + ":" + to_string(info.st_size) + ":" + to_string(info.st_mtime);
+}
+
+static double rowsPerSecond(long long rows, double seconds) {
+    return seconds > 0 ? rows / seconds : 0;
+}
+
+int main(int argc, char* argv[]) {
+    string jsonPath = "../data/tasks.json";
+    string dbPath = "../data/tasks.db";
+    int batchSize = 10000;
+    bool restart = false;
+    bool allowBulk = true;
+    bool syncMode = false;
+    SyncPreference preference = SyncPreference::SQLITE;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (arg == "--db" && i + 1 < argc) {
+            dbPath = argv[++i];
+        } else if (arg == "--batch-size" && i + 1 < argc) {
+            batchSize = atoi(argv[++i]);
+        } else if (arg == "--restart") {
+            restart = true;
+        } else if (arg == "--no-bulk") {
+            allowBulk = false;
+        } else if (arg == "--sync") {
+            syncMode = true;
+        } else if (arg == "--prefer" && i + 1 < argc && (string(argv[i + 1]) == "json" ||
+                                                          string(argv[i + 1]) == "sqlite")) {
+            preference = string(argv[++i]) == "json" ? SyncPreference::JSON : SyncPreference::SQLITE;
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (batchSize <= 0) {
+        cerr << "❌ Batch size must be positive" << endl;
+        return 1;
+    }
+
     cout << "========================================" << endl;
     cout << "  JSON to SQLite Migration Tool" << endl;
     cout << "========================================" << endl;
     cout << endl;
-    
-    // Load tasks from JSON
-    cout << "📂 Loading tasks from JSON..." << endl;
-    TaskManager manager;
-    auto& tasks = manager.getAllTasks();
-    int taskCount = tasks.size();
-    
-    cout << "✓ Found " << taskCount << " tasks in JSON file" << endl;
-    
-    if (taskCount == 0) {
-        cout << "\n⚠️  No tasks to migrate!" << endl;
+
+    FileHandler source(jsonPath);
+    string signature = sourceSignature(jsonPath);
+    if (signature.empty() && !syncMode) {
+        cout << "⚠️  No JSON file at " << jsonPath << " - nothing to migrate!" << endl;
         return 0;
     }
-    
+
     // Connect to SQLite
-    cout << "\n🔌 Connecting to SQLite database..." << endl;
-    SQLiteHandler db("../data/tasks.db");
-    
+    cout << "🔌 Connecting to SQLite database..." << endl;
+    SQLiteHandler db(dbPath);
+    ConfigHandler config;
+    db.setSynchronous(config.getSqliteSynchronous());
+
     if (!db.connect()) {
         cerr << "❌ Failed to connect to database!" << endl;
         return 1;
     }
-    
-    // Save to SQLite
-    cout << "💾 Migrating tasks to SQLite..." << endl;
-    
-    int migrated = 0;
-    for (const auto& task : tasks) {
-        if (db.insertTask(task) > 0) {
-            migrated++;
+
+    if (syncMode) {
+        cout << "🔄 Syncing " << jsonPath << " with " << dbPath << "..." << endl;
+        auto started = chrono::steady_clock::now();
+        TaskSync sync(source, db, preference);
+        SyncReport report;
+        if (!sync.sync(report)) {
+            cerr << "❌ Sync failed!" << endl;
+            return 1;
+        }
+
+        cout << "\n✅ Sync complete in "
+             << chrono::duration<double>(chrono::steady_clock::now() - started).count() << "s" << endl;
+        cout << "   JSON → SQLite: " << report.toSqlite << " updated, "
+             << report.deletedFromSqlite << " deleted" << endl;
+        cout << "   SQLite → JSON: " << report.toJson << " updated, "
+             << report.deletedFromJson << " deleted" << endl;
+        cout << "   Unchanged:     " << report.unchanged << endl;
+        if (report.conflicts > 0) {
+            cout << "   ⚠️  Conflicts:  " << report.conflicts << " (kept the "
+                 << (preference == SyncPreference::JSON ? "JSON" : "SQLite") << " version)" << endl;
+        }
+        return 0;
+    }
+
+    // Resume after the last committed batch of the same source file
+    long long alreadyDone = 0;
+    if (!restart && db.getSetting(CHECKPOINT_SOURCE) == signature) {
+        optional<string> done = db.getSetting(CHECKPOINT_ROWS);
+        alreadyDone = done ? atoll(done->c_str()) : 0;
+        if (alreadyDone > 0) {
+            cout << "↩️  Resuming after " << alreadyDone << " tasks already migrated" << endl;
+        }
+    }
+
+    // Loading into an empty table defers index and search maintenance to
+    // one rebuild at the end, which is several times faster than per row
+    bool bulk = db.isBulkLoadPending();
+    if (!bulk && allowBulk && db.countTasks(TaskQuery()) == 0) {
+        bulk = db.beginBulkLoad();
+    }
+
+    cout << "💾 Streaming tasks from " << jsonPath
+         << " in batches of " << batchSize << "..." << endl;
+
+    vector<Task> batch;
+    batch.reserve(batchSize);
+    long long seen = 0;
+    long long migrated = 0;
+    bool failed = false;
+
+    auto started = chrono::steady_clock::now();
+    auto elapsed = [&started]() {
+        return chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    };
+
+    // Each batch and its checkpoint commit together, so the checkpoint never
+    // runs ahead of the data
+    auto flushBatch = [&]() {
+        if (batch.empty()) {
+            return true;
+        }
+        if (!db.beginTransaction()) {
+            return false;
+        }
+        if (db.upsertTasks(batch) < 0 ||
+            !db.setSetting(CHECKPOINT_SOURCE, signature) ||
+            !db.setSetting(CHECKPOINT_ROWS, to_string(seen))) {
+            db.rollbackTransaction();
+            return false;
+        }
+        if (!db.commitTransaction()) {
+            return false;
+        }
+
+        long long previous = migrated;
+        migrated += batch.size();
+        batch.clear();
+
+        // Report roughly every million rows
+        if (migrated / 1000000 != previous / 1000000) {
+            cout << "   " << migrated << " tasks, "
+                 << static_cast<long long>(rowsPerSecond(migrated, elapsed())) << " rows/sec" << endl;
+        }
+        return true;
+    };
+
+    int nextId = 1;
+    source.streamTasks([&](const Task& task) {
+        seen++;
+        if (seen <= alreadyDone) {
+            return true;
+        }
+        batch.push_back(task);
+        if (static_cast<int>(batch.size()) >= batchSize && !flushBatch()) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }, nextId);
+
+    if (!failed && !flushBatch()) {
+        failed = true;
+    }
+
+    if (failed) {
+        cerr << "❌ Migration stopped after " << alreadyDone + migrated << " tasks." << endl;
+        cerr << "   Run the tool again to resume from the last committed batch." << endl;
+        return 1;
+    }
+
+    double seconds = elapsed();
+
+    if (bulk) {
+        cout << "🔎 Rebuilding indexes and search index..." << endl;
+        auto rebuildStarted = chrono::steady_clock::now();
+        if (!db.finishBulkLoad()) {
+            cerr << "❌ Index rebuild failed. Run the tool again to retry." << endl;
+            return 1;
         }
+        cout << "   Rebuilt in "
+             << chrono::duration<double>(chrono::steady_clock::now() - rebuildStarted).count()
+             << "s" << endl;
+    }
+
+    // Finished: record the next id and drop the checkpoint
+    optional<string> storedNextId = db.getSetting("next_id");
+    if (!storedNextId || atoi(storedNextId->c_str()) < nextId) {
+        db.setSetting("next_id", to_string(nextId));
+    }
+    db.deleteSetting(CHECKPOINT_SOURCE);
+    db.deleteSetting(CHECKPOINT_ROWS);
+
+    if (seen == 0) {
+        cout << "\n⚠️  No tasks to migrate!" << endl;
+        return 0;
     }
-    
+
     cout << "\n✅ Migration complete!" << endl;
-    cout << "   Migrated: " << migrated << "/" << taskCount << " tasks" << endl;
-    
+    cout << "   Migrated: " << migrated << " tasks in " << seconds << "s ("
+         << static_cast<long long>(rowsPerSecond(migrated, seconds)) << " rows/sec)" << endl;
+    double total = elapsed();
+    if (bulk) {
+        cout << "   Total with index rebuild: " << total << "s ("
+             << static_cast<long long>(rowsPerSecond(migrated, total)) << " rows/sec)" << endl;
+    }
+    if (alreadyDone > 0) {
+        cout << "   Skipped:  " << alreadyDone << " tasks from the previous run" << endl;
+    }
+
     // Verify
-    auto dbTasks = db.getAllTasks();
-    cout << "   Verified: " << dbTasks.size() << " tasks in database" << endl;
-    
+    cout << "   Verified: " << db.countTasks(TaskQuery()) << " tasks in database ("
+         << seen << " in JSON)" << endl;
+
     db.disconnect();
-    
+
     cout << "\n📊 You can now view tasks with:" << endl;
-    cout << "   sqlite3 ../data/tasks.db 'SELECT * FROM tasks;'" << endl;
+    cout << "   sqlite3 " << dbPath << " 'SELECT * FROM tasks;'" << endl;
     cout << endl;
-    
+
     return 0;
 }
@@ -0,0 +1,147 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include "../inc/DatabaseHandler.hpp"
+#include "../inc/DatabaseConnectionPool.hpp"
+
+using namespace std;
+
+// Compares row-at-a-time INSERTs with the binary COPY save/load paths, then
+// single-row latency, pipelined updates and pooled concurrent reads.
+// Uses the `tasks` table of the given database, which it overwrites.
+int main(int argc, char* argv[]) {
+    int rows = argc > 1 ? atoi(argv[1]) : 1000000;
+    string host = argc > 2 ? argv[2] : "localhost";
+    string port = argc > 3 ? argv[3] : "5432";
+    string dbname = argc > 4 ? argv[4] : "taskmanager";
+    string user = argc > 5 ? argv[5] : "postgres";
+
+    cout << "========================================" << endl;
+    cout << "  PostgreSQL Bulk Load Benchmark" << endl;
+    cout << "========================================" << endl;
+    cout << endl;
+
+    DatabaseHandler db(host, port, dbname, user);
+    if (!db.connect() || !db.createSchema()) {
+        cerr << "❌ Need a running PostgreSQL server (see scripts/setup_database.sh)" << endl;
+        return 1;
+    }
+
+    vector<Task> tasks;
+    tasks.reserve(rows);
+    for (int i = 1; i <= rows; i++) {
+        Task task(i, "Task " + to_string(i), "Benchmark description for task " + to_string(i),
+                  static_cast<Priority>(i % 3));
+        task.setStatus(static_cast<Status>(i % 3));
+        task.setDueDate(i % 2 == 0 ? 1800000000 + i : 0);
+        tasks.push_back(task);
+    }
+
+    auto timeIt = [](auto&& work) {
+        auto started = chrono::steady_clock::now();
+        bool ok = work();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        return ok ? seconds : -1.0;
+    };
+    auto report = [rows](const string& label, double seconds, int count) {
+        if (seconds < 0) {
+            cout << "   " << label << ": failed" << endl;
+            return;
+        }
+        cout << "   " << label << ": " << seconds << "s ("
+             << static_cast<long long>(count / seconds) << " rows/sec)";
+        if (count != rows) {
+            cout << " over " << count << " rows";
+        }
+        cout << endl;
+    };
+
+    // Row-at-a-time is too slow for the full set; time a sample
+    int sample = min(rows, 10000);
+    db.saveTasks({}, 1);
+    double perRow = timeIt([&]() {
+        for (int i = 0; i < sample; i++) {
+            if (db.insertTask(tasks[i]) < 0) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    double copyIn = timeIt([&]() { return db.saveTasks(tasks, rows + 1); });
+
+    vector<Task> loaded;
+    int nextId = 0;
+    double copyOut = timeIt([&]() { return db.loadTasks(loaded, nextId); });
+
+    cout << "📊 Results for " << rows << " tasks:" << endl;
+    report("INSERT per row", perRow, sample);
+    report("COPY save     ", copyIn, rows);
+    report("COPY load     ", copyOut, rows);
+    cout << "   Verified: " << loaded.size() << " tasks loaded, next id " << nextId << endl;
+
+    // Single-row latency with the prepared lookup
+    int lookups = 2000;
+    vector<double> latencies;
+    latencies.reserve(lookups);
+    for (int i = 0; i < lookups; i++) {
+        auto started = chrono::steady_clock::now();
+        db.getTaskById(1 + (i * 7919) % rows);
+        latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - started).count());
+    }
+    sort(latencies.begin(), latencies.end());
+    cout << "   getTaskById latency: p50 " << latencies[lookups / 2] << "us, p99 "
+         << latencies[lookups * 99 / 100] << "us" << endl;
+
+    // The same updates one round trip at a time, then pipelined
+    vector<Task> updates(tasks.begin(), tasks.begin() + sample);
+    for (auto& task : updates) {
+        task.setStatus(Status::COMPLETED);
+    }
+    double sequential = timeIt([&]() {
+        for (const auto& task : updates) {
+            if (!db.updateTask(task)) {
+                return false;
+            }
+        }
+        return true;
+    });
+    double pipelined = timeIt([&]() { return db.updateTasks(updates) == sample; });
+    report("UPDATE per row", sequential, sample);
+    report("UPDATE pipelined", pipelined, sample);
+
+    // Concurrent readers: one shared connection vs a pool
+    db.disconnect();
+    int threads = 8;
+    int perThread = 2000;
+    for (size_t poolSize : {static_cast<size_t>(1), static_cast<size_t>(4)}) {
+        DatabaseConnectionPool pool(poolSize, host, port, dbname, user);
+        if (!pool.open()) {
+            return 1;
+        }
+        atomic<int> done(0);
+        double seconds = timeIt([&]() {
+            vector<thread> workers;
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&, t]() {
+                    for (int i = 0; i < perThread; i++) {
+                        auto conn = pool.acquire();
+                        if (conn->getTaskById(1 + (t * perThread + i) % rows)) {
+                            done++;
+                        }
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            return true;
+        });
+        report(to_string(threads) + " threads, pool of " + to_string(poolSize), seconds, done);
+    }
+
+    return loaded.size() == tasks.size() ? 0 : 1;
+}
@@ -3,6 +3,10 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <cstdlib>
 
 ConfigHandler::ConfigHandler(const string& filePath) : configFilePath(filePath) {
     loadDefaults();
@@ -10,10 +14,33 @@ ConfigHandler::ConfigHandler(const string& filePath) : configFilePath(filePath)
 }
 
 void ConfigHandler::loadDefaults() {
-    settings["colors_enabled"] = "true";
-    settings["default_priority"] = "MEDIUM";
-    settings["auto_save"] = "true";
-    settings["default_view_count"] = "10";
+    defaults["colors_enabled"] = "true";
+    defaults["default_priority"] = "MEDIUM";
+    defaults["auto_save"] = "true";
+    defaults["default_view_count"] = "10";
+    defaults["sqlite_synchronous"] = "NORMAL";
+    defaults["sqlite_read_connections"] = "4";
+    defaults["storage_backend"] = "json";
+    defaults["cache_memory_mb"] = "64";
+    defaults["cache_write_policy"] = "write_through";
+    defaults["postgres_host"] = "localhost";
+    defaults["postgres_port"] = "5432";
+    defaults["postgres_dbname"] = "taskmanager";
+    defaults["postgres_user"] = "postgres";
+    defaults["postgres_password"] = "";
+    defaults["compress_min_bytes"] = "1024";
+    defaults["max_event_subscribers"] = "1024";
+    defaults["change_log_events"] = "4096";
+    defaults["host"] = "0.0.0.0";
+    defaults["port"] = "8080";
+    defaults["server_threads"] = "16";
+    defaults["max_in_flight"] = "256";
+    defaults["keep_alive_max_count"] = "100";
+    defaults["keep_alive_timeout_sec"] = "5";
+    defaults["read_timeout_sec"] = "5";
+    defaults["write_timeout_sec"] = "5";
+    defaults["tcp_nodelay"] = "true";
+    settings = defaults;
 }
 
 string ConfigHandler::trim(const string& str) const {
@@ -52,6 +79,30 @@ bool ConfigHandler::loadConfig() {
     return true;
 }
 
+// PORT (as set by hosts like Render) and TASK_API_<KEY> for the [Server]
+// keys, e.g. TASK_API_MAX_IN_FLIGHT=512
+void ConfigHandler::applyEnvironment() {
+    static const char* serverKeys[] = {
+        "compress_min_bytes", "max_event_subscribers", "change_log_events", "host", "port",
+        "server_threads", "max_in_flight", "keep_alive_max_count", "keep_alive_timeout_sec",
+        "read_timeout_sec", "write_timeout_sec", "tcp_nodelay"
+    };
+    for (const char* key : serverKeys) {
+        string name = "TASK_API_";
+        for (const char* c = key; *c; c++) {
+            name += static_cast<char>(toupper(static_cast<unsigned char>(*c)));
+        }
+        const char* value = getenv(name.c_str());
+        if (value && *value) {
+            settings[key] = value;
+        }
+    }
+    const char* port = getenv("PORT");
+    if (port && *port) {
+        settings["port"] = port;
+    }
+}
+
 bool ConfigHandler::saveConfig() {
     ofstream file(configFilePath);
     if (!file.is_open()) {
@@ -69,12 +120,53 @@ bool ConfigHandler::saveConfig() {
     file << "default_priority=" << settings["default_priority"] << "\n\n";
     
     file << "[System]\n";
-    file << "auto_save=" << settings["auto_save"] << "\n";
+    file << "auto_save=" << settings["auto_save"] << "\n\n";
+    
+    file << "[Database]\n";
+    file << "sqlite_synchronous=" << settings["sqlite_synchronous"] << "\n";
+    file << "sqlite_read_connections=" << settings["sqlite_read_connections"] << "\n";
+    file << "storage_backend=" << settings["storage_backend"] << "\n";
+    file << "cache_memory_mb=" << settings["cache_memory_mb"] << "\n";
+    file << "cache_write_policy=" << settings["cache_write_policy"] << "\n";
+    file << "postgres_host=" << settings["postgres_host"] << "\n";
+    file << "postgres_port=" << settings["postgres_port"] << "\n";
+    file << "postgres_dbname=" << settings["postgres_dbname"] << "\n";
+    file << "postgres_user=" << settings["postgres_user"] << "\n";
+    file << "postgres_password=" << settings["postgres_password"] << "\n\n";
+    
+    file << "[Server]\n";
+    file << "compress_min_bytes=" << settings["compress_min_bytes"] << "\n";
+    file << "max_event_subscribers=" << settings["max_event_subscribers"] << "\n";
+    file << "change_log_events=" << settings["change_log_events"] << "\n";
+    file << "host=" << settings["host"] << "\n";
+    file << "port=" << settings["port"] << "\n";
+    file << "server_threads=" << settings["server_threads"] << "\n";
+    file << "max_in_flight=" << settings["max_in_flight"] << "\n";
+    file << "keep_alive_max_count=" << settings["keep_alive_max_count"] << "\n";
+    file << "keep_alive_timeout_sec=" << settings["keep_alive_timeout_sec"] << "\n";
+    file << "read_timeout_sec=" << settings["read_timeout_sec"] << "\n";
+    file << "write_timeout_sec=" << settings["write_timeout_sec"] << "\n";
+    file << "tcp_nodelay=" << settings["tcp_nodelay"] << "\n";
     
     file.close();
     return true;
 }
 
+int ConfigHandler::getInt(const string& key, int minValue, int maxValue) const {
+    const string& text = settings.at(key);
+    int value = 0;
+    auto parsed = from_chars(text.data(), text.data() + text.size(), value);
+    if (parsed.ec == errc() && parsed.ptr == text.data() + text.size() &&
+        value >= minValue && value <= maxValue) {
+        return value;
+    }
+    
+    const string& fallback = defaults.at(key);
+    cerr << "⚠️  Invalid " << key << "=" << text << " (expected " << minValue << " to "
+         << maxValue << "); using " << fallback << endl;
+    return stoi(fallback);
+}
+
 bool ConfigHandler::getColorsEnabled() const {
     return settings.at("colors_enabled") == "true";
 }
@@ -91,7 +183,95 @@ bool ConfigHandler::getAutoSaveEnabled() const {
 }
 
 int ConfigHandler::getDefaultViewCount() const {
-    return stoi(settings.at("default_view_count"));
+    return getInt("default_view_count", 1, 100);
+}
+
+string ConfigHandler::getSqliteSynchronous() const {
+    return settings.at("sqlite_synchronous");
+}
+
+int ConfigHandler::getSqliteReadConnections() const {
+    return getInt("sqlite_read_connections", 1, 64);
+}
+
+string ConfigHandler::getStorageBackend() const {
+    return settings.at("storage_backend");
+}
+
+int ConfigHandler::getCacheMemoryMB() const {
+    return getInt("cache_memory_mb", 1, 1048576);
+}
+
+bool ConfigHandler::getCacheWriteBack() const {
+    return settings.at("cache_write_policy") == "write_back";
+}
+
+string ConfigHandler::getPostgresHost() const {
+    return settings.at("postgres_host");
+}
+
+string ConfigHandler::getPostgresPort() const {
+    return settings.at("postgres_port");
+}
+
+string ConfigHandler::getPostgresDatabase() const {
+    return settings.at("postgres_dbname");
+}
+
+string ConfigHandler::getPostgresUser() const {
+    return settings.at("postgres_user");
+}
+
+string ConfigHandler::getPostgresPassword() const {
+    return settings.at("postgres_password");
+}
+
+int ConfigHandler::getCompressMinBytes() const {
+    return getInt("compress_min_bytes", 1, INT_MAX);
+}
+
+int ConfigHandler::getMaxEventSubscribers() const {
+    return getInt("max_event_subscribers", 1, 65536);
+}
+
+int ConfigHandler::getChangeLogEvents() const {
+    return getInt("change_log_events", 1, 10000000);
+}
+
+string ConfigHandler::getHost() const {
+    return settings.at("host");
+}
+
+int ConfigHandler::getPort() const {
+    return getInt("port", 1, 65535);
+}
+
+int ConfigHandler::getServerThreads() const {
+    return getInt("server_threads", 1, 1024);
+}
+
+int ConfigHandler::getMaxInFlight() const {
+    return getInt("max_in_flight", 1, 1000000);
+}
+
+int ConfigHandler::getKeepAliveMaxCount() const {
+    return getInt("keep_alive_max_count", 1, INT_MAX);
+}
+
+int ConfigHandler::getKeepAliveTimeoutSec() const {
+    return getInt("keep_alive_timeout_sec", 1, 3600);
+}
+
+int ConfigHandler::getReadTimeoutSec() const {
+    return getInt("read_timeout_sec", 1, 3600);
+}
+
+int ConfigHandler::getWriteTimeoutSec() const {
+    return getInt("write_timeout_sec", 1, 3600);
+}
+
+bool ConfigHandler::getTcpNodelay() const {
+    return settings.at("tcp_nodelay") == "true";
 }
 
 void ConfigHandler::setColorsEnabled(bool enabled) {
@@ -139,5 +319,27 @@ void ConfigHandler::displaySettings() const {
         ColorUtils::colorize("✓ Enabled", ColorUtils::GREEN) : 
         ColorUtils::colorize("✗ Disabled", ColorUtils::RED)) << endl;
     
+    cout << "\n" << ColorUtils::BOLD << "Database Settings:" << ColorUtils::RESET << endl;
+    cout << "  SQLite Synchronous: " << getSqliteSynchronous() << endl;
+    cout << "  SQLite Readers:     " << getSqliteReadConnections() << endl;
+    cout << "  Storage Backend:    " << getStorageBackend() << endl;
+    cout << "  Cache Budget:       " << getCacheMemoryMB() << " MB ("
+         << settings.at("cache_write_policy") << ")" << endl;
+    cout << "  PostgreSQL:         " << getPostgresUser() << "@" << getPostgresHost() << ":"
+         << getPostgresPort() << "/" << getPostgresDatabase() << endl;
+    
+    cout << "\n" << ColorUtils::BOLD << "API Server Settings:" << ColorUtils::RESET << endl;
+    cout << "  Compress Over:      " << getCompressMinBytes() << " bytes" << endl;
+    cout << "  Event Subscribers:  " << getMaxEventSubscribers() << " max" << endl;
+    cout << "  Change Log:         " << getChangeLogEvents() << " events" << endl;
+    cout << "  Listen On:          " << getHost() << ":" << getPort() << endl;
+    cout << "  Worker Threads:     " << getServerThreads() << " ("
+         << getMaxInFlight() << " requests in flight max)" << endl;
+    cout << "  Keep-Alive:         " << getKeepAliveTimeoutSec() << " s, "
+         << getKeepAliveMaxCount() << " requests" << endl;
+    cout << "  Timeouts:           " << getReadTimeoutSec() << " s read, "
+         << getWriteTimeoutSec() << " s write" << endl;
+    cout << "  TCP_NODELAY:        " << (getTcpNodelay() ? "on" : "off") << endl;
+    
     cout << "\n" << ColorUtils::colorize("Config file: " + configFilePath, ColorUtils::DIM) << endl;
 }
@@ -0,0 +1,74 @@
+#include "DatabaseChangeListener.hpp"
+#include <chrono>
+#include <iostream>
+
+// How often the worker wakes to check for stop() while idle
+static const int WAIT_SLICE_MS = 250;
+
+DatabaseChangeListener::DatabaseChangeListener(const string& host, const string& port,
+                                               const string& dbname, const string& user,
+                                               const string& password)
+    : host(host), port(port), dbname(dbname), user(user), password(password),
+      ignoredBackend(0), running(false) {}
+
+DatabaseChangeListener::~DatabaseChangeListener() {
+    stop();
+}
+
+bool DatabaseChangeListener::openConnection() {
+    connection.reset(new DatabaseHandler(host, port, dbname, user, password));
+    connection->setNotificationFilter([this](int backendPid) {
+        return backendPid == ignoredBackend.load();
+    });
+    return connection->connect() && connection->listenForChanges();
+}
+
+void DatabaseChangeListener::setIgnoredBackend(int backendPid) {
+    ignoredBackend = backendPid;
+}
+
+bool DatabaseChangeListener::start(function<void(const vector<TaskChange>&)> onChanges) {
+    if (running) {
+        return true;
+    }
+    if (!openConnection()) {
+        connection.reset();
+        return false;
+    }
+
+    running = true;
+    worker = thread(&DatabaseChangeListener::run, this, onChanges);
+    return true;
+}
+
+void DatabaseChangeListener::run(function<void(const vector<TaskChange>&)> onChanges) {
+    while (running) {
+        if (!connection->isConnected()) {
+            // Writes made while disconnected were never announced, so the
+            // caller has to treat its cached state as stale
+            this_thread::sleep_for(chrono::seconds(1));
+            if (running && openConnection()) {
+                cerr << "Change feed reconnected" << endl;
+                onChanges({TaskChange()});
+            }
+            continue;
+        }
+
+        vector<TaskChange> changes = connection->waitForChanges(WAIT_SLICE_MS);
+        if (!changes.empty()) {
+            onChanges(changes);
+        }
+    }
+}
+
+void DatabaseChangeListener::stop() {
+    running = false;
+    if (worker.joinable()) {
+        worker.join();
+    }
+    connection.reset();
+}
+
+bool DatabaseChangeListener::isRunning() const {
+    return running;
+}
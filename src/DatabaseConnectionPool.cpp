@@ -0,0 +1,86 @@
+#include "DatabaseConnectionPool.hpp"
+#include <iostream>
+
+DatabaseConnectionPool::Lease::Lease(DatabaseConnectionPool* owner, DatabaseHandler* conn)
+    : pool(owner), handler(conn) {}
+
+DatabaseConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : pool(other.pool), handler(other.handler) {
+    other.pool = nullptr;
+    other.handler = nullptr;
+}
+
+DatabaseConnectionPool::Lease::~Lease() {
+    if (pool) {
+        pool->release(handler);
+    }
+}
+
+DatabaseConnectionPool::DatabaseConnectionPool(size_t size, const string& host, const string& port,
+                                               const string& dbname, const string& user,
+                                               const string& password)
+    : host(host), port(port), dbname(dbname), user(user), password(password),
+      connectionCount(size > 0 ? size : 1) {}
+
+DatabaseConnectionPool::~DatabaseConnectionPool() {
+    close();
+}
+
+bool DatabaseConnectionPool::open() {
+    if (!PQisthreadsafe()) {
+        cerr << "libpq was built without thread support; cannot pool connections" << endl;
+        return false;
+    }
+
+    vector<unique_ptr<DatabaseHandler>> opened;
+    for (size_t i = 0; i < connectionCount; i++) {
+        unique_ptr<DatabaseHandler> handler(new DatabaseHandler(host, port, dbname, user, password));
+        if (!handler->connect()) {
+            cerr << "Failed to open database connection " << i + 1 << endl;
+            return false;
+        }
+        opened.push_back(move(handler));
+    }
+
+    if (!opened.front()->createSchema()) {
+        return false;
+    }
+
+    lock_guard<mutex> lock(poolMutex);
+    for (auto& handler : opened) {
+        idleConnections.push_back(handler.get());
+        connections.push_back(move(handler));
+    }
+    return true;
+}
+
+void DatabaseConnectionPool::close() {
+    lock_guard<mutex> lock(poolMutex);
+    idleConnections.clear();
+    connections.clear();
+}
+
+bool DatabaseConnectionPool::isOpen() const {
+    return !connections.empty();
+}
+
+DatabaseConnectionPool::Lease DatabaseConnectionPool::acquire() {
+    unique_lock<mutex> lock(poolMutex);
+    connectionAvailable.wait(lock, [this] { return !idleConnections.empty(); });
+
+    DatabaseHandler* handler = idleConnections.back();
+    idleConnections.pop_back();
+    return Lease(this, handler);
+}
+
+void DatabaseConnectionPool::release(DatabaseHandler* handler) {
+    {
+        lock_guard<mutex> lock(poolMutex);
+        idleConnections.push_back(handler);
+    }
+    connectionAvailable.notify_one();
+}
+
+size_t DatabaseConnectionPool::size() const {
+    return connectionCount;
+}
@@ -1,7 +1,36 @@
 #include "DatabaseHandler.hpp"
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 #include <cstring>
+#include <cstdint>
+#include <unordered_map>
+#include <poll.h>
+
+// Binary COPY framing: signature, flags and header-extension length, then
+// per row a 16-bit field count and length-prefixed big-endian fields
+static const char COPY_SIGNATURE[11] = {'P', 'G', 'C', 'O', 'P', 'Y', '\n', '\377', '\r', '\n', '\0'};
+static const size_t COPY_HEADER_BYTES = sizeof(COPY_SIGNATURE) + 8;
+static const int COPY_FIELD_COUNT = 7;
+
+static void appendBigEndian(string& out, uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; i--) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+static uint64_t readBigEndian(const char* data, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value = (value << 8) | static_cast<unsigned char>(data[i]);
+    }
+    return value;
+}
+
+static void appendTextField(string& out, const string& text) {
+    appendBigEndian(out, text.size(), 4);
+    out += text;
+}
 
 DatabaseHandler::DatabaseHandler(const string& host, const string& port,
                                  const string& dbname, const string& user,
@@ -14,6 +43,7 @@ DatabaseHandler::DatabaseHandler(const string& host, const string& port,
     }
     connectionString = ss.str();
     conn = nullptr;
+    statementsPrepared = false;
 }
 
 DatabaseHandler::~DatabaseHandler() {
@@ -39,6 +69,7 @@ void DatabaseHandler::disconnect() {
         PQfinish(conn);
         conn = nullptr;
     }
+    statementsPrepared = false;
 }
 
 bool DatabaseHandler::isConnected() {
@@ -88,7 +119,35 @@ bool DatabaseHandler::createSchema() {
         );
     )";
     
-    return executeQuery(createTable);
+    // Every committed task write is announced on the task_changes channel.
+    // saveTasks() sets taskmanager.bulk_save and sends a single 'reload'.
+    string changeFeed = R"(
+        CREATE OR REPLACE FUNCTION notify_task_change() RETURNS trigger AS $$
+        BEGIN
+            IF current_setting('taskmanager.bulk_save', true) = 'on' THEN
+                RETURN NULL;
+            END IF;
+            IF TG_OP = 'TRUNCATE' THEN
+                PERFORM pg_notify('task_changes', 'reload');
+            ELSIF TG_OP = 'DELETE' THEN
+                PERFORM pg_notify('task_changes', 'delete:' || OLD.id);
+            ELSE
+                PERFORM pg_notify('task_changes', 'upsert:' || NEW.id);
+            END IF;
+            RETURN NULL;
+        END;
+        $$ LANGUAGE plpgsql;
+        
+        DROP TRIGGER IF EXISTS tasks_notify_row ON tasks;
+        CREATE TRIGGER tasks_notify_row AFTER INSERT OR UPDATE OR DELETE ON tasks
+            FOR EACH ROW EXECUTE FUNCTION notify_task_change();
+        
+        DROP TRIGGER IF EXISTS tasks_notify_truncate ON tasks;
+        CREATE TRIGGER tasks_notify_truncate AFTER TRUNCATE ON tasks
+            FOR EACH STATEMENT EXECUTE FUNCTION notify_task_change();
+    )";
+    
+    return executeQuery(createTable) && executeQuery(changeFeed);
 }
 
 bool DatabaseHandler::dropSchema() {
@@ -126,17 +185,95 @@ string DatabaseHandler::statusToString(Status status) {
     return "PENDING";
 }
 
+bool DatabaseHandler::prepareStatements() {
+    if (statementsPrepared) {
+        return true;
+    }
+
+    // Parsed and planned once per connection; later calls only send values
+    const char* statements[][2] = {
+        {"insert_task", "INSERT INTO tasks (title, description, priority, status, created_at, due_date) "
+                        "VALUES ($1, $2, $3, $4, $5, $6) RETURNING id;"},
+        {"update_task", "UPDATE tasks SET title=$2, description=$3, priority=$4, status=$5, due_date=$6 "
+                        "WHERE id=$1;"},
+        {"upsert_task", "INSERT INTO tasks (id, title, description, priority, status, created_at, due_date) "
+                        "VALUES ($1, $2, $3, $4, $5, $6, $7) ON CONFLICT (id) DO UPDATE SET "
+                        "title=EXCLUDED.title, description=EXCLUDED.description, "
+                        "priority=EXCLUDED.priority, status=EXCLUDED.status, "
+                        "created_at=EXCLUDED.created_at, due_date=EXCLUDED.due_date;"},
+        {"delete_task", "DELETE FROM tasks WHERE id=$1;"},
+        {"get_task", "SELECT id, title, description, priority, status, created_at, due_date "
+                     "FROM tasks WHERE id=$1;"}
+    };
+
+    for (const auto& statement : statements) {
+        PGresult* res = PQprepare(conn, statement[0], statement[1], 0, nullptr);
+        bool ok = PQresultStatus(res) == PGRES_COMMAND_OK;
+        if (!ok) {
+            cerr << "Prepare " << statement[0] << " failed: " << PQerrorMessage(conn) << endl;
+        }
+        PQclear(res);
+        if (!ok) {
+            return false;
+        }
+    }
+
+    statementsPrepared = true;
+    return true;
+}
+
+vector<string> DatabaseHandler::taskParams(const Task& task, bool withId) {
+    vector<string> params;
+    if (withId) {
+        params.push_back(to_string(task.getId()));
+    }
+    params.push_back(task.getTitle());
+    params.push_back(task.getDescription());
+    params.push_back(priorityToString(task.getPriority()));
+    params.push_back(statusToString(task.getStatus()));
+    if (!withId) {
+        params.push_back(to_string(task.getCreatedAt()));
+    }
+    params.push_back(to_string(task.getDueDate()));
+    return params;
+}
+
+PGresult* DatabaseHandler::executePrepared(const char* name, const vector<string>& params) {
+    if (!prepareStatements()) {
+        return nullptr;
+    }
+
+    vector<const char*> values;
+    for (const auto& param : params) {
+        values.push_back(param.c_str());
+    }
+
+    PGresult* res = PQexecPrepared(conn, name, static_cast<int>(values.size()), values.data(),
+                                   nullptr, nullptr, 0);
+    ExecStatusType status = PQresultStatus(res);
+    if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
+        cerr << "Query failed: " << PQerrorMessage(conn) << endl;
+        PQclear(res);
+        return nullptr;
+    }
+    return res;
+}
+
+Task DatabaseHandler::rowToTask(PGresult* res, int row) {
+    Task task(
+        atoi(PQgetvalue(res, row, 0)),  // id
+        PQgetvalue(res, row, 1),         // title
+        PQgetvalue(res, row, 2),         // description
+        parsePriority(PQgetvalue(res, row, 3))  // priority
+    );
+    task.setStatus(parseStatus(PQgetvalue(res, row, 4)));
+    task.setCreatedAt(atoll(PQgetvalue(res, row, 5)));
+    task.setDueDate(atoll(PQgetvalue(res, row, 6)));
+    return task;
+}
+
 int DatabaseHandler::insertTask(const Task& task) {
-    stringstream query;
-    query << "INSERT INTO tasks (title, description, priority, status, created_at, due_date) VALUES ('"
-          << task.getTitle() << "', '"
-          << task.getDescription() << "', '"
-          << priorityToString(task.getPriority()) << "', '"
-          << statusToString(task.getStatus()) << "', "
-          << task.getCreatedAt() << ", "
-          << task.getDueDate() << ") RETURNING id;";
-    
-    PGresult* res = executeSelect(query.str());
+    PGresult* res = executePrepared("insert_task", taskParams(task, false));
     if (!res) return -1;
     
     int id = atoi(PQgetvalue(res, 0, 0));
@@ -145,104 +282,492 @@ int DatabaseHandler::insertTask(const Task& task) {
 }
 
 bool DatabaseHandler::updateTask(const Task& task) {
-    stringstream query;
-    query << "UPDATE tasks SET "
-          << "title='" << task.getTitle() << "', "
-          << "description='" << task.getDescription() << "', "
-          << "priority='" << priorityToString(task.getPriority()) << "', "
-          << "status='" << statusToString(task.getStatus()) << "', "
-          << "due_date=" << task.getDueDate()
-          << " WHERE id=" << task.getId() << ";";
-    
-    return executeQuery(query.str());
+    PGresult* res = executePrepared("update_task", taskParams(task, true));
+    if (!res) return false;
+    PQclear(res);
+    return true;
 }
 
 bool DatabaseHandler::deleteTask(int id) {
-    stringstream query;
-    query << "DELETE FROM tasks WHERE id=" << id << ";";
-    return executeQuery(query.str());
+    PGresult* res = executePrepared("delete_task", {to_string(id)});
+    if (!res) return false;
+    PQclear(res);
+    return true;
 }
 
-Task* DatabaseHandler::getTaskById(int id) {
-    stringstream query;
-    query << "SELECT * FROM tasks WHERE id=" << id << ";";
-    
-    PGresult* res = executeSelect(query.str());
+optional<Task> DatabaseHandler::getTaskById(int id) {
+    PGresult* res = executePrepared("get_task", {to_string(id)});
     if (!res || PQntuples(res) == 0) {
         if (res) PQclear(res);
-        return nullptr;
+        return nullopt;
     }
     
-    Task* task = new Task(
-        atoi(PQgetvalue(res, 0, 0)),  // id
-        PQgetvalue(res, 0, 1),         // title
-        PQgetvalue(res, 0, 2),         // description
-        parsePriority(PQgetvalue(res, 0, 3))  // priority
-    );
-    
-    task->setStatus(parseStatus(PQgetvalue(res, 0, 4)));
-    task->setDueDate(atol(PQgetvalue(res, 0, 6)));
-    
+    Task task = rowToTask(res, 0);
     PQclear(res);
     return task;
 }
 
+int DatabaseHandler::runPipelined(const char* name, const vector<vector<string>>& paramSets,
+                                  const function<void(size_t, PGresult*)>& onResult) {
+    if (!prepareStatements()) {
+        return -1;
+    }
+
+    int succeeded = 0;
+#ifdef LIBPQ_HAS_PIPELINING
+    // Send a window of statements, then read their replies. Bounded windows
+    // keep both sides' socket buffers from filling while nobody reads.
+    if (PQenterPipelineMode(conn) != 1) {
+        cerr << "Pipeline mode failed: " << PQerrorMessage(conn) << endl;
+        return -1;
+    }
+
+    bool broken = false;
+    for (size_t start = 0; start < paramSets.size() && !broken; start += PIPELINE_WINDOW) {
+        size_t end = min(paramSets.size(), start + PIPELINE_WINDOW);
+        for (size_t i = start; i < end && !broken; i++) {
+            vector<const char*> values;
+            for (const auto& param : paramSets[i]) {
+                values.push_back(param.c_str());
+            }
+            if (PQsendQueryPrepared(conn, name, static_cast<int>(values.size()), values.data(),
+                                    nullptr, nullptr, 0) != 1) {
+                cerr << "Pipeline send failed: " << PQerrorMessage(conn) << endl;
+                broken = true;
+            }
+        }
+        if (broken || PQpipelineSync(conn) != 1) {
+            broken = true;
+            break;
+        }
+
+        // One result (then NULL) per statement, then the sync marker
+        for (size_t i = start; i < end && !broken; i++) {
+            PGresult* res = PQgetResult(conn);
+            if (!res) {
+                broken = true;
+                break;
+            }
+            ExecStatusType status = PQresultStatus(res);
+            if (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK) {
+                succeeded++;
+                if (onResult) {
+                    onResult(i, res);
+                }
+            } else if (status == PGRES_FATAL_ERROR) {
+                cerr << "Pipelined query failed: " << PQresultErrorMessage(res) << endl;
+            }
+            PQclear(res);
+            while ((res = PQgetResult(conn)) != nullptr) {
+                PQclear(res);
+            }
+        }
+        if (!broken) {
+            PGresult* sync = PQgetResult(conn);
+            if (PQresultStatus(sync) != PGRES_PIPELINE_SYNC) {
+                broken = true;
+            }
+            PQclear(sync);
+        }
+    }
+
+    if (PQexitPipelineMode(conn) != 1) {
+        cerr << "Pipeline exit failed: " << PQerrorMessage(conn) << endl;
+        broken = true;
+    }
+    return broken ? -1 : succeeded;
+#else
+    // libpq before 14: same statements, one round trip each
+    for (size_t i = 0; i < paramSets.size(); i++) {
+        PGresult* res = executePrepared(name, paramSets[i]);
+        if (res) {
+            succeeded++;
+            if (onResult) {
+                onResult(i, res);
+            }
+            PQclear(res);
+        }
+    }
+    return succeeded;
+#endif
+}
+
+vector<int> DatabaseHandler::insertTasks(const vector<Task>& tasks) {
+    vector<vector<string>> paramSets;
+    paramSets.reserve(tasks.size());
+    for (const auto& task : tasks) {
+        paramSets.push_back(taskParams(task, false));
+    }
+
+    vector<int> ids(tasks.size(), -1);
+    runPipelined("insert_task", paramSets, [&ids](size_t index, PGresult* res) {
+        ids[index] = atoi(PQgetvalue(res, 0, 0));
+    });
+    return ids;
+}
+
+int DatabaseHandler::updateTasks(const vector<Task>& tasks) {
+    vector<vector<string>> paramSets;
+    paramSets.reserve(tasks.size());
+    for (const auto& task : tasks) {
+        paramSets.push_back(taskParams(task, true));
+    }
+    return runPipelined("update_task", paramSets, nullptr);
+}
+
+int DatabaseHandler::deleteTasks(const vector<int>& ids) {
+    vector<vector<string>> paramSets;
+    paramSets.reserve(ids.size());
+    for (int id : ids) {
+        paramSets.push_back({to_string(id)});
+    }
+    return runPipelined("delete_task", paramSets, nullptr);
+}
+
 vector<Task> DatabaseHandler::getAllTasks() {
     vector<Task> tasks;
-    
-    PGresult* res = executeSelect("SELECT * FROM tasks ORDER BY id;");
-    if (!res) return tasks;
-    
-    int rows = PQntuples(res);
-    for (int i = 0; i < rows; i++) {
-        Task task(
-            atoi(PQgetvalue(res, i, 0)),
-            PQgetvalue(res, i, 1),
-            PQgetvalue(res, i, 2),
-            parsePriority(PQgetvalue(res, i, 3))
-        );
-        
-        task.setStatus(parseStatus(PQgetvalue(res, i, 4)));
-        task.setDueDate(atol(PQgetvalue(res, i, 6)));
-        
+    streamTasks([&tasks](const Task& task) {
         tasks.push_back(task);
-    }
-    
-    PQclear(res);
+        return true;
+    });
     return tasks;
 }
 
-bool DatabaseHandler::saveTasks(const vector<Task>& tasks, int nextId) {
-    // Clear existing tasks
-    executeQuery("DELETE FROM tasks;");
-    
-    // Insert all tasks
+bool DatabaseHandler::finishCommand(const char* context) {
+    // A COPY ends with its own command result; collect it and anything after
+    bool ok = true;
+    PGresult* res;
+    while ((res = PQgetResult(conn)) != nullptr) {
+        ExecStatusType status = PQresultStatus(res);
+        if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
+            cerr << context << " failed: " << PQerrorMessage(conn) << endl;
+            ok = false;
+        }
+        PQclear(res);
+    }
+    return ok;
+}
+
+bool DatabaseHandler::sendCopyChunk(string& buffer) {
+    if (PQputCopyData(conn, buffer.data(), static_cast<int>(buffer.size())) != 1) {
+        cerr << "COPY failed: " << PQerrorMessage(conn) << endl;
+        return false;
+    }
+    buffer.clear();
+    return true;
+}
+
+void DatabaseHandler::appendCopyRow(string& buffer, const Task& task) {
+    appendBigEndian(buffer, COPY_FIELD_COUNT, 2);
+    appendBigEndian(buffer, 4, 4);
+    appendBigEndian(buffer, static_cast<uint32_t>(task.getId()), 4);
+    appendTextField(buffer, task.getTitle());
+    appendTextField(buffer, task.getDescription());
+    appendTextField(buffer, priorityToString(task.getPriority()));
+    appendTextField(buffer, statusToString(task.getStatus()));
+    appendBigEndian(buffer, 8, 4);
+    appendBigEndian(buffer, static_cast<uint64_t>(task.getCreatedAt()), 8);
+    appendBigEndian(buffer, 8, 4);
+    appendBigEndian(buffer, static_cast<uint64_t>(task.getDueDate()), 8);
+}
+
+bool DatabaseHandler::copyTasksIn(const vector<Task>& tasks) {
+    PGresult* res = PQexec(conn, "COPY tasks (id, title, description, priority, status, created_at, due_date) "
+                                 "FROM STDIN (FORMAT binary);");
+    if (PQresultStatus(res) != PGRES_COPY_IN) {
+        cerr << "COPY failed: " << PQerrorMessage(conn) << endl;
+        PQclear(res);
+        return false;
+    }
+    PQclear(res);
+
+    string buffer;
+    buffer.reserve(COPY_CHUNK_BYTES + 1024);
+    buffer.append(COPY_SIGNATURE, sizeof(COPY_SIGNATURE));
+    appendBigEndian(buffer, 0, 4);  // Flags
+    appendBigEndian(buffer, 0, 4);  // Header extension length
+
+    bool ok = true;
     for (const auto& task : tasks) {
-        stringstream query;
-        query << "INSERT INTO tasks (id, title, description, priority, status, created_at, due_date) VALUES ("
-              << task.getId() << ", '"
-              << task.getTitle() << "', '"
-              << task.getDescription() << "', '"
-              << priorityToString(task.getPriority()) << "', '"
-              << statusToString(task.getStatus()) << "', "
-              << task.getCreatedAt() << ", "
-              << task.getDueDate() << ");";
-        
-        if (!executeQuery(query.str())) {
-            return false;
+        appendCopyRow(buffer, task);
+        if (buffer.size() >= COPY_CHUNK_BYTES && !sendCopyChunk(buffer)) {
+            ok = false;
+            break;
         }
     }
-    
-    // Update next ID
+
+    if (ok) {
+        appendBigEndian(buffer, static_cast<uint16_t>(-1), 2);  // Trailer
+        ok = sendCopyChunk(buffer);
+    }
+
+    // An error message makes the server abort the COPY and roll it back
+    if (PQputCopyEnd(conn, ok ? nullptr : "client aborted COPY") != 1) {
+        cerr << "COPY failed: " << PQerrorMessage(conn) << endl;
+        ok = false;
+    }
+    return finishCommand("COPY") && ok;
+}
+
+size_t DatabaseHandler::decodeCopyRow(const char* data, size_t length, Task& task) {
+    // Returns the bytes consumed, or 0 if the row is not complete yet
+    if (length < 2) {
+        return 0;
+    }
+    size_t offset = 2;
+
+    const char* fields[COPY_FIELD_COUNT];
+    int32_t sizes[COPY_FIELD_COUNT];
+    for (int i = 0; i < COPY_FIELD_COUNT; i++) {
+        if (length < offset + 4) {
+            return 0;
+        }
+        sizes[i] = static_cast<int32_t>(readBigEndian(data + offset, 4));
+        offset += 4;
+        fields[i] = data + offset;
+        if (sizes[i] > 0) {
+            if (length < offset + sizes[i]) {
+                return 0;
+            }
+            offset += sizes[i];
+        }
+    }
+
+    // NULL columns (size -1) read as empty text or zero
+    auto text = [&](int i) {
+        return sizes[i] > 0 ? string(fields[i], sizes[i]) : string();
+    };
+    auto number = [&](int i) {
+        return sizes[i] > 0 ? static_cast<int64_t>(readBigEndian(fields[i], sizes[i])) : 0;
+    };
+
+    task = Task(static_cast<int32_t>(number(0)), text(1), text(2), parsePriority(text(3)));
+    task.setStatus(parseStatus(text(4)));
+    task.setCreatedAt(number(5));
+    task.setDueDate(number(6));
+    return offset;
+}
+
+bool DatabaseHandler::streamTasks(const function<bool(const Task&)>& onTask) {
+    PGresult* res = PQexec(conn, "COPY (SELECT id, title, description, priority, status, created_at, due_date "
+                                 "FROM tasks ORDER BY id) TO STDOUT (FORMAT binary);");
+    if (PQresultStatus(res) != PGRES_COPY_OUT) {
+        cerr << "COPY failed: " << PQerrorMessage(conn) << endl;
+        PQclear(res);
+        return false;
+    }
+    PQclear(res);
+
+    // libpq hands over roughly one row per call; bytes of a row that is
+    // split across calls wait in `pending`
+    string pending;
+    bool headerRead = false;
+    bool finished = false;
+    bool wanted = true;
+    bool ok = true;
+    char* chunk;
+    int received;
+
+    while ((received = PQgetCopyData(conn, &chunk, 0)) > 0) {
+        pending.append(chunk, received);
+        PQfreemem(chunk);
+
+        size_t offset = 0;
+        if (!headerRead) {
+            if (pending.size() < COPY_HEADER_BYTES) {
+                continue;
+            }
+            if (memcmp(pending.data(), COPY_SIGNATURE, sizeof(COPY_SIGNATURE)) != 0) {
+                cerr << "COPY failed: unexpected binary header" << endl;
+                ok = false;
+                finished = true;
+            }
+            uint32_t extension = static_cast<uint32_t>(readBigEndian(pending.data() + sizeof(COPY_SIGNATURE) + 4, 4));
+            if (pending.size() < COPY_HEADER_BYTES + extension) {
+                continue;
+            }
+            offset = COPY_HEADER_BYTES + extension;
+            headerRead = true;
+        }
+
+        while (!finished && pending.size() - offset >= 2) {
+            if (static_cast<int16_t>(readBigEndian(pending.data() + offset, 2)) == -1) {
+                finished = true;
+                break;
+            }
+
+            Task task(0, "", "", Priority::MEDIUM);
+            size_t used = decodeCopyRow(pending.data() + offset, pending.size() - offset, task);
+            if (used == 0) {
+                break;
+            }
+            offset += used;
+
+            // The COPY still has to be drained after the caller stops
+            if (wanted) {
+                wanted = onTask(task);
+            }
+        }
+        pending.erase(0, offset);
+    }
+
+    if (received == -2) {
+        cerr << "COPY failed: " << PQerrorMessage(conn) << endl;
+        ok = false;
+    }
+    return finishCommand("COPY") && ok;
+}
+
+bool DatabaseHandler::saveTasks(const vector<Task>& tasks, int nextId) {
+    // One transaction: other sessions see the old list until COMMIT instead
+    // of a half-written table
+    if (!executeQuery("BEGIN;")) {
+        return false;
+    }
+
+    // TRUNCATE drops the old rows without per-row work or dead tuples.
+    // Listeners get one 'reload' at commit instead of a notification per row.
+    bool ok = executeQuery("SET LOCAL taskmanager.bulk_save = 'on';") &&
+              executeQuery("TRUNCATE tasks;") && copyTasksIn(tasks) &&
+              executeQuery("NOTIFY task_changes, 'reload';");
+
+    if (!ok || !storeNextId(nextId)) {
+        executeQuery("ROLLBACK;");
+        return false;
+    }
+    return executeQuery("COMMIT;");
+}
+
+bool DatabaseHandler::saveChanges(const vector<Task>& written, const vector<int>& deleted, int nextId) {
+    if (!executeQuery("BEGIN;")) {
+        return false;
+    }
+
+    vector<vector<string>> upserts;
+    upserts.reserve(written.size());
+    for (const auto& task : written) {
+        upserts.push_back({to_string(task.getId()), task.getTitle(), task.getDescription(),
+                           priorityToString(task.getPriority()), statusToString(task.getStatus()),
+                           to_string(task.getCreatedAt()), to_string(task.getDueDate())});
+    }
+    vector<vector<string>> deletes;
+    deletes.reserve(deleted.size());
+    for (int id : deleted) {
+        deletes.push_back({to_string(id)});
+    }
+
+    // A failed statement aborts the transaction, so counts tell it all
+    bool ok = runPipelined("upsert_task", upserts, nullptr) == static_cast<int>(upserts.size()) &&
+              runPipelined("delete_task", deletes, nullptr) == static_cast<int>(deletes.size()) &&
+              storeNextId(nextId);
+    if (!ok) {
+        executeQuery("ROLLBACK;");
+        return false;
+    }
+    return executeQuery("COMMIT;");
+}
+
+// Keeps the id sequence ahead of nextId so insertTask() cannot collide
+bool DatabaseHandler::storeNextId(int nextId) {
     stringstream query;
-    query << "INSERT INTO settings (key, value) VALUES ('next_id', '" << nextId 
+    query << "INSERT INTO settings (key, value) VALUES ('next_id', '" << nextId
           << "') ON CONFLICT (key) DO UPDATE SET value='" << nextId << "';";
-    
-    return executeQuery(query.str());
+    if (!executeQuery(query.str())) {
+        return false;
+    }
+
+    stringstream sequence;
+    sequence << "SELECT setval(pg_get_serial_sequence('tasks', 'id'), " << max(nextId, 1) << ", false);";
+    PGresult* res = executeSelect(sequence.str());
+    if (!res) {
+        return false;
+    }
+    PQclear(res);
+    return true;
+}
+
+bool DatabaseHandler::listenForChanges() {
+    return executeQuery("LISTEN task_changes;");
+}
+
+int DatabaseHandler::backendPid() {
+    return conn ? PQbackendPID(conn) : 0;
+}
+
+void DatabaseHandler::setNotificationFilter(function<bool(int backendPid)> ignore) {
+    ignoreBackend = move(ignore);
+}
+
+vector<TaskChange> DatabaseHandler::waitForChanges(int timeoutMs) {
+    vector<TaskChange> changes;
+    if (!isConnected()) {
+        return changes;
+    }
+
+    // Notifications may already be buffered from an earlier read
+    PGnotify* notify = PQnotifies(conn);
+    if (!notify) {
+        pollfd socketPoll = {PQsocket(conn), POLLIN, 0};
+        if (poll(&socketPoll, 1, timeoutMs) <= 0 || PQconsumeInput(conn) != 1) {
+            return changes;
+        }
+        notify = PQnotifies(conn);
+    }
+
+    // Collapse repeated writes to the same task; a reload supersedes all
+    vector<int> order;
+    unordered_map<int, TaskChange::Kind> latest;
+    bool reload = false;
+    for (; notify != nullptr; notify = PQnotifies(conn)) {
+        string payload = notify->extra;
+        bool ignored = ignoreBackend && ignoreBackend(notify->be_pid);
+        PQfreemem(notify);
+        if (ignored) {
+            continue;
+        }
+
+        size_t colon = payload.find(':');
+        if (payload == "reload") {
+            reload = true;
+        } else if (colon != string::npos) {
+            int id = atoi(payload.c_str() + colon + 1);
+            if (latest.find(id) == latest.end()) {
+                order.push_back(id);
+            }
+            latest[id] = payload.compare(0, colon, "delete") == 0 ? TaskChange::Kind::DELETE
+                                                                   : TaskChange::Kind::UPSERT;
+        }
+    }
+
+    if (reload) {
+        changes.push_back(TaskChange());
+        return changes;
+    }
+
+    for (int id : order) {
+        TaskChange change;
+        change.kind = latest[id];
+        change.id = id;
+        if (change.kind == TaskChange::Kind::UPSERT) {
+            // Read the committed row; it may have been deleted since
+            change.task = getTaskById(id);
+            if (!change.task) {
+                change.kind = TaskChange::Kind::DELETE;
+            }
+        }
+        changes.push_back(change);
+    }
+    return changes;
 }
 
 bool DatabaseHandler::loadTasks(vector<Task>& tasks, int& nextId) {
-    tasks = getAllTasks();
+    tasks.clear();
+    if (!streamTasks([&tasks](const Task& task) {
+            tasks.push_back(task);
+            return true;
+        })) {
+        return false;
+    }
     
     // Get next ID
     PGresult* res = executeSelect("SELECT value FROM settings WHERE key='next_id';");
@@ -250,6 +775,7 @@ bool DatabaseHandler::loadTasks(vector<Task>& tasks, int& nextId) {
         nextId = atoi(PQgetvalue(res, 0, 0));
         PQclear(res);
     } else {
+        if (res) PQclear(res);
         nextId = tasks.empty() ? 1 : tasks.back().getId() + 1;
     }
     
@@ -1,7 +1,10 @@
 #include "FileHandler.hpp"
 #include <iostream>
 #include <sstream>
-#include <algorithm>  // NEW - for remove()
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -34,9 +37,19 @@ string FileHandler::escapeJson(const string& str) const {
         switch (c) {
             case '"': result += "\\\""; break;
             case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
             case '\r': result += "\\r"; break;
             case '\t': result += "\\t"; break;
-            default: result += c; break;
+            default:
+                // Other control characters would break the one-field-per-line layout
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char code[7];
+                    snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned>(c));
+                    result += code;
+                } else {
+                    result += c;
+                }
+                break;
         }
     }
     return result;
@@ -52,6 +65,17 @@ string FileHandler::unescapeJson(const string& str) const {
                 case 'n': result += '\n'; i++; break;
                 case 'r': result += '\r'; i++; break;
                 case 't': result += '\t'; i++; break;
+                case 'u':
+                    // Only \u00XX is written (see escapeJson)
+                    if (i + 5 < str.length() && str.compare(i + 2, 2, "00") == 0 &&
+                        isxdigit(static_cast<unsigned char>(str[i + 4])) &&
+                        isxdigit(static_cast<unsigned char>(str[i + 5]))) {
+                        result += static_cast<char>(stoi(str.substr(i + 4, 2), nullptr, 16));
+                        i += 5;
+                    } else {
+                        result += str[i];
+                    }
+                    break;
                 default: result += str[i]; break;
             }
         } else {
@@ -127,13 +151,20 @@ bool FileHandler::saveTasks(const vector<Task>& tasks, int nextId) {
 }
 
 bool FileHandler::loadTasks(vector<Task>& tasks, int& nextId) {
+    tasks.clear();
+    return streamTasks([&tasks](const Task& task) {
+        tasks.push_back(task);
+        return true;
+    }, nextId);
+}
+
+bool FileHandler::streamTasks(const function<bool(const Task&)>& onTask, int& nextId) {
     ifstream file(dataFilePath);
     if (!file.is_open()) {
         // File doesn't exist yet - first run
         return true;
     }
 
-    tasks.clear();
     string line;
     
     // Simple JSON parsing (manual for learning purposes)
@@ -144,85 +175,85 @@ bool FileHandler::loadTasks(vector<Task>& tasks, int& nextId) {
     time_t createdAt = 0, dueDate = 0;
     
     bool inTask = false;
+
+    // Text between the first quote after the colon and the last quote
+    auto quotedValue = [&line](size_t colon, string& out) {
+        size_t start = line.find('"', colon + 1);
+        size_t end = line.find_last_of('"');
+        if (start == string::npos || end == string::npos || start >= end) {
+            return false;
+        }
+        out.assign(line, start + 1, end - start - 1);
+        return true;
+    };
+    // strtoll stops at the trailing comma, so no copy is needed
+    auto numberValue = [&line](size_t colon) {
+        return strtoll(line.c_str() + colon + 1, nullptr, 10);
+    };
     
+    string value;
     while (getline(file, line)) {
-        // Remove leading/trailing whitespace
-        size_t start = line.find_first_not_of(" \t\r\n");
-        size_t end = line.find_last_not_of(" \t\r\n");
-        if (start != string::npos) {
-            line = line.substr(start, end - start + 1);
+        // Each field is on its own line: "key": value
+        size_t keyStart = line.find('"');
+        if (keyStart == string::npos) {
+            continue;
         }
-        
-        // Parse nextId
-        if (line.find("\"nextId\":") != string::npos) {
-            size_t pos = line.find(":");
-            if (pos != string::npos) {
-                string value = line.substr(pos + 1);
-                value.erase(remove(value.begin(), value.end(), ','), value.end());
-                nextId = stoi(value);
-            }
+        size_t keyEnd = line.find('"', keyStart + 1);
+        size_t colon = keyEnd == string::npos ? string::npos : line.find(':', keyEnd);
+        if (colon == string::npos) {
+            continue;
         }
+        const char* key = line.c_str() + keyStart + 1;
+        size_t keyLength = keyEnd - keyStart - 1;
+        auto keyIs = [key, keyLength](const char* name) {
+            return strlen(name) == keyLength && strncmp(key, name, keyLength) == 0;
+        };
         
-        // Parse task fields
-        if (line.find("\"id\":") != string::npos) {
-            size_t pos = line.find(":");
-            if (pos != string::npos) {
-                string value = line.substr(pos + 1);
-                value.erase(remove(value.begin(), value.end(), ','), value.end());
-                id = stoi(value);
-                inTask = true;
-            }
+        if (keyIs("nextId")) {
+            nextId = static_cast<int>(numberValue(colon));
         }
-        else if (line.find("\"title\":") != string::npos) {
-            size_t start = line.find("\"", line.find(":") + 1);
-            size_t end = line.find_last_of("\"");
-            if (start != string::npos && end != string::npos && start < end) {
-                title = unescapeJson(line.substr(start + 1, end - start - 1));
-            }
+        else if (keyIs("id")) {
+            id = static_cast<int>(numberValue(colon));
+            inTask = true;
         }
-        else if (line.find("\"description\":") != string::npos) {
-            size_t start = line.find("\"", line.find(":") + 1);
-            size_t end = line.find_last_of("\"");
-            if (start != string::npos && end != string::npos && start < end) {
-                description = unescapeJson(line.substr(start + 1, end - start - 1));
+        else if (keyIs("title")) {
+            if (quotedValue(colon, value)) {
+                title = unescapeJson(value);
             }
         }
-        else if (line.find("\"priority\":") != string::npos) {
-            size_t start = line.find("\"", line.find(":") + 1);
-            size_t end = line.find_last_of("\"");
-            if (start != string::npos && end != string::npos && start < end) {
-                priority = stringToPriority(line.substr(start + 1, end - start - 1));
+        else if (keyIs("description")) {
+            if (quotedValue(colon, value)) {
+                description = unescapeJson(value);
             }
         }
-        else if (line.find("\"status\":") != string::npos) {
-            size_t start = line.find("\"", line.find(":") + 1);
-            size_t end = line.find_last_of("\"");
-            if (start != string::npos && end != string::npos && start < end) {
-                status = stringToStatus(line.substr(start + 1, end - start - 1));
+        else if (keyIs("priority")) {
+            if (quotedValue(colon, value)) {
+                priority = stringToPriority(value);
             }
         }
-        else if (line.find("\"createdAt\":") != string::npos) {
-            size_t pos = line.find(":");
-            if (pos != string::npos) {
-                string value = line.substr(pos + 1);
-                value.erase(remove(value.begin(), value.end(), ','), value.end());
-                createdAt = stoll(value);
+        else if (keyIs("status")) {
+            if (quotedValue(colon, value)) {
+                status = stringToStatus(value);
             }
         }
-        else if (line.find("\"dueDate\":") != string::npos) {
-            size_t pos = line.find(":");
-            if (pos != string::npos) {
-                string value = line.substr(pos + 1);
-                value.erase(remove(value.begin(), value.end(), ','), value.end());
-                dueDate = stoll(value);
-                
-                // End of task object - create task
-                if (inTask) {
-                    Task task(id, title, description, priority);
-                    task.setStatus(status);
-                    task.setDueDate(dueDate);
-                    tasks.push_back(task);
-                    inTask = false;
+        else if (keyIs("createdAt")) {
+            createdAt = numberValue(colon);
+        }
+        else if (keyIs("dueDate")) {
+            dueDate = numberValue(colon);
+            
+            // End of task object - create task
+            if (inTask) {
+                Task task(id, title, description, priority);
+                task.setStatus(status);
+                if (createdAt > 0) {
+                    task.setCreatedAt(createdAt);
+                }
+                task.setDueDate(dueDate);
+                inTask = false;
+                createdAt = 0;
+                if (!onTask(task)) {
+                    break;
                 }
             }
         }
@@ -0,0 +1,300 @@
+#include "JsonReader.hpp"
+#include <cstdint>
+#include <cstring>
+
+JsonReader::JsonReader(string_view json, JsonHandler& handler)
+    : input(json), pos(0), handler(handler) {}
+
+bool JsonReader::parse(string_view json, JsonHandler& handler, string& error) {
+    JsonReader reader(json, handler);
+    reader.skipWhitespace();
+    if (!reader.parseValue(0)) {
+        error = reader.error;
+        return false;
+    }
+    reader.skipWhitespace();
+    if (reader.pos != json.size()) {
+        reader.fail("unexpected data after the value");
+        error = reader.error;
+        return false;
+    }
+    return true;
+}
+
+bool JsonReader::fail(const string& message) {
+    if (error.empty()) {
+        error = message + " at byte " + to_string(pos);
+    }
+    return false;
+}
+
+void JsonReader::skipWhitespace() {
+    while (pos < input.size() &&
+           (input[pos] == ' ' || input[pos] == '\t' || input[pos] == '\n' || input[pos] == '\r')) {
+        pos++;
+    }
+}
+
+bool JsonReader::parseValue(int depth) {
+    if (pos >= input.size()) {
+        return fail("unexpected end of input");
+    }
+
+    switch (input[pos]) {
+        case '{':
+            return parseObject(depth + 1);
+        case '[':
+            return parseArray(depth + 1);
+        case '"': {
+            string_view value;
+            if (!parseString(value)) return false;
+            return handler.stringValue(value) || fail(handler.stopReason());
+        }
+        case 't':
+            return parseLiteral("true", 4) && (handler.boolValue(true) || fail(handler.stopReason()));
+        case 'f':
+            return parseLiteral("false", 5) && (handler.boolValue(false) || fail(handler.stopReason()));
+        case 'n':
+            return parseLiteral("null", 4) && (handler.nullValue() || fail(handler.stopReason()));
+        default:
+            return parseNumber();
+    }
+}
+
+bool JsonReader::parseObject(int depth) {
+    if (depth > MAX_DEPTH) {
+        return fail("nesting too deep");
+    }
+    if (!handler.startObject()) {
+        return fail(handler.stopReason());
+    }
+    pos++;      // '{'
+
+    skipWhitespace();
+    if (pos < input.size() && input[pos] == '}') {
+        pos++;
+        return handler.endObject() || fail(handler.stopReason());
+    }
+    while (true) {
+        skipWhitespace();
+        if (pos >= input.size() || input[pos] != '"') {
+            return fail("expected a member name");
+        }
+        string_view name;
+        if (!parseString(name)) return false;
+        if (!handler.key(name)) {
+            return fail(handler.stopReason());
+        }
+
+        skipWhitespace();
+        if (pos >= input.size() || input[pos] != ':') {
+            return fail("expected a colon");
+        }
+        pos++;
+        skipWhitespace();
+        if (!parseValue(depth)) return false;
+
+        skipWhitespace();
+        if (pos < input.size() && input[pos] == ',') {
+            pos++;
+            continue;
+        }
+        if (pos < input.size() && input[pos] == '}') {
+            pos++;
+            return handler.endObject() || fail(handler.stopReason());
+        }
+        return fail("expected a comma or closing brace");
+    }
+}
+
+bool JsonReader::parseArray(int depth) {
+    if (depth > MAX_DEPTH) {
+        return fail("nesting too deep");
+    }
+    if (!handler.startArray()) {
+        return fail(handler.stopReason());
+    }
+    pos++;      // '['
+
+    skipWhitespace();
+    if (pos < input.size() && input[pos] == ']') {
+        pos++;
+        return handler.endArray() || fail(handler.stopReason());
+    }
+    while (true) {
+        skipWhitespace();
+        if (!parseValue(depth)) return false;
+
+        skipWhitespace();
+        if (pos < input.size() && input[pos] == ',') {
+            pos++;
+            continue;
+        }
+        if (pos < input.size() && input[pos] == ']') {
+            pos++;
+            return handler.endArray() || fail(handler.stopReason());
+        }
+        return fail("expected a comma or closing bracket");
+    }
+}
+
+// Index of the first byte from `from` that ends a run of plain string
+// text: a quote, a backslash, a control character or the end of input.
+// Eight bytes are checked at a time until one of them might.
+size_t JsonReader::plainRunEnd(size_t from) const {
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    while (from + 8 <= input.size()) {
+        uint64_t word;
+        memcpy(&word, input.data() + from, 8);
+        uint64_t quotes = word ^ (ones * '"');
+        uint64_t slashes = word ^ (ones * '\\');
+        uint64_t hits = ((quotes - ones) & ~quotes) | ((slashes - ones) & ~slashes) |
+                        ((word - ones * 0x20) & ~word);
+        if (hits & highs) break;
+        from += 8;
+    }
+    while (from < input.size()) {
+        unsigned char c = input[from];
+        if (c == '"' || c == '\\' || c < 0x20) break;
+        from++;
+    }
+    return from;
+}
+
+// Strings without escapes are passed as a view of the input; only escaped
+// ones are decoded, into scratch
+bool JsonReader::parseString(string_view& out) {
+    size_t start = ++pos;   // Past the opening quote
+    pos = plainRunEnd(pos);
+    if (pos < input.size() && input[pos] == '"') {
+        out = input.substr(start, pos - start);
+        pos++;
+        return true;
+    }
+
+    scratch.assign(input.data() + start, pos - start);
+    while (pos < input.size() && input[pos] == '\\') {
+        if (++pos >= input.size()) break;
+        switch (input[pos++]) {
+            case '"': scratch += '"'; break;
+            case '\\': scratch += '\\'; break;
+            case '/': scratch += '/'; break;
+            case 'b': scratch += '\b'; break;
+            case 'f': scratch += '\f'; break;
+            case 'n': scratch += '\n'; break;
+            case 'r': scratch += '\r'; break;
+            case 't': scratch += '\t'; break;
+            case 'u': {
+                unsigned code = 0;
+                if (!parseHex4(code)) return false;
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    // High surrogate; must be followed by a low one
+                    unsigned low = 0;
+                    if (pos + 1 >= input.size() || input[pos] != '\\' || input[pos + 1] != 'u') {
+                        return fail("unpaired surrogate");
+                    }
+                    pos += 2;
+                    if (!parseHex4(low)) return false;
+                    if (low < 0xDC00 || low > 0xDFFF) {
+                        return fail("unpaired surrogate");
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                } else if (code >= 0xDC00 && code <= 0xDFFF) {
+                    return fail("unpaired surrogate");
+                }
+                appendUtf8(scratch, code);
+                break;
+            }
+            default:
+                pos--;
+                return fail("invalid escape");
+        }
+
+        size_t end = plainRunEnd(pos);
+        scratch.append(input.data() + pos, end - pos);
+        pos = end;
+    }
+    if (pos >= input.size()) {
+        return fail("unterminated string");
+    }
+    if (input[pos] != '"') {
+        return fail("control character in string");
+    }
+    pos++;
+    out = scratch;
+    return true;
+}
+
+bool JsonReader::parseHex4(unsigned& code) {
+    if (pos + 4 > input.size()) {
+        return fail("truncated unicode escape");
+    }
+    code = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = input[pos++];
+        code <<= 4;
+        if (c >= '0' && c <= '9') code |= c - '0';
+        else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+        else {
+            pos--;
+            return fail("invalid unicode escape");
+        }
+    }
+    return true;
+}
+
+void JsonReader::appendUtf8(string& out, unsigned code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+// -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+bool JsonReader::parseNumber() {
+    size_t start = pos;
+    auto digits = [this]() {
+        size_t first = pos;
+        while (pos < input.size() && input[pos] >= '0' && input[pos] <= '9') pos++;
+        return pos > first;
+    };
+
+    if (pos < input.size() && input[pos] == '-') pos++;
+    if (pos < input.size() && input[pos] == '0') {
+        pos++;
+    } else if (!digits()) {
+        pos = start;
+        return fail("unexpected character");
+    }
+    if (pos < input.size() && input[pos] == '.') {
+        pos++;
+        if (!digits()) return fail("expected digits after the decimal point");
+    }
+    if (pos < input.size() && (input[pos] == 'e' || input[pos] == 'E')) {
+        pos++;
+        if (pos < input.size() && (input[pos] == '+' || input[pos] == '-')) pos++;
+        if (!digits()) return fail("expected digits in the exponent");
+    }
+    return handler.numberValue(input.substr(start, pos - start)) || fail(handler.stopReason());
+}
+
+bool JsonReader::parseLiteral(const char* word, size_t length) {
+    if (input.compare(pos, length, word) != 0) {
+        return fail("unexpected character");
+    }
+    pos += length;
+    return true;
+}
@@ -0,0 +1,62 @@
+#include "PostgresTaskStore.hpp"
+#include <iostream>
+
+PostgresTaskStore::PostgresTaskStore(const string& host, const string& port,
+                                     const string& dbname, const string& user,
+                                     const string& password)
+    : writer(host, port, dbname, user, password),
+      listener(host, port, dbname, user, password) {}
+
+PostgresTaskStore::~PostgresTaskStore() {
+    stop();
+}
+
+bool PostgresTaskStore::open() {
+    return writer.connect() && writer.createSchema();
+}
+
+bool PostgresTaskStore::ensureConnected() {
+    if (writer.isConnected()) {
+        return true;
+    }
+    // Prepared statements went with the old session, and the listener has
+    // to skip the new session's writes instead
+    writer.disconnect();
+    if (!writer.connect()) {
+        return false;
+    }
+    listener.setIgnoredBackend(writer.backendPid());
+    return true;
+}
+
+TaskManager::ExternalStore PostgresTaskStore::binding() {
+    TaskManager::ExternalStore store;
+    store.load = [this](vector<Task>& tasks, int& nextId) {
+        return ensureConnected() && writer.loadTasks(tasks, nextId);
+    };
+    // Row by row even for bulk operations: TRUNCATE and COPY would also
+    // erase rows other writers committed that have not reached us yet
+    store.save = [this](const vector<Task>& written, const vector<int>& deleted, int nextId) {
+        return ensureConnected() && writer.saveChanges(written, deleted, nextId);
+    };
+    return store;
+}
+
+bool PostgresTaskStore::startListening(TaskManager& manager) {
+    // Our own writes are already in the manager; echoing them back would
+    // publish every saved task a second time
+    listener.setIgnoredBackend(writer.backendPid());
+    return listener.start([&manager](const vector<TaskChange>& changes) {
+        for (const auto& change : changes) {
+            if (!manager.applyChange(change)) {
+                cout << "🔄 Reloading tasks from PostgreSQL" << endl;
+                manager.loadFromFile();
+                return;
+            }
+        }
+    });
+}
+
+void PostgresTaskStore::stop() {
+    listener.stop();
+}
@@ -0,0 +1,205 @@
+#include "RequestQueue.hpp"
+#include <algorithm>
+#include <cmath>
+
+// The job running on this thread, for shedding() and markLongLived()
+struct CurrentJob {
+    RequestQueue* queue = nullptr;
+    bool overflow = false;
+    bool longLived = false;
+};
+static thread_local CurrentJob currentJob;
+
+RequestQueue::RequestQueue(size_t workerCount, size_t inFlightLimit, size_t longLived)
+    : workers(max<size_t>(workerCount, 1)), maxInFlight(max(inFlightLimit, workers)),
+      maxLongLived(longLived), running(0), workerThreads(0), stopping(false),
+      totalQueueWaitMicros(0), waitBuckets() {
+    lock_guard<mutex> lock(queueMutex);
+    for (size_t i = 0; i < workers; i++) {
+        startWorker();
+    }
+    for (size_t i = 0; i < OVERFLOW_THREADS; i++) {
+        threads.emplace_back(&RequestQueue::workOverflow, this);
+    }
+}
+
+void RequestQueue::startWorker() {
+    joinExited();
+    threads.emplace_back(&RequestQueue::work, this);
+    workerThreads++;
+}
+
+// An exited thread has released queueMutex for good, so joining it while
+// holding the lock cannot block on us
+void RequestQueue::joinExited() {
+    for (thread::id id : exited) {
+        auto it = find_if(threads.begin(), threads.end(),
+                          [id](const thread& worker) { return worker.get_id() == id; });
+        if (it != threads.end()) {
+            it->join();
+            threads.erase(it);
+        }
+    }
+    exited.clear();
+}
+
+RequestQueue::~RequestQueue() {
+    shutdown();
+}
+
+bool RequestQueue::enqueue(function<void()> run) {
+    Job job{move(run), chrono::steady_clock::now()};
+    bool admitted = false;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        if (stopping) {
+            return false;
+        }
+        if (jobs.size() + running < maxInFlight) {
+            jobs.push_back(move(job));
+            admitted = true;
+            stats.admitted++;
+            stats.maxQueued = max<uint64_t>(stats.maxQueued, jobs.size());
+        } else if (overflowJobs.size() < OVERFLOW_QUEUE) {
+            overflowJobs.push_back(move(job));
+            stats.shed++;
+        } else {
+            stats.refused++;
+            return false;
+        }
+    }
+    (admitted ? workReady : overflowReady).notify_one();
+    return true;
+}
+
+void RequestQueue::work() {
+    while (true) {
+        Job job;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            workReady.wait(lock, [this]() {
+                return (!jobs.empty() && running < workers) || (stopping && jobs.empty());
+            });
+            if (jobs.empty()) {
+                return;
+            }
+            job = move(jobs.front());
+            jobs.pop_front();
+            running++;
+            recordWait(chrono::duration<double, micro>(chrono::steady_clock::now() - job.queuedAt).count());
+        }
+
+        currentJob = CurrentJob{this, false, false};
+        job.run();
+        bool longLived = currentJob.longLived;
+        currentJob = CurrentJob();
+
+        // A long-lived job gave its worker slot back when it was marked. If a
+        // replacement was started meanwhile, one thread too many is left.
+        {
+            lock_guard<mutex> lock(queueMutex);
+            if (longLived) {
+                stats.longLived--;
+                if (workerThreads - stats.longLived > workers) {
+                    workerThreads--;
+                    exited.push_back(this_thread::get_id());
+                    return;
+                }
+            } else {
+                running--;
+            }
+        }
+        if (!longLived) {
+            workReady.notify_one();
+        }
+    }
+}
+
+void RequestQueue::workOverflow() {
+    while (true) {
+        Job job;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            overflowReady.wait(lock, [this]() { return !overflowJobs.empty() || stopping; });
+            if (overflowJobs.empty()) {
+                return;
+            }
+            job = move(overflowJobs.front());
+            overflowJobs.pop_front();
+        }
+
+        currentJob = CurrentJob{this, true, false};
+        job.run();
+        currentJob = CurrentJob();
+    }
+}
+
+void RequestQueue::recordWait(double micros) {
+    totalQueueWaitMicros += micros;
+    stats.maxQueueWaitMicros = max(stats.maxQueueWaitMicros, micros);
+    size_t bucket = micros < 2 ? 0 : static_cast<size_t>(log2(micros));
+    waitBuckets[min(bucket, WAIT_BUCKETS - 1)]++;
+}
+
+void RequestQueue::shutdown() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    workReady.notify_all();
+    overflowReady.notify_all();
+    for (auto& worker : threads) {
+        if (worker.joinable() && worker.get_id() != this_thread::get_id()) {
+            worker.join();
+        }
+    }
+}
+
+bool RequestQueue::shedding() {
+    return currentJob.queue && currentJob.overflow;
+}
+
+void RequestQueue::markLongLived() {
+    RequestQueue* queue = currentJob.queue;
+    if (!queue || currentJob.overflow || currentJob.longLived) {
+        return;
+    }
+    currentJob.longLived = true;
+    {
+        lock_guard<mutex> lock(queue->queueMutex);
+        queue->running--;
+        queue->stats.longLived++;
+        // Keep `workers` threads free for ordinary jobs
+        size_t free = queue->workerThreads - queue->stats.longLived;
+        if (free < queue->workers && !queue->stopping &&
+            queue->workerThreads < queue->workers + queue->maxLongLived) {
+            queue->startWorker();
+        }
+    }
+    queue->workReady.notify_one();
+}
+
+RequestQueue::Stats RequestQueue::getStats() const {
+    lock_guard<mutex> lock(queueMutex);
+    Stats current = stats;
+    current.running = running;
+    current.queued = jobs.size();
+    current.threads = workerThreads;
+
+    uint64_t started = 0;
+    for (uint64_t count : waitBuckets) {
+        started += count;
+    }
+    if (started > 0) {
+        current.avgQueueWaitMicros = totalQueueWaitMicros / started;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < WAIT_BUCKETS; i++) {
+            seen += waitBuckets[i];
+            if (seen * 100 >= started * 99) {
+                current.p99QueueWaitMicros = ldexp(1.0, static_cast<int>(i) + 1);
+                break;
+            }
+        }
+    }
+    return current;
+}
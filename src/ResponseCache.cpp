@@ -0,0 +1,223 @@
+#include "ResponseCache.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <zlib.h>
+
+ResponseCache::ResponseCache(size_t maxEntries, size_t capacityBytes)
+    : maxEntries(max<size_t>(maxEntries, 1)), capacityBytes(capacityBytes), usedBytes(0),
+      newestVersion(0) {}
+
+shared_ptr<const ResponseCache::Entry> ResponseCache::get(const string& key, uint64_t version,
+                                                          time_t now) const {
+    lock_guard<mutex> lock(cacheMutex);
+    auto it = entries.find(key);
+    if (it == entries.end() || it->second.entry->version != version ||
+        (it->second.entry->validUntil > 0 && now >= it->second.entry->validUntil)) {
+        stats.misses++;
+        return nullptr;
+    }
+    stats.hits++;
+    lru.splice(lru.begin(), lru, it->second.recent);
+    return it->second.entry;
+}
+
+shared_ptr<const ResponseCache::Entry> ResponseCache::put(const string& key, uint64_t version,
+                                                          time_t validUntil, string body) {
+    auto entry = make_shared<Entry>();
+    entry->version = version;
+    entry->validUntil = validUntil;
+    entry->etag = makeETag(body);
+    entry->body = move(body);
+
+    lock_guard<mutex> lock(cacheMutex);
+    if (version > newestVersion) {
+        // Every stored body predates this write
+        removeAll();
+        newestVersion = version;
+    } else if (version < newestVersion) {
+        // Built from an older version than what is cached; serve it once
+        return entry;
+    }
+
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        usedBytes -= it->second.bytes;
+        lru.erase(it->second.recent);
+        entries.erase(it);
+    }
+    // Compressed copies, made later, are smaller than the body and not counted
+    size_t bytes = key.size() + entry->body.size() + sizeof(Entry);
+    lru.push_front(key);
+    entries[key] = Slot{entry, lru.begin(), bytes};
+    usedBytes += bytes;
+    evictIfNeeded();
+    return entry;
+}
+
+void ResponseCache::evictIfNeeded() {
+    // Always keep the entry just stored, even if it alone exceeds the budget
+    while ((entries.size() > maxEntries || usedBytes > capacityBytes) && lru.size() > 1) {
+        auto victim = entries.find(lru.back());
+        usedBytes -= victim->second.bytes;
+        entries.erase(victim);
+        lru.pop_back();
+        stats.evictions++;
+    }
+}
+
+void ResponseCache::removeAll() {
+    entries.clear();
+    lru.clear();
+    usedBytes = 0;
+}
+
+void ResponseCache::clear() {
+    lock_guard<mutex> lock(cacheMutex);
+    removeAll();
+}
+
+ResponseCache::Stats ResponseCache::getStats() const {
+    lock_guard<mutex> lock(cacheMutex);
+    Stats current = stats;
+    current.entries = entries.size();
+    current.bytes = usedBytes;
+    return current;
+}
+
+string ResponseCache::makeETag(const string& body) {
+    // FNV-1a; equal bodies get equal tags across versions
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : body) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    char tag[24];
+    snprintf(tag, sizeof(tag), "\"%016llx\"", static_cast<unsigned long long>(hash));
+    return tag;
+}
+
+bool ResponseCache::matchesETag(const string& ifNoneMatch, const string& etag) {
+    if (ifNoneMatch == "*") {
+        return true;
+    }
+    // A comma-separated list, possibly with weak W/ prefixes
+    return ifNoneMatch.find(etag) != string::npos;
+}
+
+const string& ResponseCache::Entry::compressed(Encoding encoding) const {
+    if (encoding == Encoding::GZIP) {
+        call_once(gzipOnce, [this]() { compress(body, Encoding::GZIP, gzipBody); });
+        return gzipBody;
+    }
+    if (encoding == Encoding::DEFLATE) {
+        call_once(deflateOnce, [this]() { compress(body, Encoding::DEFLATE, deflateBody); });
+        return deflateBody;
+    }
+    return body;
+}
+
+// A coding listed by name gets its own weight; `*` weighs only the codings
+// not listed (RFC 9110 section 12.5.3). identity is acceptable unless
+// refused, but only competes with the others when it is weighted at all.
+void ResponseCache::acceptedQualities(const string& acceptEncoding, double& gzip, double& deflate,
+                                      double& identity, bool& identityListed) {
+    double listed[3] = {-1, -1, -1};    // gzip, deflate, identity; -1 = not listed
+    double star = -1;
+
+    // Comma-separated codings with optional ;q= weights
+    size_t start = 0;
+    while (start < acceptEncoding.size()) {
+        size_t end = acceptEncoding.find(',', start);
+        if (end == string::npos) end = acceptEncoding.size();
+        string item = acceptEncoding.substr(start, end - start);
+        start = end + 1;
+
+        double quality = 1;
+        size_t semicolon = item.find(';');
+        if (semicolon != string::npos) {
+            size_t q = item.find("q=", semicolon);
+            if (q != string::npos) quality = atof(item.c_str() + q + 2);
+            item.erase(semicolon);
+        }
+        item.erase(0, item.find_first_not_of(" \t"));
+        item.erase(item.find_last_not_of(" \t") + 1);
+
+        double* slot = item == "gzip" ? &listed[0] : item == "deflate" ? &listed[1]
+                     : item == "identity" ? &listed[2] : item == "*" ? &star : nullptr;
+        if (slot) {
+            *slot = max(*slot, quality);
+        }
+    }
+
+    gzip = listed[0] >= 0 ? listed[0] : max(star, 0.0);
+    deflate = listed[1] >= 0 ? listed[1] : max(star, 0.0);
+    identityListed = listed[2] >= 0 || star >= 0;
+    identity = listed[2] >= 0 ? listed[2] : star >= 0 ? star : 1;
+}
+
+ResponseCache::Encoding ResponseCache::negotiate(const string& acceptEncoding) {
+    double gzip, deflate, identity;
+    bool identityListed;
+    acceptedQualities(acceptEncoding, gzip, deflate, identity, identityListed);
+
+    // Ties go to the smaller body
+    double floor = identityListed ? identity : 0;
+    if (gzip > 0 && gzip >= deflate && gzip >= floor) return Encoding::GZIP;
+    if (deflate > 0 && deflate >= floor) return Encoding::DEFLATE;
+    return Encoding::IDENTITY;
+}
+
+bool ResponseCache::refusesIdentity(const string& acceptEncoding) {
+    double gzip, deflate, identity;
+    bool identityListed;
+    acceptedQualities(acceptEncoding, gzip, deflate, identity, identityListed);
+    return identity <= 0;
+}
+
+const char* ResponseCache::encodingName(Encoding encoding) {
+    switch (encoding) {
+        case Encoding::GZIP: return "gzip";
+        case Encoding::DEFLATE: return "deflate";
+        case Encoding::IDENTITY:
+        default: return "identity";
+    }
+}
+
+string ResponseCache::encodedETag(const string& etag, Encoding encoding) {
+    if (encoding == Encoding::IDENTITY || etag.size() < 2) {
+        return etag;
+    }
+    return etag.substr(0, etag.size() - 1) + "-" + encodingName(encoding) + "\"";
+}
+
+bool ResponseCache::compress(const string& input, Encoding encoding, string& output) {
+    output.clear();
+    if (encoding == Encoding::IDENTITY) {
+        output = input;
+        return true;
+    }
+
+    z_stream stream = {};
+    // 15-bit window; +16 selects the gzip wrapper instead of zlib's
+    int windowBits = encoding == Encoding::GZIP ? 15 + 16 : 15;
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+
+    output.resize(deflateBound(&stream, input.size()));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = input.size();
+    stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    stream.avail_out = output.size();
+
+    int result = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        output.clear();
+        return false;
+    }
+    output.resize(stream.total_out);
+    return true;
+}
@@ -0,0 +1,103 @@
+#include "SQLiteConnectionPool.hpp"
+#include <iostream>
+
+SQLiteConnectionPool::Lease::Lease(SQLiteConnectionPool* owner, SQLiteHandler* conn, bool isWriter)
+    : pool(owner), handler(conn), writer(isWriter) {}
+
+SQLiteConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : pool(other.pool), handler(other.handler), writer(other.writer) {
+    other.pool = nullptr;
+    other.handler = nullptr;
+}
+
+SQLiteConnectionPool::Lease::~Lease() {
+    if (pool) {
+        pool->release(handler, writer);
+    }
+}
+
+SQLiteConnectionPool::SQLiteConnectionPool(const string& path, size_t readers,
+                                           const string& synchronous)
+    : dbPath(path), synchronousMode(synchronous), readerCount(readers > 0 ? readers : 1) {}
+
+SQLiteConnectionPool::~SQLiteConnectionPool() {
+    close();
+}
+
+bool SQLiteConnectionPool::open() {
+    if (!sqlite3_threadsafe()) {
+        cerr << "SQLite was built without thread support; cannot pool connections" << endl;
+        return false;
+    }
+
+    writerConnection.reset(new SQLiteHandler(dbPath));
+    writerConnection->setSynchronous(synchronousMode);
+    if (!writerConnection->connect()) {
+        writerConnection.reset();
+        return false;
+    }
+
+    vector<unique_ptr<SQLiteHandler>> opened;
+    for (size_t i = 0; i < readerCount; i++) {
+        unique_ptr<SQLiteHandler> reader(new SQLiteHandler(dbPath));
+        if (!reader->connect(true)) {
+            cerr << "Failed to open read connection " << i + 1 << endl;
+            close();
+            return false;
+        }
+        opened.push_back(move(reader));
+    }
+
+    lock_guard<mutex> lock(readerMutex);
+    for (auto& reader : opened) {
+        idleReaders.push_back(reader.get());
+        readerConnections.push_back(move(reader));
+    }
+    return true;
+}
+
+void SQLiteConnectionPool::close() {
+    {
+        lock_guard<mutex> lock(readerMutex);
+        idleReaders.clear();
+        readerConnections.clear();
+    }
+    lock_guard<mutex> lock(writerMutex);
+    writerConnection.reset();
+}
+
+bool SQLiteConnectionPool::isOpen() const {
+    return writerConnection != nullptr;
+}
+
+SQLiteConnectionPool::Lease SQLiteConnectionPool::acquireReader() {
+    unique_lock<mutex> lock(readerMutex);
+    readerAvailable.wait(lock, [this] { return !idleReaders.empty(); });
+
+    SQLiteHandler* reader = idleReaders.back();
+    idleReaders.pop_back();
+    return Lease(this, reader, false);
+}
+
+SQLiteConnectionPool::Lease SQLiteConnectionPool::acquireWriter() {
+    // Unlocked again by release() when the lease ends
+    writerMutex.lock();
+    return Lease(this, writerConnection.get(), true);
+}
+
+void SQLiteConnectionPool::release(SQLiteHandler* handler, bool isWriter) {
+    if (isWriter) {
+        writerMutex.unlock();
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(readerMutex);
+        idleReaders.push_back(handler);
+    }
+    readerAvailable.notify_one();
+}
+
+size_t SQLiteConnectionPool::getReaderCount() const {
+    return readerCount;
+}
@@ -1,23 +1,104 @@
 #include "SQLiteHandler.hpp"
+#include <algorithm>
 #include <iostream>
-#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
-SQLiteHandler::SQLiteHandler(const string& path) : dbPath(path), db(nullptr) {}
+// Column order shared by every SELECT so rowToTask() can decode any result
+static const char* TASK_COLUMNS =
+    "id, title, description, priority, status, created_at, due_date";
+
+// Schema versions (PRAGMA user_version):
+//   1 - priority/status stored as TEXT names (databases created before
+//       versioning report 0 and are treated as 1)
+//   2 - priority/status stored as integer codes, covering indexes
+static const int LATEST_SCHEMA_VERSION = 2;
+
+// Set while a bulk load runs without secondary indexes or search triggers
+static const char* BULK_LOAD_SETTING = "bulk_load_pending";
+
+// FTS5 flushes a new segment (and later merges it) each time its in-memory
+// term hash fills. The default 1 MB is right for trigger-sized writes; the
+// bulk rebuild raises it so 10M rows produce a few large segments instead.
+static const int FTS_HASH_SIZE_DEFAULT = 1024 * 1024;
+static const int FTS_HASH_SIZE_BULK = 256 * 1024 * 1024;
+
+// Integer codes persisted in v2; never renumber these
+static int priorityCode(Priority priority) {
+    switch (priority) {
+        case Priority::LOW: return 0;
+        case Priority::MEDIUM: return 1;
+        case Priority::HIGH: return 2;
+    }
+    return 1;
+}
+
+static int statusCode(Status status) {
+    switch (status) {
+        case Status::PENDING: return 0;
+        case Status::IN_PROGRESS: return 1;
+        case Status::COMPLETED: return 2;
+    }
+    return 0;
+}
+
+// SQL that converts a v1 TEXT column to its v2 code, mirroring
+// parsePriority()/parseStatus() defaults
+static string v1PriorityToCode(const string& column) {
+    return "CASE " + column + " WHEN 'LOW' THEN 0 WHEN 'HIGH' THEN 2 ELSE 1 END";
+}
+
+static string v1StatusToCode(const string& column) {
+    return "CASE " + column + " WHEN 'IN_PROGRESS' THEN 1 WHEN 'COMPLETED' THEN 2 ELSE 0 END";
+}
+
+SQLiteHandler::SQLiteHandler(const string& path)
+    : db(nullptr), dbPath(path), synchronousMode("NORMAL"), ftsAvailable(false),
+      readOnly(false), schemaVersion(LATEST_SCHEMA_VERSION) {}
 
 SQLiteHandler::~SQLiteHandler() {
     disconnect();
 }
 
-bool SQLiteHandler::connect() {
-    int rc = sqlite3_open(dbPath.c_str(), &db);
-    
+bool SQLiteHandler::connect(bool openReadOnly) {
+    readOnly = openReadOnly;
+
+    // Each handler is only ever used by one thread at a time (see
+    // SQLiteConnectionPool), so SQLite's per-connection mutex is skipped
+    int flags = SQLITE_OPEN_NOMUTEX |
+                (readOnly ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    int rc = sqlite3_open_v2(dbPath.c_str(), &db, flags, nullptr);
+
     if (rc != SQLITE_OK) {
         cerr << "Cannot open database: " << sqlite3_errmsg(db) << endl;
+        sqlite3_close(db);
+        db = nullptr;
         return false;
     }
-    
+
+    sqlite3_busy_timeout(db, 5000);
+
+    if (readOnly) {
+        // Journal mode is persistent and was set by the writer; only
+        // detect which optional tables exist
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, "SELECT 1 FROM sqlite_master WHERE name='tasks_fts';",
+                               -1, &stmt, nullptr) == SQLITE_OK) {
+            ftsAvailable = sqlite3_step(stmt) == SQLITE_ROW;
+            sqlite3_finalize(stmt);
+        }
+        schemaVersion = max(readUserVersion(), 1);
+        return true;
+    }
+
     cout << "✓ Connected to SQLite database: " << dbPath << endl;
-    
+
+    // WAL lets readers run alongside a writer and turns each commit into
+    // a sequential log append instead of a rollback-journal rewrite
+    execute("PRAGMA journal_mode=WAL;", "Journal mode");
+    string syncSql = "PRAGMA synchronous=" + synchronousMode + ";";
+    execute(syncSql.c_str(), "Synchronous mode");
+
     // Create schema if not exists
     return createSchema();
 }
@@ -33,36 +114,404 @@ bool SQLiteHandler::isConnected() {
     return db != nullptr;
 }
 
+bool SQLiteHandler::isReadOnly() const {
+    return readOnly;
+}
+
+bool SQLiteHandler::setSynchronous(const string& level) {
+    string upper = level;
+    for (auto& c : upper) c = toupper(c);
+
+    if (upper != "OFF" && upper != "NORMAL" && upper != "FULL" && upper != "EXTRA") {
+        cerr << "Invalid synchronous level: " << level << endl;
+        return false;
+    }
+
+    synchronousMode = upper;
+    if (db) {
+        string sql = "PRAGMA synchronous=" + synchronousMode + ";";
+        return execute(sql.c_str(), "Synchronous mode");
+    }
+    return true;
+}
+
+string SQLiteHandler::getSynchronous() const {
+    return synchronousMode;
+}
+
+bool SQLiteHandler::execute(const char* sql, const char* context) {
+    char* errMsg = nullptr;
+    int rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
+
+    if (rc != SQLITE_OK) {
+        cerr << context << " failed: " << (errMsg ? errMsg : sqlite3_errmsg(db)) << endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    return true;
+}
+
+int SQLiteHandler::queryInt(const char* sql, int fallback) {
+    int value = fallback;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+            value = sqlite3_column_int(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+    return value;
+}
+
+int SQLiteHandler::readUserVersion() {
+    return queryInt("PRAGMA user_version;", 0);
+}
+
+bool SQLiteHandler::tableExists(const char* name) {
+    sqlite3_stmt* stmt;
+    bool exists = false;
+    if (sqlite3_prepare_v2(db, "SELECT 1 FROM sqlite_master WHERE type='table' AND name=?;",
+                           -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, name, -1, SQLITE_TRANSIENT);
+        exists = sqlite3_step(stmt) == SQLITE_ROW;
+        sqlite3_finalize(stmt);
+    }
+    return exists;
+}
+
+int SQLiteHandler::getSchemaVersion() const {
+    return schemaVersion;
+}
+
 bool SQLiteHandler::createSchema() {
+    if (!tableExists("tasks")) {
+        // New databases start on the latest layout
+        const char* sql = R"(
+            CREATE TABLE tasks (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                title TEXT NOT NULL,
+                description TEXT NOT NULL,
+                priority INTEGER NOT NULL,
+                status INTEGER NOT NULL,
+                created_at INTEGER NOT NULL,
+                due_date INTEGER DEFAULT 0
+            );
+        )";
+        if (!execute(sql, "SQL")) {
+            return false;
+        }
+        string version = "PRAGMA user_version=" + to_string(LATEST_SCHEMA_VERSION) + ";";
+        execute(version.c_str(), "Schema version");
+    }
+
+    schemaVersion = max(readUserVersion(), 1);
+
+    const char* settingsSql = R"(
+        CREATE TABLE IF NOT EXISTS settings (
+            key TEXT PRIMARY KEY,
+            value TEXT
+        );
+    )";
+
+    if (!execute(settingsSql, "SQL")) {
+        return false;
+    }
+
+    // An unfinished bulk load keeps its indexes dropped until it completes
+    if (isBulkLoadPending()) {
+        cout << "⚠️  Bulk load in progress: indexes are rebuilt when it finishes" << endl;
+        ftsAvailable = tableExists("tasks_fts");
+        return true;
+    }
+
+    if (!createIndexes()) {
+        return false;
+    }
+
+    // Search is optional: without FTS5 searchTasks() falls back to LIKE
+    ftsAvailable = createSearchIndex();
+
+    return schemaVersion >= LATEST_SCHEMA_VERSION || migrateSchema();
+}
+
+bool SQLiteHandler::createIndexes() {
+    if (schemaVersion < 2) {
+        const char* sql = R"(
+            CREATE INDEX IF NOT EXISTS idx_tasks_status ON tasks(status);
+            CREATE INDEX IF NOT EXISTS idx_tasks_priority ON tasks(priority);
+            CREATE INDEX IF NOT EXISTS idx_tasks_due_date ON tasks(due_date);
+            CREATE INDEX IF NOT EXISTS idx_tasks_created_at ON tasks(created_at);
+        )";
+        return execute(sql, "SQL");
+    }
+
+    // Every index implicitly ends in the rowid, so (key, id) ordering and
+    // per-status/priority counts are answered from the index alone
     const char* sql = R"(
-        CREATE TABLE IF NOT EXISTS tasks (
+        CREATE INDEX IF NOT EXISTS idx_tasks_status_priority ON tasks(status, priority);
+        CREATE INDEX IF NOT EXISTS idx_tasks_priority ON tasks(priority);
+        CREATE INDEX IF NOT EXISTS idx_tasks_due_date ON tasks(due_date);
+        CREATE INDEX IF NOT EXISTS idx_tasks_created_at ON tasks(created_at);
+    )";
+    return execute(sql, "SQL");
+}
+
+bool SQLiteHandler::migrateSchema(int batchSize) {
+    if (readOnly) {
+        return false;
+    }
+    if (schemaVersion < 2 && !migrateToV2(batchSize)) {
+        return false;
+    }
+    return true;
+}
+
+// v1 -> v2: copy rows into tasks_v2 with integer enum codes. An interrupted
+// copy resumes from the highest id already copied. Rows written to `tasks`
+// while batches run are reconciled in the final transaction.
+bool SQLiteHandler::migrateToV2(int batchSize) {
+    const char* createSql = R"(
+        CREATE TABLE IF NOT EXISTS tasks_v2 (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             title TEXT NOT NULL,
             description TEXT NOT NULL,
-            priority TEXT NOT NULL,
-            status TEXT NOT NULL,
+            priority INTEGER NOT NULL,
+            status INTEGER NOT NULL,
             created_at INTEGER NOT NULL,
             due_date INTEGER DEFAULT 0
         );
-        
-        CREATE TABLE IF NOT EXISTS settings (
-            key TEXT PRIMARY KEY,
-            value TEXT
+    )";
+    if (!execute(createSql, "Migration")) {
+        return false;
+    }
+
+    string copySql = "INSERT INTO tasks_v2 (" + string(TASK_COLUMNS) + ") "
+                     "SELECT id, title, description, " + v1PriorityToCode("priority") + ", " +
+                     v1StatusToCode("status") + ", created_at, due_date "
+                     "FROM tasks WHERE id > ? ORDER BY id LIMIT ?;";
+    sqlite3_stmt* copy;
+    if (sqlite3_prepare_v2(db, copySql.c_str(), -1, &copy, nullptr) != SQLITE_OK) {
+        cerr << "Migration failed: " << sqlite3_errmsg(db) << endl;
+        return false;
+    }
+
+    int copied = 0;
+    while (true) {
+        int lastId = queryInt("SELECT MAX(id) FROM tasks_v2;", 0);
+        if (!beginTransaction()) {
+            sqlite3_finalize(copy);
+            return false;
+        }
+
+        sqlite3_bind_int(copy, 1, lastId);
+        sqlite3_bind_int(copy, 2, batchSize);
+        int rc = sqlite3_step(copy);
+        int rows = sqlite3_changes(db);
+        sqlite3_reset(copy);
+
+        if (rc != SQLITE_DONE) {
+            cerr << "Migration failed: " << sqlite3_errmsg(db) << endl;
+            rollbackTransaction();
+            sqlite3_finalize(copy);
+            return false;
+        }
+        if (!commitOrRollback()) {
+            sqlite3_finalize(copy);
+            return false;
+        }
+
+        copied += rows;
+        if (rows < batchSize) {
+            break;
+        }
+    }
+    sqlite3_finalize(copy);
+
+    // Switch-over: reconcile concurrent edits, then swap the tables
+    if (!beginTransaction()) {
+        return false;
+    }
+
+    int oldSequence = queryInt("SELECT seq FROM sqlite_sequence WHERE name='tasks';", 0);
+
+    string reconcileSql =
+        "DELETE FROM tasks_v2 WHERE id NOT IN (SELECT id FROM tasks);"
+        "INSERT OR REPLACE INTO tasks_v2 (" + string(TASK_COLUMNS) + ") "
+        "SELECT t.id, t.title, t.description, " + v1PriorityToCode("t.priority") + ", " +
+        v1StatusToCode("t.status") + ", t.created_at, t.due_date FROM tasks AS t "
+        "WHERE NOT EXISTS (SELECT 1 FROM tasks_v2 AS n WHERE n.id = t.id "
+        "AND n.title IS t.title AND n.description IS t.description "
+        "AND n.priority IS " + v1PriorityToCode("t.priority") + " "
+        "AND n.status IS " + v1StatusToCode("t.status") + " "
+        "AND n.created_at IS t.created_at AND n.due_date IS t.due_date);"
+        "DROP TABLE tasks;"
+        "ALTER TABLE tasks_v2 RENAME TO tasks;"
+        "PRAGMA user_version=2;";
+
+    if (!execute(reconcileSql.c_str(), "Migration")) {
+        rollbackTransaction();
+        return false;
+    }
+
+    // Keep AUTOINCREMENT from reusing ids that were deleted before the copy
+    string sequenceSql = "UPDATE sqlite_sequence SET seq = MAX(seq, " + to_string(oldSequence) +
+                         ") WHERE name='tasks';";
+    execute(sequenceSql.c_str(), "Migration");
+
+    schemaVersion = 2;
+    if (!createIndexes() || (ftsAvailable && !createSearchIndex())) {
+        rollbackTransaction();
+        schemaVersion = 1;
+        return false;
+    }
+
+    if (!commitOrRollback()) {
+        schemaVersion = 1;
+        return false;
+    }
+
+    cout << "✓ Migrated database schema to v2 (" << copied << " rows)" << endl;
+    return true;
+}
+
+bool SQLiteHandler::createSearchIndex() {
+    bool existed = false;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "SELECT 1 FROM sqlite_master WHERE name='tasks_fts';",
+                           -1, &stmt, nullptr) == SQLITE_OK) {
+        existed = sqlite3_step(stmt) == SQLITE_ROW;
+        sqlite3_finalize(stmt);
+    }
+
+    // External-content table: the text lives only in `tasks`, the triggers
+    // keep the inverted index in step with every insert/update/delete
+    const char* sql = R"(
+        CREATE VIRTUAL TABLE IF NOT EXISTS tasks_fts USING fts5(
+            title, description,
+            content='tasks', content_rowid='id',
+            tokenize='unicode61 remove_diacritics 2'
         );
+
+        CREATE TRIGGER IF NOT EXISTS tasks_fts_insert AFTER INSERT ON tasks BEGIN
+            INSERT INTO tasks_fts(rowid, title, description)
+            VALUES (new.id, new.title, new.description);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS tasks_fts_delete AFTER DELETE ON tasks BEGIN
+            INSERT INTO tasks_fts(tasks_fts, rowid, title, description)
+            VALUES ('delete', old.id, old.title, old.description);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS tasks_fts_update AFTER UPDATE OF title, description ON tasks BEGIN
+            INSERT INTO tasks_fts(tasks_fts, rowid, title, description)
+            VALUES ('delete', old.id, old.title, old.description);
+            INSERT INTO tasks_fts(rowid, title, description)
+            VALUES (new.id, new.title, new.description);
+        END;
     )";
-    
+
     char* errMsg = nullptr;
-    int rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
-    
-    if (rc != SQLITE_OK) {
-        cerr << "SQL error: " << errMsg << endl;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        cerr << "Full-text search unavailable: " << errMsg << endl;
         sqlite3_free(errMsg);
         return false;
     }
-    
+
+    // Index rows that were stored before the search table existed
+    if (!existed) {
+        return execute("INSERT INTO tasks_fts(tasks_fts) VALUES('rebuild');", "Search index rebuild");
+    }
     return true;
 }
 
+bool SQLiteHandler::beginBulkLoad() {
+    if (!beginTransaction()) {
+        return false;
+    }
+
+    // Search triggers tokenize every row; dropping them and the secondary
+    // indexes lets inserts touch only the table b-tree
+    vector<string> drops = {
+        "DROP TRIGGER IF EXISTS tasks_fts_insert;",
+        "DROP TRIGGER IF EXISTS tasks_fts_delete;",
+        "DROP TRIGGER IF EXISTS tasks_fts_update;"
+    };
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "SELECT name FROM sqlite_master WHERE type='index' "
+                               "AND tbl_name='tasks' AND sql IS NOT NULL;",
+                           -1, &stmt, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            drops.push_back("DROP INDEX IF EXISTS " + name + ";");
+        }
+        sqlite3_finalize(stmt);
+    }
+
+    for (const auto& sql : drops) {
+        if (!execute(sql.c_str(), "Bulk load")) {
+            rollbackTransaction();
+            return false;
+        }
+    }
+
+    if (!setSetting(BULK_LOAD_SETTING, "1")) {
+        rollbackTransaction();
+        return false;
+    }
+    return commitOrRollback();
+}
+
+bool SQLiteHandler::finishBulkLoad() {
+    if (!beginTransaction()) {
+        return false;
+    }
+
+    // One sorted pass per index, then re-tokenize all rows at once
+    bool ok = createIndexes();
+    if (ok && ftsAvailable) {
+        const string hashSize = "INSERT INTO tasks_fts(tasks_fts, rank) VALUES('hashsize', ";
+        const string bulkHash = hashSize + to_string(FTS_HASH_SIZE_BULK) + ");";
+        const string defaultHash = hashSize + to_string(FTS_HASH_SIZE_DEFAULT) + ");";
+        ok = execute(bulkHash.c_str(), "Search index hash size") &&
+             execute("INSERT INTO tasks_fts(tasks_fts) VALUES('rebuild');", "Search index rebuild") &&
+             execute(defaultHash.c_str(), "Search index hash size") &&
+             createSearchIndex();
+    }
+    if (!ok || !deleteSetting(BULK_LOAD_SETTING)) {
+        rollbackTransaction();
+        return false;
+    }
+    return commitOrRollback();
+}
+
+bool SQLiteHandler::isBulkLoadPending() {
+    return getSetting(BULK_LOAD_SETTING).has_value();
+}
+
+bool SQLiteHandler::beginTransaction() {
+    return execute("BEGIN IMMEDIATE;", "Begin transaction");
+}
+
+bool SQLiteHandler::commitTransaction() {
+    return execute("COMMIT;", "Commit");
+}
+
+bool SQLiteHandler::rollbackTransaction() {
+    return execute("ROLLBACK;", "Rollback");
+}
+
+bool SQLiteHandler::commitOrRollback() {
+    // A failed COMMIT (e.g. SQLITE_BUSY) leaves the transaction open
+    if (commitTransaction()) {
+        return true;
+    }
+    if (!sqlite3_get_autocommit(db)) {
+        rollbackTransaction();
+    }
+    return false;
+}
+
 Priority SQLiteHandler::parsePriority(const string& str) {
     if (str == "HIGH") return Priority::HIGH;
     if (str == "LOW") return Priority::LOW;
@@ -93,165 +542,693 @@ string SQLiteHandler::statusToString(Status status) {
     return "PENDING";
 }
 
+void SQLiteHandler::bindPriority(sqlite3_stmt* stmt, int index, Priority priority) {
+    if (schemaVersion >= 2) {
+        sqlite3_bind_int(stmt, index, priorityCode(priority));
+    } else {
+        sqlite3_bind_text(stmt, index, priorityToString(priority).c_str(), -1, SQLITE_TRANSIENT);
+    }
+}
+
+void SQLiteHandler::bindStatus(sqlite3_stmt* stmt, int index, Status status) {
+    if (schemaVersion >= 2) {
+        sqlite3_bind_int(stmt, index, statusCode(status));
+    } else {
+        sqlite3_bind_text(stmt, index, statusToString(status).c_str(), -1, SQLITE_TRANSIENT);
+    }
+}
+
+Priority SQLiteHandler::decodePriority(sqlite3_stmt* stmt, int column) {
+    if (sqlite3_column_type(stmt, column) == SQLITE_INTEGER) {
+        switch (sqlite3_column_int(stmt, column)) {
+            case 0: return Priority::LOW;
+            case 2: return Priority::HIGH;
+            default: return Priority::MEDIUM;
+        }
+    }
+    return parsePriority(reinterpret_cast<const char*>(sqlite3_column_text(stmt, column)));
+}
+
+Status SQLiteHandler::decodeStatus(sqlite3_stmt* stmt, int column) {
+    if (sqlite3_column_type(stmt, column) == SQLITE_INTEGER) {
+        switch (sqlite3_column_int(stmt, column)) {
+            case 1: return Status::IN_PROGRESS;
+            case 2: return Status::COMPLETED;
+            default: return Status::PENDING;
+        }
+    }
+    return parseStatus(reinterpret_cast<const char*>(sqlite3_column_text(stmt, column)));
+}
+
+// Binds title, description, priority, status, created_at, due_date
+// starting at parameter firstIndex
+void SQLiteHandler::bindTaskFields(sqlite3_stmt* stmt, const Task& task, int firstIndex) {
+    sqlite3_bind_text(stmt, firstIndex, task.getTitle().c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, firstIndex + 1, task.getDescription().c_str(), -1, SQLITE_TRANSIENT);
+    bindPriority(stmt, firstIndex + 2, task.getPriority());
+    bindStatus(stmt, firstIndex + 3, task.getStatus());
+    sqlite3_bind_int64(stmt, firstIndex + 4, task.getCreatedAt());
+    sqlite3_bind_int64(stmt, firstIndex + 5, task.getDueDate());
+}
+
+Task SQLiteHandler::rowToTask(sqlite3_stmt* stmt) {
+    Task task(
+        sqlite3_column_int(stmt, 0),  // id
+        reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),  // title
+        reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)),  // description
+        decodePriority(stmt, 3)  // priority
+    );
+
+    task.setStatus(decodeStatus(stmt, 4));
+    task.setCreatedAt(sqlite3_column_int64(stmt, 5));
+    task.setDueDate(sqlite3_column_int64(stmt, 6));
+    return task;
+}
+
 int SQLiteHandler::insertTask(const Task& task) {
-    stringstream sql;
-    sql << "INSERT INTO tasks (title, description, priority, status, created_at, due_date) VALUES ('"
-        << task.getTitle() << "', '"
-        << task.getDescription() << "', '"
-        << priorityToString(task.getPriority()) << "', '"
-        << statusToString(task.getStatus()) << "', "
-        << task.getCreatedAt() << ", "
-        << task.getDueDate() << ");";
-    
-    char* errMsg = nullptr;
-    int rc = sqlite3_exec(db, sql.str().c_str(), nullptr, nullptr, &errMsg);
-    
-    if (rc != SQLITE_OK) {
-        cerr << "Insert failed: " << errMsg << endl;
-        sqlite3_free(errMsg);
+    const char* sql = "INSERT INTO tasks (title, description, priority, status, created_at, due_date) "
+                      "VALUES (?, ?, ?, ?, ?, ?);";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        cerr << "Insert failed: " << sqlite3_errmsg(db) << endl;
+        return -1;
+    }
+
+    bindTaskFields(stmt, task, 1);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (rc != SQLITE_DONE) {
+        cerr << "Insert failed: " << sqlite3_errmsg(db) << endl;
         return -1;
     }
-    
+
     return sqlite3_last_insert_rowid(db);
 }
 
 bool SQLiteHandler::updateTask(const Task& task) {
-    stringstream sql;
-    sql << "UPDATE tasks SET "
-        << "title='" << task.getTitle() << "', "
-        << "description='" << task.getDescription() << "', "
-        << "priority='" << priorityToString(task.getPriority()) << "', "
-        << "status='" << statusToString(task.getStatus()) << "', "
-        << "due_date=" << task.getDueDate()
-        << " WHERE id=" << task.getId() << ";";
-    
-    char* errMsg = nullptr;
-    int rc = sqlite3_exec(db, sql.str().c_str(), nullptr, nullptr, &errMsg);
-    
-    if (rc != SQLITE_OK) {
-        cerr << "Update failed: " << errMsg << endl;
-        sqlite3_free(errMsg);
+    const char* sql = "UPDATE tasks SET title=?, description=?, priority=?, status=?, "
+                      "created_at=?, due_date=? WHERE id=?;";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        cerr << "Update failed: " << sqlite3_errmsg(db) << endl;
+        return false;
+    }
+
+    bindTaskFields(stmt, task, 1);
+    sqlite3_bind_int(stmt, 7, task.getId());
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (rc != SQLITE_DONE) {
+        cerr << "Update failed: " << sqlite3_errmsg(db) << endl;
         return false;
     }
-    
+
     return true;
 }
 
 bool SQLiteHandler::deleteTask(int id) {
-    stringstream sql;
-    sql << "DELETE FROM tasks WHERE id=" << id << ";";
-    
-    char* errMsg = nullptr;
-    int rc = sqlite3_exec(db, sql.str().c_str(), nullptr, nullptr, &errMsg);
-    
-    if (rc != SQLITE_OK) {
-        cerr << "Delete failed: " << errMsg << endl;
-        sqlite3_free(errMsg);
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "DELETE FROM tasks WHERE id=?;", -1, &stmt, nullptr) != SQLITE_OK) {
+        cerr << "Delete failed: " << sqlite3_errmsg(db) << endl;
         return false;
     }
-    
+
+    sqlite3_bind_int(stmt, 1, id);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (rc != SQLITE_DONE) {
+        cerr << "Delete failed: " << sqlite3_errmsg(db) << endl;
+        return false;
+    }
+
     return true;
 }
 
-Task* SQLiteHandler::getTaskById(int id) {
-    stringstream sql;
-    sql << "SELECT * FROM tasks WHERE id=" << id << ";";
-    
+optional<Task> SQLiteHandler::getTaskById(int id) {
+    string sql = string("SELECT ") + TASK_COLUMNS + " FROM tasks WHERE id=?;";
+
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db, sql.str().c_str(), -1, &stmt, nullptr);
-    
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+
     if (rc != SQLITE_OK) {
-        return nullptr;
+        return nullopt;
     }
-    
-    Task* task = nullptr;
+
+    sqlite3_bind_int(stmt, 1, id);
+
+    optional<Task> task;
     if (sqlite3_step(stmt) == SQLITE_ROW) {
-        task = new Task(
-            sqlite3_column_int(stmt, 0),  // id
-            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),  // title
-            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)),  // description
-            parsePriority(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)))  // priority
-        );
-        
-        task->setStatus(parseStatus(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4))));
-        task->setDueDate(sqlite3_column_int64(stmt, 6));
+        task = rowToTask(stmt);
     }
-    
+
     sqlite3_finalize(stmt);
     return task;
 }
 
 vector<Task> SQLiteHandler::getAllTasks() {
     vector<Task> tasks;
-    
-    const char* sql = "SELECT * FROM tasks ORDER BY id;";
+
+    string sql = string("SELECT ") + TASK_COLUMNS + " FROM tasks ORDER BY id;";
     sqlite3_stmt* stmt;
-    
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    
+
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+
     if (rc != SQLITE_OK) {
         return tasks;
     }
-    
+
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Task task(
-            sqlite3_column_int(stmt, 0),
-            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
-            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)),
-            parsePriority(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)))
-        );
-        
-        task.setStatus(parseStatus(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4))));
-        task.setDueDate(sqlite3_column_int64(stmt, 6));
-        
-        tasks.push_back(task);
+        tasks.push_back(rowToTask(stmt));
     }
-    
+
     sqlite3_finalize(stmt);
     return tasks;
 }
 
+bool SQLiteHandler::streamTasks(const function<bool(const Task&)>& onTask) {
+    string sql = string("SELECT ") + TASK_COLUMNS + " FROM tasks ORDER BY id;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        cerr << "Read failed: " << sqlite3_errmsg(db) << endl;
+        return false;
+    }
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        if (!onTask(rowToTask(stmt))) {
+            rc = SQLITE_DONE;
+            break;
+        }
+    }
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+int SQLiteHandler::markAllComplete() {
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "UPDATE tasks SET status=? WHERE status<>?;", -1, &stmt, nullptr) != SQLITE_OK) {
+        cerr << "Bulk update failed: " << sqlite3_errmsg(db) << endl;
+        return -1;
+    }
+
+    bindStatus(stmt, 1, Status::COMPLETED);
+    bindStatus(stmt, 2, Status::COMPLETED);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    return rc == SQLITE_DONE ? sqlite3_changes(db) : -1;
+}
+
+int SQLiteHandler::deleteTasksByStatus(Status status) {
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "DELETE FROM tasks WHERE status=?;", -1, &stmt, nullptr) != SQLITE_OK) {
+        cerr << "Bulk delete failed: " << sqlite3_errmsg(db) << endl;
+        return -1;
+    }
+
+    bindStatus(stmt, 1, status);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    return rc == SQLITE_DONE ? sqlite3_changes(db) : -1;
+}
+
+int SQLiteHandler::deleteAllTasks() {
+    if (!execute("DELETE FROM tasks;", "Bulk delete")) {
+        return -1;
+    }
+    return sqlite3_changes(db);
+}
+
+int SQLiteHandler::changePriority(Priority oldPriority, Priority newPriority) {
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "UPDATE tasks SET priority=? WHERE priority=?;", -1, &stmt, nullptr) != SQLITE_OK) {
+        cerr << "Bulk update failed: " << sqlite3_errmsg(db) << endl;
+        return -1;
+    }
+
+    bindPriority(stmt, 1, newPriority);
+    bindPriority(stmt, 2, oldPriority);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    return rc == SQLITE_DONE ? sqlite3_changes(db) : -1;
+}
+
+// Column (or v1 expression) holding a sort field's integer key
+string SQLiteHandler::sortColumn(TaskSortField field) const {
+    switch (field) {
+        case TaskSortField::PRIORITY:
+            return schemaVersion >= 2 ? string("priority") : v1PriorityToCode("priority");
+        case TaskSortField::STATUS:
+            return schemaVersion >= 2 ? string("status") : v1StatusToCode("status");
+        case TaskSortField::DUE_DATE:
+            return "due_date";
+        case TaskSortField::CREATED_AT:
+            return "created_at";
+        case TaskSortField::ID:
+        default:
+            return "id";
+    }
+}
+
+// Parameters are bound in the same order the clauses are appended here
+string SQLiteHandler::buildWhereClause(const TaskQuery& query) const {
+    string where;
+    auto add = [&where](const string& clause) {
+        where += where.empty() ? " WHERE " : " AND ";
+        where += clause;
+    };
+
+    if (query.status) add("status = ?");
+    if (query.priority) add("priority = ?");
+    if (query.dueFrom > 0) add("due_date >= ?");
+    if (query.dueTo > 0) add("due_date > 0 AND due_date <= ?");
+    if (query.overdue) {
+        string late = "(due_date > 0 AND due_date < ? AND status != ?)";
+        add(*query.overdue ? late : "NOT " + late);
+    }
+
+    // Keyset paging: a row-value comparison the (key, id) index can seek to
+    if (query.after) {
+        string op = query.descending ? " < " : " > ";
+        if (query.sortBy == TaskSortField::ID) {
+            add("id" + op + "?");
+        } else if (query.sortBy == TaskSortField::DUE_DATE && query.after->key == 0) {
+            add("(due_date = 0 AND id" + op + "?)");
+        } else if (query.sortBy == TaskSortField::DUE_DATE) {
+            add("(due_date = 0 OR (due_date, id)" + op + "(?, ?))");
+        } else {
+            add("(" + sortColumn(query.sortBy) + ", id)" + op + "(?, ?)");
+        }
+    }
+    return where;
+}
+
+void SQLiteHandler::bindQueryParams(sqlite3_stmt* stmt, const TaskQuery& query) {
+    int index = 1;
+    if (query.status) {
+        bindStatus(stmt, index++, *query.status);
+    }
+    if (query.priority) {
+        bindPriority(stmt, index++, *query.priority);
+    }
+    if (query.dueFrom > 0) sqlite3_bind_int64(stmt, index++, query.dueFrom);
+    if (query.dueTo > 0) sqlite3_bind_int64(stmt, index++, query.dueTo);
+    if (query.overdue) {
+        sqlite3_bind_int64(stmt, index++, query.currentTime());
+        bindStatus(stmt, index++, Status::COMPLETED);
+    }
+    if (query.after) {
+        bool keyed = query.sortBy != TaskSortField::ID &&
+                     !(query.sortBy == TaskSortField::DUE_DATE && query.after->key == 0);
+        if (keyed) {
+            sqlite3_bind_int64(stmt, index++, query.after->key);
+        }
+        sqlite3_bind_int(stmt, index++, query.after->id);
+    }
+}
+
+vector<Task> SQLiteHandler::queryTasks(const TaskQuery& query) {
+    vector<Task> tasks;
+    if (readOnly) {
+        // The writer may have migrated the layout since this reader opened
+        schemaVersion = max(readUserVersion(), 1);
+    }
+    const char* dir = query.descending ? " DESC" : " ASC";
+
+    // Ties break on id in the same direction so an index can serve the order
+    string orderBy;
+    switch (query.sortBy) {
+        case TaskSortField::ID:
+            orderBy = string("id") + dir;
+            break;
+        case TaskSortField::DUE_DATE:
+            // Tasks without a due date sort last, matching TaskManager::sortByDueDate
+            orderBy = string("due_date = 0, due_date") + dir + ", id" + dir;
+            break;
+        default:
+            orderBy = sortColumn(query.sortBy) + dir + ", id" + dir;
+            break;
+    }
+
+    string sql = string("SELECT ") + TASK_COLUMNS + " FROM tasks" + buildWhereClause(query)
+               + " ORDER BY " + orderBy;
+    if (query.limit >= 0 || query.offset > 0) {
+        sql += " LIMIT " + to_string(query.limit) + " OFFSET " + to_string(query.offset);
+    }
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        cerr << "Query failed: " << sqlite3_errmsg(db) << endl;
+        return tasks;
+    }
+
+    bindQueryParams(stmt, query);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        tasks.push_back(rowToTask(stmt));
+    }
+
+    sqlite3_finalize(stmt);
+    return tasks;
+}
+
+int SQLiteHandler::countTasks(const TaskQuery& query) {
+    if (readOnly) {
+        schemaVersion = max(readUserVersion(), 1);
+    }
+    string sql = "SELECT COUNT(*) FROM tasks" + buildWhereClause(query);
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        cerr << "Count failed: " << sqlite3_errmsg(db) << endl;
+        return -1;
+    }
+
+    bindQueryParams(stmt, query);
+    int count = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        count = sqlite3_column_int(stmt, 0);
+    }
+
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+// Turns free-form keywords into an FTS5 query: every word must match as a
+// prefix, and words are quoted so user input can't inject query syntax
+string SQLiteHandler::buildMatchExpression(const string& keywords) const {
+    string expression;
+    string word;
+    auto flush = [&]() {
+        if (word.empty()) return;
+        if (!expression.empty()) expression += " ";
+        expression += "\"";
+        for (char c : word) {
+            if (c == '"') expression += "\"\"";
+            else expression += c;
+        }
+        expression += "\"*";
+        word.clear();
+    };
+
+    for (char c : keywords) {
+        if (isspace(static_cast<unsigned char>(c))) flush();
+        else word += c;
+    }
+    flush();
+    return expression;
+}
+
+vector<TaskSearchResult> SQLiteHandler::searchTasks(const string& keywords, int limit) {
+    vector<TaskSearchResult> results;
+    string match = buildMatchExpression(keywords);
+    if (match.empty()) {
+        return results;
+    }
+    if (!ftsAvailable) {
+        return searchTasksLike(keywords, limit);
+    }
+
+    // Title hits weigh 10x description hits; the inner query ranks and
+    // limits inside the index before any task row is read
+    string sql = string("SELECT ") + TASK_COLUMNS + R"(, m.rank, m.snip
+        FROM (SELECT rowid AS match_id,
+                     bm25(tasks_fts, 10.0, 1.0) AS rank,
+                     snippet(tasks_fts, -1, '[', ']', '...', 12) AS snip
+              FROM tasks_fts WHERE tasks_fts MATCH ?
+              ORDER BY rank LIMIT ?) AS m
+        JOIN tasks ON tasks.id = m.match_id
+        ORDER BY m.rank;)";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        cerr << "Search failed: " << sqlite3_errmsg(db) << endl;
+        return results;
+    }
+
+    sqlite3_bind_text(stmt, 1, match.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, limit);
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* snip = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8));
+        results.push_back({rowToTask(stmt), sqlite3_column_double(stmt, 7), snip ? snip : ""});
+    }
+
+    sqlite3_finalize(stmt);
+    return results;
+}
+
+vector<TaskSearchResult> SQLiteHandler::searchTasksLike(const string& keywords, int limit) {
+    vector<TaskSearchResult> results;
+    string sql = string("SELECT ") + TASK_COLUMNS +
+                 " FROM tasks WHERE title LIKE ?1 OR description LIKE ?1 ORDER BY id LIMIT ?2;";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        cerr << "Search failed: " << sqlite3_errmsg(db) << endl;
+        return results;
+    }
+
+    string pattern = "%" + keywords + "%";
+    sqlite3_bind_text(stmt, 1, pattern.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, limit);
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        Task task = rowToTask(stmt);
+        results.push_back({task, 0.0, task.getDescription().substr(0, 80)});
+    }
+
+    sqlite3_finalize(stmt);
+    return results;
+}
+
 bool SQLiteHandler::saveTasks(const vector<Task>& tasks, int nextId) {
-    // Clear existing
-    sqlite3_exec(db, "DELETE FROM tasks;", nullptr, nullptr, nullptr);
-    
-    // Insert all tasks
+    // One transaction for the whole save: a single WAL commit instead of
+    // one fsync per row
+    if (!beginTransaction()) {
+        return false;
+    }
+
+    if (upsertTasks(tasks) < 0) {
+        rollbackTransaction();
+        return false;
+    }
+
+    unordered_set<int> savedIds;
+    savedIds.reserve(tasks.size());
     for (const auto& task : tasks) {
-        if (insertTask(task) < 0) {
+        savedIds.insert(task.getId());
+    }
+
+    // Delete only the rows that are no longer present in memory
+    vector<int> staleIds;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "SELECT id FROM tasks;", -1, &stmt, nullptr) != SQLITE_OK) {
+        cerr << "Save failed: " << sqlite3_errmsg(db) << endl;
+        rollbackTransaction();
+        return false;
+    }
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        int id = sqlite3_column_int(stmt, 0);
+        if (savedIds.find(id) == savedIds.end()) {
+            staleIds.push_back(id);
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        cerr << "Save failed: " << sqlite3_errmsg(db) << endl;
+        rollbackTransaction();
+        return false;
+    }
+
+    if (!staleIds.empty()) {
+        sqlite3_stmt* del;
+        if (sqlite3_prepare_v2(db, "DELETE FROM tasks WHERE id=?;", -1, &del, nullptr) != SQLITE_OK) {
+            cerr << "Save failed: " << sqlite3_errmsg(db) << endl;
+            rollbackTransaction();
             return false;
         }
+        for (int id : staleIds) {
+            sqlite3_bind_int(del, 1, id);
+            if (sqlite3_step(del) != SQLITE_DONE) {
+                cerr << "Delete failed for task " << id << ": " << sqlite3_errmsg(db) << endl;
+                sqlite3_finalize(del);
+                rollbackTransaction();
+                return false;
+            }
+            sqlite3_reset(del);
+        }
+        sqlite3_finalize(del);
     }
-    
+
     // Update next ID
-    stringstream sql;
-    sql << "INSERT OR REPLACE INTO settings (key, value) VALUES ('next_id', '" << nextId << "');";
-    
-    char* errMsg = nullptr;
-    int rc = sqlite3_exec(db, sql.str().c_str(), nullptr, nullptr, &errMsg);
-    
-    if (rc != SQLITE_OK) {
-        sqlite3_free(errMsg);
+    if (!setSetting("next_id", to_string(nextId))) {
+        rollbackTransaction();
         return false;
     }
-    
-    return true;
+
+    return commitOrRollback();
 }
 
 bool SQLiteHandler::loadTasks(vector<Task>& tasks, int& nextId) {
     tasks = getAllTasks();
-    
+
     // Get next ID
-    const char* sql = "SELECT value FROM settings WHERE key='next_id';";
+    optional<string> stored = getSetting("next_id");
+    if (stored) {
+        nextId = atoi(stored->c_str());
+    } else {
+        nextId = tasks.empty() ? 1 : tasks.back().getId() + 1;
+    }
+
+    return true;
+}
+
+int SQLiteHandler::upsertTasks(const vector<Task>& tasks) {
+    // Only rewrite rows whose content changed, so unchanged tasks cost a
+    // primary-key lookup and no page writes
+    const char* upsertSql = R"(
+        INSERT INTO tasks (id, title, description, priority, status, created_at, due_date)
+        VALUES (?, ?, ?, ?, ?, ?, ?)
+        ON CONFLICT(id) DO UPDATE SET
+            title=excluded.title,
+            description=excluded.description,
+            priority=excluded.priority,
+            status=excluded.status,
+            created_at=excluded.created_at,
+            due_date=excluded.due_date
+        WHERE title IS NOT excluded.title
+           OR description IS NOT excluded.description
+           OR priority IS NOT excluded.priority
+           OR status IS NOT excluded.status
+           OR created_at IS NOT excluded.created_at
+           OR due_date IS NOT excluded.due_date;
+    )";
+
+    sqlite3_stmt* upsert;
+    if (sqlite3_prepare_v2(db, upsertSql, -1, &upsert, nullptr) != SQLITE_OK) {
+        cerr << "Upsert failed: " << sqlite3_errmsg(db) << endl;
+        return -1;
+    }
+
+    int written = 0;
+    for (const auto& task : tasks) {
+        sqlite3_bind_int(upsert, 1, task.getId());
+        bindTaskFields(upsert, task, 2);
+
+        if (sqlite3_step(upsert) != SQLITE_DONE) {
+            cerr << "Upsert failed for task " << task.getId() << ": " << sqlite3_errmsg(db) << endl;
+            sqlite3_finalize(upsert);
+            return -1;
+        }
+        written += sqlite3_changes(db);
+        sqlite3_reset(upsert);
+    }
+    sqlite3_finalize(upsert);
+    return written;
+}
+
+bool SQLiteHandler::setSetting(const string& key, const string& value) {
     sqlite3_stmt* stmt;
-    
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            nextId = atoi(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
-        } else {
-            nextId = tasks.empty() ? 1 : tasks.back().getId() + 1;
+    if (sqlite3_prepare_v2(db, "INSERT OR REPLACE INTO settings (key, value) VALUES (?, ?);",
+                           -1, &stmt, nullptr) != SQLITE_OK) {
+        cerr << "Setting update failed: " << sqlite3_errmsg(db) << endl;
+        return false;
+    }
+    sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, value.c_str(), -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+optional<string> SQLiteHandler::getSetting(const string& key) {
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "SELECT value FROM settings WHERE key=?;", -1, &stmt, nullptr) != SQLITE_OK) {
+        return nullopt;
+    }
+    sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+
+    optional<string> value;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        value = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    return value;
+}
+
+bool SQLiteHandler::deleteSetting(const string& key) {
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "DELETE FROM settings WHERE key=?;", -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+bool SQLiteHandler::createSyncStateTable() {
+    return execute("CREATE TABLE IF NOT EXISTS sync_state ("
+                   "id INTEGER PRIMARY KEY, hash INTEGER NOT NULL);", "Sync state");
+}
+
+unordered_map<int, int64_t> SQLiteHandler::loadSyncState() {
+    unordered_map<int, int64_t> state;
+    if (!createSyncStateTable()) {
+        return state;
+    }
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "SELECT id, hash FROM sync_state;", -1, &stmt, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            state[sqlite3_column_int(stmt, 0)] = sqlite3_column_int64(stmt, 1);
         }
         sqlite3_finalize(stmt);
     }
-    
-    return true;
+    return state;
+}
+
+bool SQLiteHandler::updateSyncState(const vector<pair<int, int64_t>>& changed,
+                                    const vector<int>& removed) {
+    if (!createSyncStateTable()) {
+        return false;
+    }
+
+    sqlite3_stmt* upsert;
+    sqlite3_stmt* del;
+    if (sqlite3_prepare_v2(db, "INSERT OR REPLACE INTO sync_state (id, hash) VALUES (?, ?);",
+                           -1, &upsert, nullptr) != SQLITE_OK) {
+        cerr << "Sync state update failed: " << sqlite3_errmsg(db) << endl;
+        return false;
+    }
+    if (sqlite3_prepare_v2(db, "DELETE FROM sync_state WHERE id=?;", -1, &del, nullptr) != SQLITE_OK) {
+        cerr << "Sync state update failed: " << sqlite3_errmsg(db) << endl;
+        sqlite3_finalize(upsert);
+        return false;
+    }
+
+    bool ok = true;
+    for (const auto& entry : changed) {
+        sqlite3_bind_int(upsert, 1, entry.first);
+        sqlite3_bind_int64(upsert, 2, entry.second);
+        ok = ok && sqlite3_step(upsert) == SQLITE_DONE;
+        sqlite3_reset(upsert);
+    }
+    for (int id : removed) {
+        sqlite3_bind_int(del, 1, id);
+        ok = ok && sqlite3_step(del) == SQLITE_DONE;
+        sqlite3_reset(del);
+    }
+
+    sqlite3_finalize(upsert);
+    sqlite3_finalize(del);
+    return ok;
 }
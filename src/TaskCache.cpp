@@ -0,0 +1,134 @@
+#include "TaskCache.hpp"
+
+TaskCache::TaskCache(size_t capacity) : capacityBytes(capacity), usedBytes(0) {
+    stats.capacityBytes = capacity;
+}
+
+void TaskCache::setWriteBackHandler(function<bool(const Task&)> handler) {
+    writeBackHandler = handler;
+}
+
+size_t TaskCache::estimateSize(const Task& task) {
+    // Task object, heap text, list node links and the index bucket entry
+    return sizeof(Entry) + 2 * sizeof(void*) +
+           task.getTitle().capacity() + task.getDescription().capacity() +
+           sizeof(pair<int, list<Entry>::iterator>) + sizeof(void*);
+}
+
+size_t TaskCache::fingerprint(const Task& task) {
+    hash<string> hashText;
+    size_t h = hashText(task.getTitle());
+    auto mix = [&h](size_t value) {
+        h ^= value + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    };
+    mix(hashText(task.getDescription()));
+    mix(static_cast<size_t>(task.getPriority()));
+    mix(static_cast<size_t>(task.getStatus()));
+    mix(static_cast<size_t>(task.getCreatedAt()));
+    mix(static_cast<size_t>(task.getDueDate()));
+    return h;
+}
+
+bool TaskCache::isModified(const Entry& entry) const {
+    return entry.dirty || fingerprint(entry.task) != entry.cleanHash;
+}
+
+Task* TaskCache::get(int id) {
+    auto it = index.find(id);
+    if (it == index.end()) {
+        stats.misses++;
+        return nullptr;
+    }
+
+    stats.hits++;
+    lru.splice(lru.begin(), lru, it->second);
+    return &it->second->task;
+}
+
+Task* TaskCache::put(const Task& task, bool dirty) {
+    auto it = index.find(task.getId());
+    if (it != index.end()) {
+        usedBytes -= it->second->bytes;
+        lru.erase(it->second);
+        index.erase(it);
+    }
+
+    size_t bytes = estimateSize(task);
+    lru.push_front({task, bytes, fingerprint(task), dirty});
+    index[task.getId()] = lru.begin();
+    usedBytes += bytes;
+
+    evictIfNeeded();
+    return &lru.front().task;
+}
+
+void TaskCache::evictIfNeeded() {
+    // Always keep the entry just inserted, even if it alone exceeds the budget
+    while (usedBytes > capacityBytes && lru.size() > 1) {
+        Entry& victim = lru.back();
+        if (writeBackHandler && isModified(victim)) {
+            if (!writeBackHandler(victim.task)) {
+                break;
+            }
+            stats.writeBacks++;
+        }
+        usedBytes -= victim.bytes;
+        index.erase(victim.task.getId());
+        lru.pop_back();
+        stats.evictions++;
+    }
+}
+
+bool TaskCache::erase(int id) {
+    auto it = index.find(id);
+    if (it == index.end()) {
+        return false;
+    }
+
+    usedBytes -= it->second->bytes;
+    lru.erase(it->second);
+    index.erase(it);
+    return true;
+}
+
+void TaskCache::clear() {
+    lru.clear();
+    index.clear();
+    usedBytes = 0;
+}
+
+vector<Task> TaskCache::collectModified() {
+    vector<Task> modified;
+    for (const auto& entry : lru) {
+        if (isModified(entry)) {
+            modified.push_back(entry.task);
+        }
+    }
+    return modified;
+}
+
+void TaskCache::markClean(const vector<Task>& persisted) {
+    for (const auto& task : persisted) {
+        auto it = index.find(task.getId());
+        size_t persistedHash = fingerprint(task);
+        // An entry edited again since it was collected stays modified
+        if (it == index.end() || fingerprint(it->second->task) != persistedHash) {
+            continue;
+        }
+        Entry& entry = *it->second;
+        entry.cleanHash = persistedHash;
+        entry.dirty = false;
+
+        // Text edits change the footprint
+        size_t bytes = estimateSize(entry.task);
+        usedBytes = usedBytes - entry.bytes + bytes;
+        entry.bytes = bytes;
+    }
+}
+
+TaskCache::Stats TaskCache::getStats() const {
+    Stats current = stats;
+    current.entries = lru.size();
+    current.bytes = usedBytes;
+    return current;
+}
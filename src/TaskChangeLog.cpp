@@ -0,0 +1,138 @@
+#include "TaskChangeLog.hpp"
+#include "TaskJsonCache.hpp"
+#include <algorithm>
+#include <map>
+
+TaskChangeLog::TaskChangeLog(size_t capacity)
+    : capacity(max<size_t>(capacity, 1)), latestSeq(0), droppedSeq(0),
+      epoch(chrono::duration_cast<chrono::microseconds>(
+          chrono::system_clock::now().time_since_epoch()).count()) {}
+
+string TaskChangeLog::render(uint64_t seq, const TaskChange& change) {
+    string json = "{\"seq\":" + to_string(seq);
+    switch (change.kind) {
+        case TaskChange::Kind::UPSERT: {
+            time_t validUntil = 0;
+            json += ",\"type\":\"upsert\",\"id\":" + to_string(change.id);
+            if (change.task) {
+                json += ",\"task\":" + TaskJsonCache::toJson(*change.task, time(nullptr), validUntil);
+            }
+            break;
+        }
+        case TaskChange::Kind::DELETE:
+            json += ",\"type\":\"delete\",\"id\":" + to_string(change.id);
+            break;
+        case TaskChange::Kind::RELOAD:
+        default:
+            json += ",\"type\":\"reload\"";
+            break;
+    }
+    return json + "}";
+}
+
+void TaskChangeLog::append(uint64_t seq, const TaskChange& change) {
+    // Rendered before taking the lock, so readers never wait on it
+    auto event = make_shared<const Event>(Event{seq, change, render(seq, change)});
+    {
+        lock_guard<mutex> lock(logMutex);
+        events.push_back(event);
+        latestSeq = seq;
+        if (events.size() > capacity) {
+            droppedSeq = events.front()->seq;
+            events.pop_front();
+        }
+    }
+    appended.notify_all();
+}
+
+void TaskChangeLog::append(uint64_t firstSeq, const vector<TaskChange>& changes) {
+    if (changes.empty()) {
+        return;
+    }
+    vector<shared_ptr<const Event>> rendered;
+    rendered.reserve(changes.size());
+    for (size_t i = 0; i < changes.size(); i++) {
+        uint64_t seq = firstSeq + i;
+        rendered.push_back(make_shared<const Event>(Event{seq, changes[i], render(seq, changes[i])}));
+    }
+    {
+        lock_guard<mutex> lock(logMutex);
+        for (auto& event : rendered) {
+            events.push_back(move(event));
+        }
+        latestSeq = firstSeq + changes.size() - 1;
+        while (events.size() > capacity) {
+            droppedSeq = events.front()->seq;
+            events.pop_front();
+        }
+    }
+    appended.notify_all();
+}
+
+bool TaskChangeLog::since(uint64_t after, size_t maxEvents, vector<shared_ptr<const Event>>& out) const {
+    lock_guard<mutex> lock(logMutex);
+    if (after < droppedSeq) {
+        return false;
+    }
+    auto it = upper_bound(events.begin(), events.end(), after,
+                          [](uint64_t seq, const shared_ptr<const Event>& event) {
+        return seq < event->seq;
+    });
+    for (; it != events.end() && out.size() < maxEvents; ++it) {
+        out.push_back(*it);
+    }
+    return true;
+}
+
+bool TaskChangeLog::changesSince(uint64_t after, vector<Task>& changed, vector<int>& deleted,
+                                 uint64_t& upTo) const {
+    // Later events for a task replace earlier ones
+    map<int, const TaskChange*> last;
+    lock_guard<mutex> lock(logMutex);
+    if (after < droppedSeq || after > latestSeq) {
+        return false;
+    }
+    auto it = upper_bound(events.begin(), events.end(), after,
+                          [](uint64_t seq, const shared_ptr<const Event>& event) {
+        return seq < event->seq;
+    });
+    for (; it != events.end(); ++it) {
+        if ((*it)->change.kind == TaskChange::Kind::RELOAD) {
+            return false;
+        }
+        last[(*it)->change.id] = &(*it)->change;
+    }
+    
+    for (const auto& entry : last) {
+        if (entry.second->kind == TaskChange::Kind::UPSERT && entry.second->task) {
+            changed.push_back(*entry.second->task);
+        } else {
+            deleted.push_back(entry.first);
+        }
+    }
+    upTo = latestSeq;
+    return true;
+}
+
+void TaskChangeLog::setCapacity(size_t count) {
+    lock_guard<mutex> lock(logMutex);
+    capacity = max<size_t>(count, 1);
+    while (events.size() > capacity) {
+        droppedSeq = events.front()->seq;
+        events.pop_front();
+    }
+}
+
+bool TaskChangeLog::waitFor(uint64_t after, chrono::milliseconds timeout) const {
+    unique_lock<mutex> lock(logMutex);
+    return appended.wait_for(lock, timeout, [this, after] { return latestSeq > after; });
+}
+
+uint64_t TaskChangeLog::latest() const {
+    lock_guard<mutex> lock(logMutex);
+    return latestSeq;
+}
+
+uint64_t TaskChangeLog::getEpoch() const {
+    return epoch;
+}
@@ -0,0 +1,161 @@
+#include "TaskCommandQueue.hpp"
+#include <algorithm>
+#include <vector>
+
+TaskCommandQueue::TaskCommandQueue(TaskManager& target, size_t batchLimit)
+    : manager(target), maxBatch(max<size_t>(batchLimit, 1)), depth(0), running(true),
+      submitted(0), maxDepth(0), totalQueueWaitMicros(0), totalBatchMicros(0) {
+    Node* stub = new Node();
+    head = stub;
+    tail = stub;
+    writer = thread(&TaskCommandQueue::run, this);
+}
+
+TaskCommandQueue::~TaskCommandQueue() {
+    stop();
+    delete tail;
+}
+
+void TaskCommandQueue::push(Command command) {
+    // Counting the command before checking running means stop(), which
+    // clears running before it drains, either waits for this node or this
+    // call sees running cleared and applies the command itself
+    uint64_t queued = depth.fetch_add(1) + 1;
+    if (!running) {
+        depth--;
+        // Stopped: apply on the caller's thread, which saves as usual
+        command.apply(manager);
+        command.complete();
+        return;
+    }
+
+    Node* node = new Node();
+    node->command = move(command);
+    Node* previous = head.exchange(node, memory_order_acq_rel);
+    previous->next.store(node, memory_order_release);
+
+    submitted.fetch_add(1, memory_order_relaxed);
+    uint64_t seen = maxDepth.load(memory_order_relaxed);
+    while (queued > seen && !maxDepth.compare_exchange_weak(seen, queued, memory_order_relaxed)) {
+    }
+
+    // The writer only sleeps on an empty queue, so only the first producer
+    // after that needs to wake it
+    if (queued == 1) {
+        lock_guard<mutex> lock(wakeMutex);
+        wake.notify_one();
+    }
+}
+
+bool TaskCommandQueue::pop(Command& command) {
+    Node* next = tail->next.load(memory_order_acquire);
+    if (!next) {
+        return false;
+    }
+    command = move(next->command);
+    delete tail;
+    tail = next;    // The popped node becomes the new stub
+    return true;
+}
+
+void TaskCommandQueue::run() {
+    vector<Command> batch;
+    batch.reserve(maxBatch);
+
+    while (true) {
+        {
+            unique_lock<mutex> lock(wakeMutex);
+            wake.wait(lock, [this]() { return depth > 0 || !running; });
+        }
+        if (depth == 0 && !running) {
+            break;
+        }
+
+        // A producer may have swapped head but not linked its node yet;
+        // depth counts it, so retry until it appears
+        while (batch.size() < maxBatch && batch.size() < depth) {
+            Command command;
+            if (pop(command)) {
+                batch.push_back(move(command));
+            } else if (batch.empty()) {
+                this_thread::yield();
+            } else {
+                break;
+            }
+        }
+        // Only a producer that then found the queue stopped and took its
+        // count back
+        if (batch.empty()) {
+            continue;
+        }
+
+        auto started = chrono::steady_clock::now();
+        double waitTotal = 0;
+        double waitMax = 0;
+        manager.beginBatch();
+        for (auto& command : batch) {
+            double waited = chrono::duration<double, micro>(started - command.submittedAt).count();
+            waitTotal += waited;
+            waitMax = max(waitMax, waited);
+            command.apply(manager);
+        }
+        manager.endBatch();
+        double batchMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - started).count();
+
+        {
+            lock_guard<mutex> lock(statsMutex);
+            stats.applied += batch.size();
+            stats.batches++;
+            totalQueueWaitMicros += waitTotal;
+            totalBatchMicros += batchMicros;
+            stats.maxQueueWaitMicros = max(stats.maxQueueWaitMicros, waitMax);
+            stats.maxBatchMicros = max(stats.maxBatchMicros, batchMicros);
+        }
+        depth -= batch.size();
+
+        // Futures complete only once the batch is saved
+        for (auto& command : batch) {
+            command.complete();
+        }
+        batch.clear();
+    }
+}
+
+void TaskCommandQueue::stop() {
+    {
+        lock_guard<mutex> lock(wakeMutex);
+        running = false;
+    }
+    wake.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+
+    // Commands pushed while the writer was exiting
+    Command command;
+    while (depth > 0) {
+        if (pop(command)) {
+            command.apply(manager);
+            command.complete();
+            depth--;
+        } else {
+            this_thread::yield();
+        }
+    }
+}
+
+TaskCommandQueue::Stats TaskCommandQueue::getStats() const {
+    lock_guard<mutex> lock(statsMutex);
+    Stats current = stats;
+    current.submitted = submitted;
+    current.maxDepth = maxDepth;
+    current.depth = depth;
+    if (current.applied > 0) {
+        current.avgQueueWaitMicros = totalQueueWaitMicros / current.applied;
+        current.avgBatchSize = static_cast<double>(current.applied) / current.batches;
+    }
+    if (current.batches > 0) {
+        current.avgBatchMicros = totalBatchMicros / current.batches;
+    }
+    return current;
+}
@@ -0,0 +1,130 @@
+#include "TaskIndex.hpp"
+#include <algorithm>
+#include <climits>
+
+TaskIndex::TaskIndex() : keyCount(0) {}
+
+TaskIndex TaskIndex::build(vector<Key> keys) {
+    sort(keys.begin(), keys.end());
+
+    // Half-full blocks leave room for inserts before the first split
+    TaskIndex index;
+    index.keyCount = keys.size();
+    for (size_t i = 0; i < keys.size(); i += BLOCK_SIZE / 2) {
+        size_t end = min(keys.size(), i + BLOCK_SIZE / 2);
+        index.blocks.push_back(make_shared<Block>(keys.begin() + i, keys.begin() + end));
+    }
+    return index;
+}
+
+size_t TaskIndex::blockFor(const Key& key) const {
+    auto it = lower_bound(blocks.begin(), blocks.end(), key,
+                          [](const shared_ptr<const Block>& block, const Key& k) {
+        return block->back() < k;
+    });
+    return it == blocks.end() ? blocks.size() - 1 : it - blocks.begin();
+}
+
+void TaskIndex::insert(const Key& key) {
+    if (blocks.empty()) {
+        blocks.push_back(make_shared<Block>(1, key));
+        keyCount = 1;
+        return;
+    }
+
+    size_t b = blockFor(key);
+    auto block = make_shared<Block>(*blocks[b]);
+    auto it = lower_bound(block->begin(), block->end(), key);
+    if (it != block->end() && *it == key) {
+        return;
+    }
+    block->insert(it, key);
+    keyCount++;
+
+    if (block->size() > BLOCK_SIZE) {
+        auto upper = make_shared<Block>(block->begin() + block->size() / 2, block->end());
+        block->resize(block->size() / 2);
+        blocks.insert(blocks.begin() + b + 1, upper);
+    }
+    blocks[b] = block;
+}
+
+void TaskIndex::erase(const Key& key) {
+    if (blocks.empty()) {
+        return;
+    }
+
+    size_t b = blockFor(key);
+    auto it = lower_bound(blocks[b]->begin(), blocks[b]->end(), key);
+    if (it == blocks[b]->end() || !(*it == key)) {
+        return;
+    }
+
+    auto block = make_shared<Block>(*blocks[b]);
+    block->erase(block->begin() + (it - blocks[b]->begin()));
+    keyCount--;
+    if (block->empty()) {
+        blocks.erase(blocks.begin() + b);
+    } else {
+        blocks[b] = block;
+    }
+}
+
+size_t TaskIndex::size() const {
+    return keyCount;
+}
+
+size_t TaskIndex::count(long long low, long long high) const {
+    if (blocks.empty() || low > high) {
+        return 0;
+    }
+
+    // Blocks wholly inside the range count by size; only the edges are searched
+    const Key first{low, INT_MIN};
+    const Key last{high, INT_MAX};
+    size_t total = 0;
+    for (size_t b = blockFor(first); b < blocks.size(); b++) {
+        const Block& block = *blocks[b];
+        if (last < block.front()) {
+            break;
+        }
+        auto begin = first < block.front() ? block.begin() : lower_bound(block.begin(), block.end(), first);
+        auto end = block.back() < last ? block.end() : upper_bound(block.begin(), block.end(), last);
+        total += end - begin;
+    }
+    return total;
+}
+
+void TaskIndex::scan(const Key& from, bool descending, const function<bool(const Key&)>& onKey) const {
+    if (blocks.empty()) {
+        return;
+    }
+
+    if (!descending) {
+        for (size_t b = blockFor(from); b < blocks.size(); b++) {
+            const Block& block = *blocks[b];
+            for (auto it = lower_bound(block.begin(), block.end(), from); it != block.end(); ++it) {
+                if (!onKey(*it)) {
+                    return;
+                }
+            }
+        }
+        return;
+    }
+
+    // Last block starting at or before `from`
+    auto first = upper_bound(blocks.begin(), blocks.end(), from,
+                             [](const Key& k, const shared_ptr<const Block>& block) {
+        return k < block->front();
+    });
+    for (size_t b = first - blocks.begin(); b-- > 0;) {
+        const Block& block = *blocks[b];
+        auto end = upper_bound(block.begin(), block.end(), from);
+        for (auto it = end; it != block.begin();) {
+            --it;
+            if (!onKey(*it)) {
+                return;
+            }
+        }
+    }
+}
@@ -0,0 +1,202 @@
+#include "TaskJsonCache.hpp"
+#include <sstream>
+
+const TaskJsonCache::FieldMask TaskJsonCache::ALL_FIELDS;
+
+// Quotes, backslashes and control characters are escaped; everything else,
+// including UTF-8, is copied as is
+void TaskJsonCache::appendQuoted(string& out, const string& value) {
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += "\\u00";
+                    out += hex[c >> 4];
+                    out += hex[c & 0xF];
+                } else {
+                    out += c;
+                }
+                break;
+        }
+    }
+    out += '"';
+}
+
+TaskJsonCache::Fragment TaskJsonCache::render(const Task& task, uint64_t revision) {
+    string title;
+    string description;
+    appendQuoted(title, task.getTitle());
+    appendQuoted(description, task.getDescription());
+
+    ostringstream json;
+    json << "{";
+    json << "\"id\":" << task.getId() << ",";
+    json << "\"title\":" << title << ",";
+    json << "\"description\":" << description << ",";
+    json << "\"priority\":\"" << task.getPriorityString() << "\",";
+    json << "\"status\":\"" << task.getStatusString() << "\",";
+    json << "\"createdAt\":" << task.getCreatedAt() << ",";
+    json << "\"dueDate\":" << task.getDueDate() << ",";
+    json << "\"isCompleted\":" << (task.isCompleted() ? "true" : "false");
+    return {revision, json.str(), task.getDueDate(), task.isCompleted()};
+}
+
+// Same rule as Task::isOverdue(), evaluated at `now`
+bool TaskJsonCache::isOverdueAt(time_t dueDate, bool completed, time_t now, time_t& validUntil) {
+    bool pending = dueDate > 0 && !completed;
+    if (pending && dueDate >= now) {
+        time_t flips = dueDate + 1;
+        if (validUntil == 0 || flips < validUntil) {
+            validUntil = flips;
+        }
+    }
+    return pending && now > dueDate;
+}
+
+void TaskJsonCache::appendOverdue(string& out, const Fragment& fragment, time_t now, time_t& validUntil) {
+    bool overdue = isOverdueAt(fragment.dueDate, fragment.completed, now, validUntil);
+    out += overdue ? ",\"isOverdue\":true}" : ",\"isOverdue\":false}";
+}
+
+// Same layout as render() + appendOverdue(), minus the fields not in the mask
+void TaskJsonCache::appendProjected(string& out, const Task& task, FieldMask fields, time_t now, time_t& validUntil) {
+    char separator = '{';
+    auto member = [&out, &separator](const char* name) {
+        out += separator;
+        out += '"';
+        out += name;
+        out += "\":";
+        separator = ',';
+    };
+    auto quoted = [&out](const string& value) { appendQuoted(out, value); };
+
+    if (fields & FIELD_ID) { member("id"); out += to_string(task.getId()); }
+    if (fields & FIELD_TITLE) { member("title"); quoted(task.getTitle()); }
+    if (fields & FIELD_DESCRIPTION) { member("description"); quoted(task.getDescription()); }
+    if (fields & FIELD_PRIORITY) { member("priority"); quoted(task.getPriorityString()); }
+    if (fields & FIELD_STATUS) { member("status"); quoted(task.getStatusString()); }
+    if (fields & FIELD_CREATED_AT) { member("createdAt"); out += to_string(task.getCreatedAt()); }
+    if (fields & FIELD_DUE_DATE) { member("dueDate"); out += to_string(task.getDueDate()); }
+    if (fields & FIELD_IS_COMPLETED) { member("isCompleted"); out += task.isCompleted() ? "true" : "false"; }
+    if (fields & FIELD_IS_OVERDUE) {
+        member("isOverdue");
+        out += isOverdueAt(task.getDueDate(), task.isCompleted(), now, validUntil) ? "true" : "false";
+    }
+    out += separator == '{' ? "{}" : "}";
+}
+
+bool TaskJsonCache::parseFields(const string& list, FieldMask& fields) {
+    static const pair<const char*, Field> names[] = {
+        {"id", FIELD_ID}, {"title", FIELD_TITLE}, {"description", FIELD_DESCRIPTION},
+        {"priority", FIELD_PRIORITY}, {"status", FIELD_STATUS}, {"createdAt", FIELD_CREATED_AT},
+        {"dueDate", FIELD_DUE_DATE}, {"isCompleted", FIELD_IS_COMPLETED}, {"isOverdue", FIELD_IS_OVERDUE}
+    };
+
+    fields = 0;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == string::npos) end = list.size();
+        string name = list.substr(start, end - start);
+        start = end + 1;
+
+        bool known = false;
+        for (const auto& [fieldName, field] : names) {
+            if (name == fieldName) {
+                fields |= field;
+                known = true;
+            }
+        }
+        if (!known) {
+            return false;
+        }
+    }
+    return fields != 0;
+}
+
+string TaskJsonCache::toJson(const Task& task, time_t now, time_t& validUntil, FieldMask fields) {
+    string out;
+    if (fields != ALL_FIELDS) {
+        appendProjected(out, task, fields, now, validUntil);
+        return out;
+    }
+    Fragment fragment = render(task, 0);
+    out = fragment.json;
+    appendOverdue(out, fragment, now, validUntil);
+    return out;
+}
+
+string TaskJsonCache::toJson(const vector<Task>& tasks, time_t now, time_t& validUntil, FieldMask fields) {
+    string out = "[";
+    for (size_t i = 0; i < tasks.size(); i++) {
+        if (i > 0) out += ",";
+        if (fields != ALL_FIELDS) {
+            appendProjected(out, tasks[i], fields, now, validUntil);
+            continue;
+        }
+        Fragment fragment = render(tasks[i], 0);
+        out += fragment.json;
+        appendOverdue(out, fragment, now, validUntil);
+    }
+    out += "]";
+    return out;
+}
+
+string TaskJsonCache::toJson(const TaskSnapshot& snapshot, time_t now, time_t& validUntil, FieldMask fields) {
+    if (fields != ALL_FIELDS) {
+        // Projections are cheap to write, so they bypass the fragments
+        string out = "[";
+        snapshot.forEach([&](const Task& task) {
+            if (out.size() > 1) out += ",";
+            appendProjected(out, task, fields, now, validUntil);
+            return true;
+        });
+        out += "]";
+        return out;
+    }
+
+    lock_guard<mutex> lock(cacheMutex);
+
+    string out;
+    out.reserve(snapshot.size() * 180 + 2);
+    out += "[";
+    bool first = true;
+    snapshot.forEachRevision([&](const Task& task, uint64_t revision) {
+        auto it = fragments.find(task.getId());
+        if (it == fragments.end() || it->second.revision != revision) {
+            stats.misses++;
+            it = fragments.insert_or_assign(task.getId(), render(task, revision)).first;
+        } else {
+            stats.hits++;
+        }
+
+        if (!first) out += ",";
+        out += it->second.json;
+        appendOverdue(out, it->second, now, validUntil);
+        first = false;
+        return true;
+    });
+    out += "]";
+
+    // Drop fragments of deleted tasks once they pile up
+    if (fragments.size() > snapshot.size() + TaskSnapshot::CHUNK_SIZE) {
+        for (auto it = fragments.begin(); it != fragments.end();) {
+            it = snapshot.find(it->first) ? next(it) : fragments.erase(it);
+        }
+    }
+    return out;
+}
+
+TaskJsonCache::Stats TaskJsonCache::getStats() const {
+    lock_guard<mutex> lock(cacheMutex);
+    Stats current = stats;
+    current.entries = fragments.size();
+    return current;
+}
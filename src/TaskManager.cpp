@@ -1,20 +1,87 @@
 #include "TaskManager.hpp"
 #include "ColorUtils.hpp"
+#include "SQLiteConnectionPool.hpp"
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
+#include <mutex>
+#include <unordered_map>
 
 // Constructor
-TaskManager::TaskManager() : nextId(1), fileHandler("../data/tasks.json") {
+TaskManager::TaskManager()
+    : nextId(1), fileHandler("../data/tasks.json"), store(nullptr), writeBack(false),
+      deferSaves(false), pendingSave(false),
+      snapshot(make_shared<TaskSnapshot>()), version(0) {
     loadFromFile();
 }
 
-void TaskManager::autoSave() {
-    saveToFile();
+TaskManager::TaskManager(const ExternalStore& externalStore)
+    : nextId(1), fileHandler("../data/tasks.json"), store(nullptr), writeBack(false),
+      deferSaves(false), pendingSave(false), external(externalStore),
+      snapshot(make_shared<TaskSnapshot>()), version(0) {
+    loadFromFile();
+}
+
+TaskManager::TaskManager(SQLiteConnectionPool& pool, size_t cacheBudgetBytes, bool writeBackCache)
+    : nextId(1), fileHandler("../data/tasks.json"), store(&pool),
+      cache(new TaskCache(cacheBudgetBytes)), writeBack(writeBackCache),
+      deferSaves(false), pendingSave(false), version(0) {
+    cache->setWriteBackHandler([this](const Task& task) { return persistTask(task); });
+}
+
+TaskManager::~TaskManager() {
+    if (store && !flushCache()) {
+        cerr << "⚠️  Unsaved task changes were lost at shutdown" << endl;
+    }
+}
+
+void TaskManager::markChanged(int id) {
+    if (external.save) {
+        dirtyIds.insert(id);
+    }
+}
+
+void TaskManager::autoSave(int changedId) {
+    // Write-back caches defer persistence to saveToFile() and eviction
+    if (store && writeBack) {
+        return;
+    }
+    if (changedId >= 0) {
+        markChanged(changedId);
+    }
+    if (deferSaves) {
+        pendingSave = true;
+        return;
+    }
+    saveLocked();
 }
 
 bool TaskManager::loadFromFile() {
-    bool success = fileHandler.loadTasks(tasks, nextId);
+    unique_lock<shared_mutex> lock(stateMutex);
+    if (store) {
+        // The store is authoritative; drop anything cached
+        cache->clear();
+        return true;
+    }
+    
+    bool success;
+    if (external.load) {
+        // Pending writes are saved first so the reloaded list still has
+        // them. A failed save or load keeps serving the current list, and a
+        // later save still sends the dirty ids.
+        vector<Task> loaded;
+        int loadedNextId = nextId;
+        if (!saveLocked() || !external.load(loaded, loadedNextId)) {
+            cerr << "Reload failed; keeping " << tasks.size() << " task(s) in memory" << endl;
+            return false;
+        }
+        swap(tasks, loaded);
+        nextId = loadedNextId;
+        success = true;
+    } else {
+        success = fileHandler.loadTasks(tasks, nextId);
+    }
+    publishAll();
     if (success && !tasks.empty()) {
         cout << "✓ Loaded " << tasks.size() << " task(s) from file." << endl;
     }
@@ -22,33 +89,235 @@ bool TaskManager::loadFromFile() {
 }
 
 bool TaskManager::saveToFile() {
+    unique_lock<shared_mutex> lock(stateMutex);
+    // Callers may have edited any task through findTaskById() pointers
+    for (const auto& task : tasks) {
+        markChanged(task.getId());
+    }
+    bool saved = saveLocked();
+    publishAll();
+    return saved;
+}
+
+void TaskManager::beginBatch() {
+    unique_lock<shared_mutex> lock(stateMutex);
+    deferSaves = true;
+}
+
+bool TaskManager::endBatch() {
+    unique_lock<shared_mutex> lock(stateMutex);
+    deferSaves = false;
+    if (!pendingSave) {
+        return true;
+    }
+    pendingSave = false;
+    return saveLocked();
+}
+
+bool TaskManager::saveLocked() {
+    if (store) {
+        return flushCache();
+    }
+    if (external.save) {
+        if (dirtyIds.empty()) {
+            return true;
+        }
+        
+        // Dirty ids still in the list were written; the rest were deleted.
+        // They stay dirty until a save succeeds.
+        vector<Task> written;
+        unordered_set<int> missing = dirtyIds;
+        for (const auto& task : tasks) {
+            if (missing.erase(task.getId())) {
+                written.push_back(task);
+            }
+        }
+        vector<int> deleted(missing.begin(), missing.end());
+        sort(deleted.begin(), deleted.end());
+        if (!external.save(written, deleted, nextId)) {
+            return false;
+        }
+        dirtyIds.clear();
+        return true;
+    }
     return fileHandler.saveTasks(tasks, nextId);
 }
 
+bool TaskManager::isStoreBacked() const {
+    return store != nullptr;
+}
+
+// Only the chunk holding the task is copied; the rest is shared. The version
+// moves only once the snapshot is out, so a reader that sees the new version
+// also sees the new tasks
+void TaskManager::publishTask(const Task& task) {
+    uint64_t next = version + 1;
+    if (!store) {
+        atomic_store(&snapshot, snapshot->withTask(task, next));
+    }
+    version = next;
+    changeLog.append(next, TaskChange{TaskChange::Kind::UPSERT, task.getId(), task});
+}
+
+void TaskManager::publishErase(int id) {
+    uint64_t next = version + 1;
+    if (!store) {
+        atomic_store(&snapshot, snapshot->withoutTask(id, next));
+    }
+    version = next;
+    changeLog.append(next, TaskChange{TaskChange::Kind::DELETE, id, nullopt});
+}
+
+void TaskManager::publishAll() {
+    uint64_t next = version + 1;
+    if (!store) {
+        atomic_store(&snapshot, TaskSnapshot::build(tasks, next));
+    }
+    version = next;
+    changeLog.append(next, TaskChange());
+}
+
+// A batch becomes visible at once: one snapshot holding every change, then
+// its events as one block of the change log. Each change still gets a version.
+void TaskManager::publishChanges(const vector<TaskChange>& changes) {
+    if (changes.empty()) {
+        return;
+    }
+    uint64_t first = version + 1;
+    uint64_t last = version + changes.size();
+    if (!store) {
+        shared_ptr<const TaskSnapshot> next;
+        if (changes.size() * TaskSnapshot::CHUNK_SIZE > tasks.size()) {
+            // Cheaper than copying a chunk per change
+            next = TaskSnapshot::build(tasks, last);
+        } else {
+            next = snapshot;
+            for (const auto& change : changes) {
+                next = change.kind == TaskChange::Kind::UPSERT ? next->withTask(*change.task, last)
+                                                               : next->withoutTask(change.id, last);
+            }
+        }
+        atomic_store(&snapshot, next);
+    }
+    version = last;
+    changeLog.append(first, changes);
+}
+
+shared_ptr<const TaskSnapshot> TaskManager::getSnapshot() const {
+    return store ? nullptr : atomic_load(&snapshot);
+}
+
+uint64_t TaskManager::getVersion() const {
+    return version.load();
+}
+
+const TaskChangeLog& TaskManager::getChangeLog() const {
+    return changeLog;
+}
+
+void TaskManager::setChangeLogCapacity(size_t events) {
+    changeLog.setCapacity(events);
+}
+
+TaskCache::Stats TaskManager::getCacheStats() const {
+    shared_lock<shared_mutex> lock(stateMutex);
+    return cache ? cache->getStats() : TaskCache::Stats();
+}
+
+bool TaskManager::persistTask(const Task& task) {
+    auto writer = store->acquireWriter();
+    if (writer->updateTask(task)) {
+        return true;
+    }
+    cerr << "⚠️  Write-back of task " << task.getId() << " failed; keeping it cached" << endl;
+    return false;
+}
+
+// Writes every cached task changed since it was loaded, in one transaction
+bool TaskManager::flushCache() {
+    vector<Task> modified = cache->collectModified();
+    if (modified.empty()) {
+        return true;
+    }
+    
+    auto writer = store->acquireWriter();
+    if (!writer->beginTransaction()) {
+        return false;
+    }
+    for (const auto& task : modified) {
+        if (!writer->updateTask(task)) {
+            writer->rollbackTransaction();
+            return false;
+        }
+    }
+    // Entries stay modified, and are retried, until the commit succeeds
+    if (!writer->commitTransaction()) {
+        writer->rollbackTransaction();
+        return false;
+    }
+    cache->markClean(modified);
+    return true;
+}
+
+bool TaskManager::applyChange(const TaskChange& change) {
+    unique_lock<shared_mutex> lock(stateMutex);
+    if (store) {
+        // The store already has the write; only the cache can be stale.
+        // Refresh entries that are cached and leave the rest to read-through.
+        if (change.kind == TaskChange::Kind::RELOAD) {
+            cache->clear();
+        } else if (cache->erase(change.id) && change.kind == TaskChange::Kind::UPSERT && change.task) {
+            cache->put(*change.task);
+        }
+        changeLog.append(++version, change);
+        return true;
+    }
+    
+    // JSON mode holds the full list, so a reload cannot be patched in place
+    if (change.kind == TaskChange::Kind::RELOAD) {
+        return false;
+    }
+    
+    auto it = find_if(tasks.begin(), tasks.end(),
+                     [&change](const Task& task) { return task.getId() == change.id; });
+    if (change.kind == TaskChange::Kind::DELETE || !change.task) {
+        if (it != tasks.end()) {
+            tasks.erase(it);
+            publishErase(change.id);
+        }
+        return true;
+    }
+    
+    if (it != tasks.end()) {
+        *it = *change.task;
+    } else {
+        tasks.push_back(*change.task);
+    }
+    nextId = max(nextId, change.id + 1);
+    publishTask(*change.task);
+    return true;
+}
+
 bool TaskManager::exportToCSV(const string& filename) {
+    vector<Task> all = snapshotTasks();
+    
     CSVExporter exporter;
-    return exporter.exportToCSV(tasks, filename);
+    return exporter.exportToCSV(all, filename);
 }
 
 bool TaskManager::exportFilteredToCSV(Status status, const string& filename) {
-    vector<Task> filtered;
-    for (const auto& task : tasks) {
-        if (task.getStatus() == status) {
-            filtered.push_back(task);
-        }
-    }
+    TaskQuery query;
+    query.status = status;
+    vector<Task> filtered = queryTasks(query);
     
     CSVExporter exporter;
     return exporter.exportToCSV(filtered, filename);
 }
 
 bool TaskManager::exportFilteredToCSV(Priority priority, const string& filename) {
-    vector<Task> filtered;
-    for (const auto& task : tasks) {
-        if (task.getPriority() == priority) {
-            filtered.push_back(task);
-        }
-    }
+    TaskQuery query;
+    query.priority = priority;
+    vector<Task> filtered = queryTasks(query);
     
     CSVExporter exporter;
     return exporter.exportToCSV(filtered, filename);
@@ -56,22 +325,330 @@ bool TaskManager::exportFilteredToCSV(Priority priority, const string& filename)
 
 int TaskManager::addTask(const string& title, const string& description, 
                          Priority priority) {
+    unique_lock<shared_mutex> lock(stateMutex);
+    if (store) {
+        Task newTask(0, title, description, priority);
+        int id;
+        {
+            auto writer = store->acquireWriter();
+            id = writer->insertTask(newTask);
+        }
+        if (id < 0) {
+            return -1;
+        }
+        
+        Task stored(id, title, description, priority);
+        stored.setCreatedAt(newTask.getCreatedAt());
+        cache->put(stored);
+        publishTask(stored);
+        return id;
+    }
+    
     Task newTask(nextId, title, description, priority);
     tasks.push_back(newTask);
     int id = nextId++;
-    autoSave();
+    autoSave(id);
+    publishTask(newTask);
     return id;
 }
 
 vector<Task>& TaskManager::getAllTasks() {
+    unique_lock<shared_mutex> lock(stateMutex);
+    if (store) {
+        flushCache();
+        auto reader = store->acquireReader();
+        tasks = reader->getAllTasks();
+    }
     return tasks;
 }
 
 int TaskManager::getTaskCount() const {
-    return tasks.size();
+    if (store) {
+        auto reader = store->acquireReader();
+        return reader->countTasks(TaskQuery());
+    }
+    return atomic_load(&snapshot)->size();
+}
+
+vector<Task> TaskManager::snapshotTasks() {
+    if (store) {
+        {
+            unique_lock<shared_mutex> lock(stateMutex);
+            flushCache();
+        }
+        auto reader = store->acquireReader();
+        return reader->getAllTasks();
+    }
+    
+    shared_ptr<const TaskSnapshot> current = atomic_load(&snapshot);
+    vector<Task> all;
+    all.reserve(current->size());
+    current->forEach([&all](const Task& task) {
+        all.push_back(task);
+        return true;
+    });
+    return all;
+}
+
+vector<Task> TaskManager::queryTasks(const TaskQuery& query) {
+    if (store) {
+        // Pending write-back changes must be visible to the SQL filter
+        {
+            unique_lock<shared_mutex> lock(stateMutex);
+            flushCache();
+        }
+        auto reader = store->acquireReader();
+        return reader->queryTasks(query);
+    }
+    
+    return atomic_load(&snapshot)->query(query);
+}
+
+int TaskManager::countTasks(const TaskQuery& query) {
+    if (store) {
+        {
+            unique_lock<shared_mutex> lock(stateMutex);
+            flushCache();
+        }
+        auto reader = store->acquireReader();
+        return reader->countTasks(query);
+    }
+    
+    return static_cast<int>(atomic_load(&snapshot)->count(query));
 }
 
 Task* TaskManager::findTaskById(int id) {
+    unique_lock<shared_mutex> lock(stateMutex);
+    return findLocked(id);
+}
+
+optional<Task> TaskManager::getTask(int id) {
+    if (store) {
+        // Read-through fills the cache, so even lookups need the write lock
+        unique_lock<shared_mutex> lock(stateMutex);
+        Task* task = findLocked(id);
+        return task ? optional<Task>(*task) : nullopt;
+    }
+    
+    shared_ptr<const TaskSnapshot> current = atomic_load(&snapshot);
+    const Task* task = current->find(id);
+    return task ? optional<Task>(*task) : nullopt;
+}
+
+optional<Task> TaskManager::updateTask(int id, const function<void(Task&)>& edit) {
+    unique_lock<shared_mutex> lock(stateMutex);
+    Task* task = findLocked(id);
+    if (!task) {
+        return nullopt;
+    }
+    edit(*task);
+    Task updated = *task;
+    autoSave(id);
+    publishTask(updated);
+    return updated;
+}
+
+bool TaskManager::applyBatch(const vector<BatchStep>& steps, vector<optional<Task>>& results,
+                             int& failedStep) {
+    unique_lock<shared_mutex> lock(stateMutex);
+    results.assign(steps.size(), nullopt);
+    failedStep = -1;
+    vector<TaskChange> changes;
+    
+    if (store) {
+        // Flushed first, so the steps read current rows and a rollback leaves
+        // the cache matching the store
+        if (!flushCache()) {
+            return false;
+        }
+        {
+            auto writer = store->acquireWriter();
+            if (!writer->beginTransaction()) {
+                return false;
+            }
+            for (size_t i = 0; i < steps.size(); i++) {
+                const BatchStep& step = steps[i];
+                if (step.kind == BatchStep::Kind::CREATE) {
+                    Task added(0, step.title, step.description, step.priority);
+                    int id = writer->insertTask(added);
+                    if (id < 0) {
+                        writer->rollbackTransaction();
+                        results.assign(steps.size(), nullopt);
+                        return false;
+                    }
+                    Task stored(id, step.title, step.description, step.priority);
+                    stored.setCreatedAt(added.getCreatedAt());
+                    results[i] = stored;
+                    changes.push_back(TaskChange{TaskChange::Kind::UPSERT, id, stored});
+                    continue;
+                }
+                
+                optional<Task> task = writer->getTaskById(step.id);
+                bool written = true;
+                if (task && step.kind == BatchStep::Kind::EDIT) {
+                    step.edit(*task);
+                    written = writer->updateTask(*task);
+                    changes.push_back(TaskChange{TaskChange::Kind::UPSERT, step.id, task});
+                } else if (task && step.kind == BatchStep::Kind::REMOVE) {
+                    written = writer->deleteTask(step.id);
+                    changes.push_back(TaskChange{TaskChange::Kind::DELETE, step.id, nullopt});
+                    task.reset();
+                } else if (!task) {
+                    failedStep = static_cast<int>(i);
+                    written = false;
+                }
+                if (!written) {
+                    writer->rollbackTransaction();
+                    results.assign(steps.size(), nullopt);
+                    return false;
+                }
+                results[i] = task;
+            }
+            if (!writer->commitTransaction()) {
+                writer->rollbackTransaction();
+                results.assign(steps.size(), nullopt);
+                return false;
+            }
+        }
+        for (const auto& change : changes) {
+            cache->erase(change.id);
+            if (change.task) {
+                cache->put(*change.task);
+            }
+        }
+        publishChanges(changes);
+        return true;
+    }
+    
+    // Steps edit the list in place. Each pre-existing task keeps its state
+    // from before its first edit or removal, and created tasks are appended,
+    // so a failure restores only what the batch touched.
+    const size_t originalSize = tasks.size();
+    const int originalNextId = nextId;
+    unordered_map<size_t, Task> priors;     // Original position -> prior task
+    unordered_set<size_t> removed;          // Positions removed by the batch
+    unordered_map<int, size_t> positions;   // Only the ids the steps name
+    for (const auto& step : steps) {
+        if (step.kind != BatchStep::Kind::CREATE) {
+            positions.emplace(step.id, originalSize);
+        }
+    }
+    for (size_t i = 0; i < originalSize && !positions.empty(); i++) {
+        auto it = positions.find(tasks[i].getId());
+        if (it != positions.end()) {
+            it->second = i;
+        }
+    }
+    for (auto it = positions.begin(); it != positions.end();) {
+        it = it->second == originalSize ? positions.erase(it) : next(it);
+    }
+    
+    // Before compaction every original task is still at its position
+    auto rollback = [&](bool compacted) {
+        if (!compacted) {
+            for (auto& prior : priors) {
+                tasks[prior.first] = move(prior.second);
+            }
+            tasks.erase(tasks.begin() + originalSize, tasks.end());
+        } else {
+            vector<Task> restored;
+            restored.reserve(originalSize);
+            size_t kept = 0;
+            for (size_t i = 0; i < originalSize; i++) {
+                auto prior = priors.find(i);
+                if (removed.count(i)) {
+                    restored.push_back(move(prior->second));
+                } else {
+                    Task& current = tasks[kept++];
+                    restored.push_back(prior != priors.end() ? move(prior->second) : move(current));
+                }
+            }
+            swap(tasks, restored);
+        }
+        nextId = originalNextId;
+        results.assign(steps.size(), nullopt);
+    };
+    auto remember = [&](size_t position) {
+        if (position < originalSize && !priors.count(position)) {
+            priors.emplace(position, tasks[position]);
+        }
+    };
+    
+    for (size_t i = 0; i < steps.size(); i++) {
+        const BatchStep& step = steps[i];
+        if (step.kind == BatchStep::Kind::CREATE) {
+            Task added(nextId++, step.title, step.description, step.priority);
+            positions[added.getId()] = tasks.size();
+            tasks.push_back(added);
+            results[i] = added;
+            changes.push_back(TaskChange{TaskChange::Kind::UPSERT, added.getId(), added});
+            continue;
+        }
+        
+        auto found = positions.find(step.id);
+        if (found == positions.end()) {
+            rollback(false);
+            failedStep = static_cast<int>(i);
+            return false;
+        }
+        size_t position = found->second;
+        if (step.kind == BatchStep::Kind::REMOVE) {
+            remember(position);
+            removed.insert(position);
+            positions.erase(found);
+            changes.push_back(TaskChange{TaskChange::Kind::DELETE, step.id, nullopt});
+            continue;
+        }
+        if (step.kind == BatchStep::Kind::EDIT) {
+            remember(position);
+            step.edit(tasks[position]);
+            changes.push_back(TaskChange{TaskChange::Kind::UPSERT, step.id, tasks[position]});
+        }
+        results[i] = tasks[position];
+    }
+    if (changes.empty()) {
+        return true;
+    }
+    
+    if (!removed.empty()) {
+        size_t kept = *min_element(removed.begin(), removed.end());
+        for (size_t i = kept; i < tasks.size(); i++) {
+            if (!removed.count(i)) {
+                tasks[kept++] = move(tasks[i]);
+            }
+        }
+        tasks.erase(tasks.begin() + kept, tasks.end());
+    }
+    
+    // Saved right away even inside a group commit, so a failed save can still
+    // be undone; the file then holds the earlier writes of the group too
+    for (const auto& change : changes) {
+        markChanged(change.id);
+    }
+    if (!saveLocked()) {
+        rollback(true);
+        return false;
+    }
+    pendingSave = false;
+    publishChanges(changes);
+    return true;
+}
+
+Task* TaskManager::findLocked(int id) {
+    if (store) {
+        Task* cached = cache->get(id);
+        if (cached) {
+            return cached;
+        }
+        
+        optional<Task> loaded;
+        {
+            auto reader = store->acquireReader();
+            loaded = reader->getTaskById(id);
+        }
+        return loaded ? cache->put(*loaded) : nullptr;
+    }
+    
     for (auto& task : tasks) {
         if (task.getId() == id) {
             return &task;
@@ -81,18 +658,37 @@ Task* TaskManager::findTaskById(int id) {
 }
 
 bool TaskManager::deleteTask(int id) {
+    unique_lock<shared_mutex> lock(stateMutex);
+    if (store) {
+        if (!findLocked(id)) {
+            return false;
+        }
+        bool deleted;
+        {
+            auto writer = store->acquireWriter();
+            deleted = writer->deleteTask(id);
+        }
+        if (deleted) {
+            cache->erase(id);
+            publishErase(id);
+        }
+        return deleted;
+    }
+    
     auto it = find_if(tasks.begin(), tasks.end(),
                      [id](const Task& task) { return task.getId() == id; });
     
     if (it != tasks.end()) {
         tasks.erase(it);
-        autoSave();
+        autoSave(id);
+        publishErase(id);
         return true;
     }
     return false;
 }
 
 void TaskManager::displayAllTasks() const {
+    shared_lock<shared_mutex> lock(stateMutex);
     if (tasks.empty()) {
         cout << "\nNo tasks found! Add your first task to get started." << endl;
         return;
@@ -108,6 +704,7 @@ void TaskManager::displayAllTasks() const {
 }
 
 void TaskManager::displayTasksByStatus(Status status) const {
+    shared_lock<shared_mutex> lock(stateMutex);
     bool found = false;
     
     cout << "\n========================================" << endl;
@@ -134,6 +731,7 @@ void TaskManager::displayTasksByStatus(Status status) const {
 }
 
 void TaskManager::displayTasksByPriority(Priority priority) const {
+    shared_lock<shared_mutex> lock(stateMutex);
     bool found = false;
     
     cout << "\n========================================" << endl;
@@ -160,6 +758,7 @@ void TaskManager::displayTasksByPriority(Priority priority) const {
 }
 
 void TaskManager::displayStatistics() const {
+    shared_lock<shared_mutex> lock(stateMutex);
     int pending = 0, inProgress = 0, completed = 0;
     int lowPriority = 0, mediumPriority = 0, highPriority = 0;
 
@@ -193,6 +792,7 @@ void TaskManager::displayStatistics() const {
 }
 
 void TaskManager::displayEnhancedStatistics() const {
+    shared_lock<shared_mutex> lock(stateMutex);
     if (tasks.empty()) {
         cout << "\nNo tasks available! Add tasks to see statistics." << endl;
         return;
@@ -327,20 +927,26 @@ void TaskManager::displayEnhancedStatistics() const {
 }
 
 bool TaskManager::markTaskComplete(int id) {
-    Task* task = findTaskById(id);
+    unique_lock<shared_mutex> lock(stateMutex);
+    Task* task = findLocked(id);
     if (task != nullptr) {
         task->markComplete();
-        autoSave();
+        autoSave(id);
+        publishTask(*task);
         return true;
     }
     return false;
 }
 
 bool TaskManager::hasTasks() const {
-    return !tasks.empty();
+    if (store) {
+        return getTaskCount() > 0;
+    }
+    return atomic_load(&snapshot)->size() > 0;
 }
 
 void TaskManager::searchTasks(const string& keyword) const {
+    shared_lock<shared_mutex> lock(stateMutex);
     if (tasks.empty()) {
         cout << "\nNo tasks available to search!" << endl;
         return;
@@ -381,6 +987,7 @@ void TaskManager::searchTasks(const string& keyword) const {
 }
 
 void TaskManager::displayOverdueTasks() const {
+    shared_lock<shared_mutex> lock(stateMutex);
     bool found = false;
     
     cout << "\n========================================" << endl;
@@ -400,6 +1007,7 @@ void TaskManager::displayOverdueTasks() const {
 }
 
 void TaskManager::sortByPriority(bool highToLow) {
+    unique_lock<shared_mutex> lock(stateMutex);
     sort(tasks.begin(), tasks.end(), [highToLow](const Task& a, const Task& b) {
         if (highToLow) {
             return static_cast<int>(a.getPriority()) > static_cast<int>(b.getPriority());
@@ -410,6 +1018,7 @@ void TaskManager::sortByPriority(bool highToLow) {
 }
 
 void TaskManager::sortByDueDate(bool soonestFirst) {
+    unique_lock<shared_mutex> lock(stateMutex);
     sort(tasks.begin(), tasks.end(), [soonestFirst](const Task& a, const Task& b) {
         if (!a.hasDueDate() && !b.hasDueDate()) return false;
         if (!a.hasDueDate()) return false;
@@ -424,6 +1033,7 @@ void TaskManager::sortByDueDate(bool soonestFirst) {
 }
 
 void TaskManager::sortByCreationDate(bool newestFirst) {
+    unique_lock<shared_mutex> lock(stateMutex);
     sort(tasks.begin(), tasks.end(), [newestFirst](const Task& a, const Task& b) {
         if (newestFirst) {
             return a.getCreatedAt() > b.getCreatedAt();
@@ -434,12 +1044,14 @@ void TaskManager::sortByCreationDate(bool newestFirst) {
 }
 
 void TaskManager::sortByStatus() {
+    unique_lock<shared_mutex> lock(stateMutex);
     sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) {
         return static_cast<int>(a.getStatus()) < static_cast<int>(b.getStatus());
     });
 }
 
 void TaskManager::sortByTitle(bool ascending) {
+    unique_lock<shared_mutex> lock(stateMutex);
     sort(tasks.begin(), tasks.end(), [ascending](const Task& a, const Task& b) {
         string titleA = a.getTitle();
         string titleB = b.getTitle();
@@ -456,6 +1068,7 @@ void TaskManager::sortByTitle(bool ascending) {
 }
 
 void TaskManager::sortById(bool ascending) {
+    unique_lock<shared_mutex> lock(stateMutex);
     sort(tasks.begin(), tasks.end(), [ascending](const Task& a, const Task& b) {
         if (ascending) {
             return a.getId() < b.getId();
@@ -466,6 +1079,7 @@ void TaskManager::sortById(bool ascending) {
 }
 
 void TaskManager::displaySortedTasks(const string& sortType) const {
+    shared_lock<shared_mutex> lock(stateMutex);
     if (tasks.empty()) {
         cout << "\nNo tasks available!" << endl;
         return;
@@ -480,25 +1094,61 @@ void TaskManager::displaySortedTasks(const string& sortType) const {
     }
 }
 
+// Bulk operations run as single SQL statements in SQLite mode. Cached
+// copies are flushed first and dropped once the statement succeeded; if
+// either step fails they stay cached and the call returns -1.
 int TaskManager::markAllComplete() {
+    unique_lock<shared_mutex> lock(stateMutex);
+    if (store) {
+        if (!flushCache()) {
+            return -1;
+        }
+        auto writer = store->acquireWriter();
+        int count = writer->markAllComplete();
+        if (count < 0) {
+            return -1;
+        }
+        cache->clear();
+        publishAll();
+        return count;
+    }
+    
     int count = 0;
     for (auto& task : tasks) {
         if (!task.isCompleted()) {
             task.markComplete();
+            markChanged(task.getId());
             count++;
         }
     }
     if (count > 0) {
         autoSave();
+        publishAll();
     }
     return count;
 }
 
 int TaskManager::deleteAllCompleted() {
+    unique_lock<shared_mutex> lock(stateMutex);
+    if (store) {
+        if (!flushCache()) {
+            return -1;
+        }
+        auto writer = store->acquireWriter();
+        int count = writer->deleteTasksByStatus(Status::COMPLETED);
+        if (count < 0) {
+            return -1;
+        }
+        cache->clear();
+        publishAll();
+        return count;
+    }
+    
     int count = 0;
     auto it = tasks.begin();
     while (it != tasks.end()) {
         if (it->isCompleted()) {
+            markChanged(it->getId());
             it = tasks.erase(it);
             count++;
         } else {
@@ -507,29 +1157,65 @@ int TaskManager::deleteAllCompleted() {
     }
     if (count > 0) {
         autoSave();
+        publishAll();
     }
     return count;
 }
 
 int TaskManager::deleteAllTasks() {
+    unique_lock<shared_mutex> lock(stateMutex);
+    if (store) {
+        // Pending write-backs are moot once their rows are gone
+        auto writer = store->acquireWriter();
+        int count = writer->deleteAllTasks();
+        if (count < 0) {
+            return -1;
+        }
+        cache->clear();
+        tasks.clear();
+        publishAll();
+        return count;
+    }
+    
     int count = tasks.size();
+    for (const auto& task : tasks) {
+        markChanged(task.getId());
+    }
     tasks.clear();
     if (count > 0) {
         autoSave();
+        publishAll();
     }
     return count;
 }
 
 int TaskManager::changePriorityBulk(Priority oldPriority, Priority newPriority) {
+    unique_lock<shared_mutex> lock(stateMutex);
+    if (store) {
+        if (!flushCache()) {
+            return -1;
+        }
+        auto writer = store->acquireWriter();
+        int count = writer->changePriority(oldPriority, newPriority);
+        if (count < 0) {
+            return -1;
+        }
+        cache->clear();
+        publishAll();
+        return count;
+    }
+    
     int count = 0;
     for (auto& task : tasks) {
         if (task.getPriority() == oldPriority) {
             task.setPriority(newPriority);
+            markChanged(task.getId());
             count++;
         }
     }
     if (count > 0) {
         autoSave();
+        publishAll();
     }
     return count;
 }
@@ -634,7 +634,9 @@ void TaskOperations::bulkOperationsMenu(TaskManager& manager) {
             
             if (confirmation == "yes") {
                 int count = manager.markAllComplete();
-                if (count > 0) {
+                if (count < 0) {
+                    cout << "\n" << ColorUtils::error("Failed to save the changes!") << endl;
+                } else if (count > 0) {
                     cout << "\n" << ColorUtils::success("✓ Marked " + to_string(count) + " task(s) as completed! 🎉") << endl;
                 } else {
                     cout << "\n" << ColorUtils::info("No incomplete tasks found.") << endl;
@@ -656,7 +658,9 @@ void TaskOperations::bulkOperationsMenu(TaskManager& manager) {
             
             if (confirmation == "yes") {
                 int count = manager.deleteAllCompleted();
-                if (count > 0) {
+                if (count < 0) {
+                    cout << "\n" << ColorUtils::error("Failed to save the changes!") << endl;
+                } else if (count > 0) {
                     cout << "\n" << ColorUtils::success("✓ Deleted " + to_string(count) + " completed task(s)!") << endl;
                 } else {
                     cout << "\n" << ColorUtils::info("No completed tasks found.") << endl;
@@ -713,7 +717,9 @@ void TaskOperations::bulkOperationsMenu(TaskManager& manager) {
             }
             
             int count = manager.changePriorityBulk(oldPriority, newPriority);
-            if (count > 0) {
+            if (count < 0) {
+                cout << "\n" << ColorUtils::error("Failed to save the changes!") << endl;
+            } else if (count > 0) {
                 cout << "\n" << ColorUtils::success("✓ Changed priority for " + to_string(count) + " task(s)!") << endl;
             } else {
                 cout << "\n" << ColorUtils::info("No tasks found with selected priority.") << endl;
@@ -733,8 +739,12 @@ void TaskOperations::bulkOperationsMenu(TaskManager& manager) {
             
             if (confirmation == "DELETE ALL") {
                 int count = manager.deleteAllTasks();
-                cout << "\n" << ColorUtils::success("✓ Deleted all " + to_string(count) + " task(s)!") << endl;
-                cout << ColorUtils::info("Database cleared.") << endl;
+                if (count < 0) {
+                    cout << "\n" << ColorUtils::error("Failed to delete the tasks!") << endl;
+                } else {
+                    cout << "\n" << ColorUtils::success("✓ Deleted all " + to_string(count) + " task(s)!") << endl;
+                    cout << ColorUtils::info("Database cleared.") << endl;
+                }
             } else {
                 cout << "\n" << ColorUtils::info("Operation cancelled. Tasks are safe.") << endl;
             }
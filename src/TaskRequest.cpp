@@ -0,0 +1,185 @@
+#include "TaskRequest.hpp"
+#include "JsonReader.hpp"
+#include <charconv>
+
+// Decodes straight into TaskRequest members as the reader walks the body.
+// depth counts the containers open around the current value: the request
+// objects sit at depth 0 (single) or 1 (list), their members one deeper.
+class TaskRequestHandler : public JsonHandler {
+public:
+    enum class Field { NONE, OP, ID, TITLE, DESCRIPTION, PRIORITY, STATUS };
+
+    TaskRequestHandler(TaskRequest* single, vector<TaskRequest>* list, size_t maxCount)
+        : single(single), list(list), maxCount(maxCount),
+          memberDepth(list ? 2 : 1), depth(0), current(nullptr), field(Field::NONE), truncated(false) {}
+
+    bool startObject() override {
+        if (depth == memberDepth - 1) {
+            if (list) {
+                list->emplace_back();
+                if (list->size() > maxCount) {
+                    truncated = true;
+                    return false;
+                }
+                current = &list->back();
+            } else {
+                current = single;
+            }
+        } else if (!containerAllowed()) {
+            return false;
+        }
+        depth++;
+        return true;
+    }
+
+    bool endObject() override {
+        depth--;
+        return true;
+    }
+
+    bool startArray() override {
+        if (depth == 0 && list) {
+            depth++;
+            return true;
+        }
+        if (!containerAllowed()) {
+            return false;
+        }
+        depth++;
+        return true;
+    }
+
+    bool endArray() override {
+        depth--;
+        return true;
+    }
+
+    bool key(string_view name) override {
+        field = Field::NONE;
+        if (depth != memberDepth) return true;
+        if (name == "op") field = Field::OP;
+        else if (name == "id") field = Field::ID;
+        else if (name == "title") field = Field::TITLE;
+        else if (name == "description") field = Field::DESCRIPTION;
+        else if (name == "priority") field = Field::PRIORITY;
+        else if (name == "status") field = Field::STATUS;
+        return true;
+    }
+
+    bool stringValue(string_view value) override {
+        if (!scalarAllowed()) return false;
+        if (depth != memberDepth || field == Field::NONE) return true;
+        if (field == Field::ID) return typeError();
+        optional<string>* target = stringField();
+        target->emplace(value);
+        return true;
+    }
+
+    bool numberValue(string_view text) override {
+        if (!scalarAllowed()) return false;
+        if (depth != memberDepth || field == Field::NONE) return true;
+        if (field != Field::ID) return typeError();
+
+        int id = 0;
+        auto [end, ec] = from_chars(text.data(), text.data() + text.size(), id);
+        if (ec != errc() || end != text.data() + text.size()) {
+            return typeError();
+        }
+        current->id = id;
+        return true;
+    }
+
+    bool boolValue(bool) override {
+        if (!scalarAllowed()) return false;
+        if (depth != memberDepth || field == Field::NONE) return true;
+        return typeError();
+    }
+
+    bool nullValue() override {
+        if (!scalarAllowed()) return false;
+        if (depth != memberDepth || field == Field::NONE) return true;
+        if (field == Field::ID) current->id.reset();
+        else stringField()->reset();
+        return true;
+    }
+
+    string stopReason() const override {
+        if (list && !list->empty() && reason.rfind("expected", 0) != 0) {
+            return "item " + to_string(list->size() - 1) + ": " + reason;
+        }
+        return reason;
+    }
+
+    bool wasTruncated() const {
+        return truncated;
+    }
+
+private:
+    TaskRequest* single;
+    vector<TaskRequest>* list;
+    size_t maxCount;
+    int memberDepth;
+    int depth;
+    TaskRequest* current;
+    Field field;
+    bool truncated;
+    string reason;
+
+    // Where a request object must be, anything else is the wrong shape
+    bool shapeError() {
+        if (list) {
+            reason = depth == 0 ? "expected a JSON array" : "expected an array of objects";
+        } else {
+            reason = "expected a JSON object";
+        }
+        return false;
+    }
+
+    bool scalarAllowed() {
+        return depth >= memberDepth || shapeError();
+    }
+
+    // Nested containers are skipped unless they stand in for a known field
+    bool containerAllowed() {
+        if (depth < memberDepth) return shapeError();
+        if (depth == memberDepth && field != Field::NONE) return typeError();
+        return true;
+    }
+
+    bool typeError() {
+        static const char* names[] = {"", "op", "id", "title", "description", "priority", "status"};
+        reason = string(names[static_cast<int>(field)]) +
+                 (field == Field::ID ? " must be an integer" : " must be a string");
+        return false;
+    }
+
+    optional<string>* stringField() {
+        switch (field) {
+            case Field::OP: return &current->op;
+            case Field::TITLE: return &current->title;
+            case Field::DESCRIPTION: return &current->description;
+            case Field::PRIORITY: return &current->priority;
+            case Field::STATUS:
+            default: return &current->status;
+        }
+    }
+};
+
+bool TaskRequest::parse(string_view body, TaskRequest& request, string& error) {
+    request = TaskRequest();
+    TaskRequestHandler handler(&request, nullptr, 0);
+    return JsonReader::parse(body, handler, error);
+}
+
+bool TaskRequest::parseList(string_view body, vector<TaskRequest>& requests, size_t maxCount, string& error) {
+    requests.clear();
+    TaskRequestHandler handler(nullptr, &requests, maxCount);
+    if (JsonReader::parse(body, handler, error)) {
+        return true;
+    }
+    if (handler.wasTruncated()) {
+        error.clear();
+        return true;
+    }
+    return false;
+}
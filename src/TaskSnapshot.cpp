@@ -0,0 +1,367 @@
+#include "TaskSnapshot.hpp"
+#include <algorithm>
+#include <climits>
+#include <optional>
+
+TaskSnapshot::TaskSnapshot() : version(0), taskCount(0) {}
+
+size_t TaskSnapshot::chunkIndex(int id) {
+    return static_cast<size_t>(id) / CHUNK_SIZE;
+}
+
+vector<TaskSnapshot::ChunkSlot>::const_iterator TaskSnapshot::slotAt(size_t k) const {
+    return lower_bound(chunks.begin(), chunks.end(), k,
+                       [](const ChunkSlot& slot, size_t key) { return slot.key < key; });
+}
+
+const TaskSnapshot::Chunk* TaskSnapshot::chunkFor(int id) const {
+    if (id < 0) {
+        return nullptr;
+    }
+    auto slot = slotAt(chunkIndex(id));
+    return slot != chunks.end() && slot->key == chunkIndex(id) ? slot->tasks.get() : nullptr;
+}
+
+template <typename EntryType>
+static bool idLess(const EntryType& entry, int id) {
+    return entry.task.getId() < id;
+}
+
+shared_ptr<const TaskSnapshot> TaskSnapshot::build(const vector<Task>& tasks, uint64_t version) {
+    vector<Entry> entries;
+    entries.reserve(tasks.size());
+    for (const auto& task : tasks) {
+        if (task.getId() >= 0) {
+            entries.push_back({task, version});
+        }
+    }
+    sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.task.getId() < b.task.getId();
+    });
+
+    auto snapshot = make_shared<TaskSnapshot>();
+    snapshot->version = version;
+    snapshot->taskCount = entries.size();
+    vector<TaskIndex::Key> priorities, statuses, dueDates, createdAts;
+    shared_ptr<Chunk> chunk;
+    for (auto& entry : entries) {
+        const Task& task = entry.task;
+        priorities.push_back({TaskQuery::sortKey(task, TaskSortField::PRIORITY), task.getId()});
+        statuses.push_back({TaskQuery::sortKey(task, TaskSortField::STATUS), task.getId()});
+        dueDates.push_back({TaskQuery::sortKey(task, TaskSortField::DUE_DATE), task.getId()});
+        createdAts.push_back({TaskQuery::sortKey(task, TaskSortField::CREATED_AT), task.getId()});
+
+        size_t k = chunkIndex(task.getId());
+        if (!chunk || snapshot->chunks.back().key != k) {
+            chunk = make_shared<Chunk>();
+            snapshot->chunks.push_back({k, chunk});
+        }
+        chunk->push_back(move(entry));
+    }
+    snapshot->byPriority = TaskIndex::build(move(priorities));
+    snapshot->byStatus = TaskIndex::build(move(statuses));
+    snapshot->byDueDate = TaskIndex::build(move(dueDates));
+    snapshot->byCreatedAt = TaskIndex::build(move(createdAts));
+    return snapshot;
+}
+
+shared_ptr<const TaskSnapshot> TaskSnapshot::withTask(const Task& task, uint64_t nextVersion) const {
+    auto next = make_shared<TaskSnapshot>(*this);
+    next->version = nextVersion;
+    if (task.getId() < 0) {
+        return next;
+    }
+
+    size_t k = chunkIndex(task.getId());
+    auto slot = next->chunks.begin() + (slotAt(k) - chunks.begin());
+    if (slot == next->chunks.end() || slot->key != k) {
+        slot = next->chunks.insert(slot, {k, nullptr});
+    }
+
+    auto chunk = slot->tasks ? make_shared<Chunk>(*slot->tasks) : make_shared<Chunk>();
+    auto it = lower_bound(chunk->begin(), chunk->end(), task.getId(), idLess<Entry>);
+    if (it != chunk->end() && it->task.getId() == task.getId()) {
+        next->reindexTask(&it->task, &task);
+        *it = {task, nextVersion};
+    } else {
+        next->reindexTask(nullptr, &task);
+        chunk->insert(it, {task, nextVersion});
+        next->taskCount++;
+    }
+    slot->tasks = chunk;
+    return next;
+}
+
+shared_ptr<const TaskSnapshot> TaskSnapshot::withoutTask(int id, uint64_t nextVersion) const {
+    auto next = make_shared<TaskSnapshot>(*this);
+    next->version = nextVersion;
+
+    const Chunk* current = chunkFor(id);
+    if (!current) {
+        return next;
+    }
+    auto it = lower_bound(current->begin(), current->end(), id, idLess<Entry>);
+    if (it == current->end() || it->task.getId() != id) {
+        return next;
+    }
+
+    next->reindexTask(&it->task, nullptr);
+    auto slot = next->chunks.begin() + (slotAt(chunkIndex(id)) - chunks.begin());
+    if (current->size() == 1) {
+        next->chunks.erase(slot);
+    } else {
+        auto chunk = make_shared<Chunk>(*current);
+        chunk->erase(chunk->begin() + (it - current->begin()));
+        slot->tasks = chunk;
+    }
+    next->taskCount--;
+    return next;
+}
+
+// Applied to a fresh copy; only indexes whose key changed copy a block
+void TaskSnapshot::reindexTask(const Task* before, const Task* after) {
+    const pair<TaskIndex*, TaskSortField> indexes[] = {
+        {&byPriority, TaskSortField::PRIORITY},
+        {&byStatus, TaskSortField::STATUS},
+        {&byDueDate, TaskSortField::DUE_DATE},
+        {&byCreatedAt, TaskSortField::CREATED_AT}
+    };
+    for (const auto& [index, field] : indexes) {
+        optional<TaskIndex::Key> oldKey, newKey;
+        if (before) oldKey = TaskIndex::Key{TaskQuery::sortKey(*before, field), before->getId()};
+        if (after) newKey = TaskIndex::Key{TaskQuery::sortKey(*after, field), after->getId()};
+        if (oldKey == newKey) {
+            continue;
+        }
+        if (oldKey) index->erase(*oldKey);
+        if (newKey) index->insert(*newKey);
+    }
+}
+
+uint64_t TaskSnapshot::getVersion() const {
+    return version;
+}
+
+size_t TaskSnapshot::size() const {
+    return taskCount;
+}
+
+const Task* TaskSnapshot::find(int id) const {
+    const Chunk* chunk = chunkFor(id);
+    if (!chunk) {
+        return nullptr;
+    }
+
+    auto it = lower_bound(chunk->begin(), chunk->end(), id, idLess<Entry>);
+    return it != chunk->end() && it->task.getId() == id ? &it->task : nullptr;
+}
+
+void TaskSnapshot::forEach(const function<bool(const Task&)>& onTask) const {
+    forEachRevision([&onTask](const Task& task, uint64_t) { return onTask(task); });
+}
+
+void TaskSnapshot::forEachRevision(const function<bool(const Task&, uint64_t revision)>& onTask) const {
+    for (const auto& slot : chunks) {
+        for (const auto& entry : *slot.tasks) {
+            if (!onTask(entry.task, entry.revision)) {
+                return;
+            }
+        }
+    }
+}
+
+bool TaskSnapshot::scanIds(int from, bool descending, const function<bool(const Task&)>& onTask) const {
+    if (chunks.empty() || (from < 0 && descending)) {
+        return true;
+    }
+    from = max(from, 0);
+
+    if (!descending) {
+        for (auto slot = slotAt(chunkIndex(from)); slot != chunks.end(); ++slot) {
+            const Chunk& chunk = *slot->tasks;
+            for (auto it = lower_bound(chunk.begin(), chunk.end(), from, idLess<Entry>); it != chunk.end(); ++it) {
+                if (!onTask(it->task)) return false;
+            }
+        }
+        return true;
+    }
+
+    // Slots up to and including the one that would hold `from`
+    auto stop = slotAt(chunkIndex(from) + 1);
+    for (auto slot = stop; slot != chunks.begin();) {
+        --slot;
+        const Chunk& chunk = *slot->tasks;
+        auto end = upper_bound(chunk.begin(), chunk.end(), from, [](int id, const Entry& entry) {
+            return id < entry.task.getId();
+        });
+        for (auto it = end; it != chunk.begin();) {
+            --it;
+            if (!onTask(it->task)) return false;
+        }
+    }
+    return true;
+}
+
+bool TaskSnapshot::scanIndex(const TaskIndex& index, TaskIndex::Key from, long long low, long long high,
+                             bool descending, const function<bool(const Task&)>& onTask) const {
+    // Start no earlier than the range itself
+    if (!descending && from < TaskIndex::Key{low, INT_MIN}) from = {low, INT_MIN};
+    if (descending && TaskIndex::Key{high, INT_MAX} < from) from = {high, INT_MAX};
+
+    bool finished = true;
+    index.scan(from, descending, [&](const TaskIndex::Key& key) {
+        if (key.value < low || key.value > high) {
+            return false;
+        }
+        const Task* task = find(key.id);
+        if (task && !onTask(*task)) {
+            finished = false;
+            return false;
+        }
+        return true;
+    });
+    return finished;
+}
+
+void TaskSnapshot::scan(const TaskQuery& query, const function<bool(const Task&)>& onTask) const {
+    bool descending = query.descending;
+    // Just past the cursor, or the start of the whole order. Past the
+    // largest id comes the next key; nullopt if nothing can follow.
+    auto start = [&](long long value) -> optional<TaskIndex::Key> {
+        if (!query.after) {
+            return descending ? TaskIndex::Key{LLONG_MAX, INT_MAX} : TaskIndex::Key{LLONG_MIN, INT_MIN};
+        }
+        int id = query.after->id;
+        if (descending) {
+            if (id > INT_MIN) return TaskIndex::Key{value, id - 1};
+            if (value > LLONG_MIN) return TaskIndex::Key{value - 1, INT_MAX};
+        } else {
+            if (id < INT_MAX) return TaskIndex::Key{value, id + 1};
+            if (value < LLONG_MAX) return TaskIndex::Key{value + 1, INT_MIN};
+        }
+        return nullopt;
+    };
+
+    switch (query.sortBy) {
+        case TaskSortField::ID: {
+            // Within one status or priority, that index is already in id order
+            if (query.status || query.priority) {
+                const TaskIndex& index = query.status ? byStatus : byPriority;
+                long long value = query.status ? static_cast<int>(*query.status) : static_cast<int>(*query.priority);
+                optional<TaskIndex::Key> from = query.after ? start(0) : nullopt;
+                if (query.after && (!from || from->value != 0)) {
+                    return;     // The cursor was the last possible id
+                }
+                scanIndex(index, {value, from ? from->id : (descending ? INT_MAX : INT_MIN)},
+                          value, value, descending, onTask);
+                return;
+            }
+            optional<TaskIndex::Key> from = query.after ? start(0) : nullopt;
+            if (query.after && (!from || from->value != 0)) {
+                return;
+            }
+            scanIds(from ? from->id : (descending ? INT_MAX : 0), descending, onTask);
+            return;
+        }
+
+        case TaskSortField::PRIORITY:
+        case TaskSortField::STATUS: {
+            bool byPriorityField = query.sortBy == TaskSortField::PRIORITY;
+            const TaskIndex& index = byPriorityField ? byPriority : byStatus;
+            long long low = LLONG_MIN;
+            long long high = LLONG_MAX;
+            if (byPriorityField && query.priority) low = high = static_cast<int>(*query.priority);
+            if (!byPriorityField && query.status) low = high = static_cast<int>(*query.status);
+            optional<TaskIndex::Key> from = start(query.after ? query.after->key : 0);
+            if (from) {
+                scanIndex(index, *from, low, high, descending, onTask);
+            }
+            return;
+        }
+
+        case TaskSortField::CREATED_AT: {
+            optional<TaskIndex::Key> from = start(query.after ? query.after->key : 0);
+            if (from) {
+                scanIndex(byCreatedAt, *from, LLONG_MIN, LLONG_MAX, descending, onTask);
+            }
+            return;
+        }
+
+        case TaskSortField::DUE_DATE: {
+            // Dated tasks within the due-date bounds first, in either direction
+            long long low = max<long long>(query.dueFrom, 1);
+            long long high = query.dueTo > 0 ? query.dueTo : LLONG_MAX;
+            bool onlyOverdue = query.overdue && *query.overdue;
+            if (onlyOverdue) {
+                high = min<long long>(high, query.currentTime() - 1);
+            }
+            if (!query.after || query.after->key > 0) {
+                optional<TaskIndex::Key> from = start(query.after ? query.after->key : 0);
+                if (from && !scanIndex(byDueDate, *from, low, high, descending, onTask)) {
+                    return;
+                }
+            }
+
+            // Then tasks without a due date, unless a due-date filter excludes them
+            if (query.dueFrom > 0 || query.dueTo > 0 || onlyOverdue) {
+                return;
+            }
+            optional<TaskIndex::Key> from = query.after && query.after->key == 0
+                ? start(0) : TaskIndex::Key{0, descending ? INT_MAX : INT_MIN};
+            if (from) {
+                scanIndex(byDueDate, *from, 0, 0, descending, onTask);
+            }
+            return;
+        }
+    }
+}
+
+vector<Task> TaskSnapshot::query(const TaskQuery& query) const {
+    // The indexes yield tasks already in order, so the walk stops as soon
+    // as the page is full
+    vector<Task> result;
+    if (query.limit == 0) {
+        return result;
+    }
+    int skip = max(query.offset, 0);
+    scan(query, [&query, &result, &skip](const Task& task) {
+        if (!query.matches(task)) {
+            return true;
+        }
+        if (skip > 0) {
+            skip--;
+            return true;
+        }
+        result.push_back(task);
+        return query.limit < 0 || static_cast<int>(result.size()) < query.limit;
+    });
+    return result;
+}
+
+size_t TaskSnapshot::count(const TaskQuery& query) const {
+    bool dueRange = query.dueFrom > 0 || query.dueTo > 0;
+    int filters = (query.status ? 1 : 0) + (query.priority ? 1 : 0) + (dueRange ? 1 : 0);
+    if (!query.after && !query.overdue && filters <= 1) {
+        if (query.status) {
+            long long value = static_cast<int>(*query.status);
+            return byStatus.count(value, value);
+        }
+        if (query.priority) {
+            long long value = static_cast<int>(*query.priority);
+            return byPriority.count(value, value);
+        }
+        if (dueRange) {
+            // Key 0 (no due date) is below every bound
+            return byDueDate.count(max<long long>(query.dueFrom, 1),
+                                   query.dueTo > 0 ? query.dueTo : LLONG_MAX);
+        }
+        return taskCount;
+    }
+
+    size_t matched = 0;
+    scan(query, [&query, &matched](const Task& task) {
+        matched += query.matches(task) ? 1 : 0;
+        return true;
+    });
+    return matched;
+}
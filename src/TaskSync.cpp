@@ -0,0 +1,218 @@
+#include "TaskSync.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <unordered_set>
+
+TaskSync::TaskSync(FileHandler& json, SQLiteHandler& sqlite, SyncPreference prefer)
+    : jsonStore(json), sqliteStore(sqlite), preference(prefer) {}
+
+int64_t TaskSync::contentHash(const Task& task) {
+    uint64_t h = 14695981039346656037ULL;
+    auto addBytes = [&h](const void* data, size_t length) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < length; i++) {
+            h ^= bytes[i];
+            h *= 1099511628211ULL;
+        }
+    };
+    // Fixed-width little-endian integers keep the hash independent of int sizes
+    auto addNumber = [&addBytes](int64_t value) {
+        unsigned char bytes[8];
+        for (int i = 0; i < 8; i++) {
+            bytes[i] = static_cast<unsigned char>(static_cast<uint64_t>(value) >> (8 * i));
+        }
+        addBytes(bytes, sizeof(bytes));
+    };
+
+    string title = task.getTitle();
+    string description = task.getDescription();
+    addNumber(title.size());
+    addBytes(title.data(), title.size());
+    addNumber(description.size());
+    addBytes(description.data(), description.size());
+    addNumber(static_cast<int64_t>(task.getPriority()));
+    addNumber(static_cast<int64_t>(task.getStatus()));
+    addNumber(task.getCreatedAt());
+    addNumber(task.getDueDate());
+    return static_cast<int64_t>(h);
+}
+
+bool TaskSync::sync(SyncReport& report) {
+    report = SyncReport();
+
+    vector<Task> jsonTasks;
+    int jsonNextId = 1;
+    if (!jsonStore.loadTasks(jsonTasks, jsonNextId)) {
+        return false;
+    }
+
+    unordered_map<int, int64_t> jsonHashes;
+    unordered_map<int, size_t> jsonPositions;
+    jsonHashes.reserve(jsonTasks.size());
+    for (size_t i = 0; i < jsonTasks.size(); i++) {
+        jsonHashes[jsonTasks[i].getId()] = contentHash(jsonTasks[i]);
+        jsonPositions[jsonTasks[i].getId()] = i;
+    }
+
+    unordered_map<int, int64_t> sqliteHashes;
+    int maxId = 0;
+    if (!sqliteStore.streamTasks([&](const Task& task) {
+            sqliteHashes[task.getId()] = contentHash(task);
+            maxId = max(maxId, task.getId());
+            return true;
+        })) {
+        return false;
+    }
+
+    unordered_map<int, int64_t> base = sqliteStore.loadSyncState();
+
+    vector<Task> pushToSqlite;
+    vector<int> removeFromSqlite;
+    unordered_set<int> pullToJson;
+    unordered_set<int> removeFromJson;
+    vector<pair<int, int64_t>> baseChanged;
+    vector<int> baseRemoved;
+
+    auto lookup = [](const unordered_map<int, int64_t>& hashes, int id) {
+        auto it = hashes.find(id);
+        return it == hashes.end() ? optional<int64_t>() : optional<int64_t>(it->second);
+    };
+
+    auto reconcile = [&](int id) {
+        optional<int64_t> inJson = lookup(jsonHashes, id);
+        optional<int64_t> inSqlite = lookup(sqliteHashes, id);
+        optional<int64_t> lastSynced = lookup(base, id);
+        optional<int64_t> result = inJson;
+
+        if (inJson == inSqlite) {
+            if (inJson) {
+                report.unchanged++;
+            }
+        } else {
+            bool jsonEdited = inJson != lastSynced;
+            bool sqliteEdited = inSqlite != lastSynced;
+            bool takeJson = jsonEdited;
+            if (jsonEdited && sqliteEdited) {
+                report.conflicts++;
+                takeJson = preference == SyncPreference::JSON;
+            }
+
+            if (takeJson) {
+                if (inJson) {
+                    pushToSqlite.push_back(jsonTasks[jsonPositions[id]]);
+                } else {
+                    removeFromSqlite.push_back(id);
+                }
+            } else {
+                result = inSqlite;
+                if (inSqlite) {
+                    pullToJson.insert(id);
+                } else {
+                    removeFromJson.insert(id);
+                }
+            }
+        }
+
+        if (result != lastSynced) {
+            if (result) {
+                baseChanged.push_back({id, *result});
+            } else {
+                baseRemoved.push_back(id);
+            }
+        }
+    };
+
+    for (const auto& entry : jsonHashes) {
+        reconcile(entry.first);
+    }
+    for (const auto& entry : sqliteHashes) {
+        if (jsonHashes.find(entry.first) == jsonHashes.end()) {
+            reconcile(entry.first);
+        }
+    }
+    for (const auto& entry : base) {
+        if (jsonHashes.find(entry.first) == jsonHashes.end() &&
+            sqliteHashes.find(entry.first) == sqliteHashes.end()) {
+            reconcile(entry.first);
+        }
+    }
+
+    // Ids are allocated from either store, so both continue after the larger
+    optional<string> storedNextId = sqliteStore.getSetting("next_id");
+    int sqliteNextId = storedNextId ? atoi(storedNextId->c_str()) : maxId + 1;
+    int nextId = max({jsonNextId, sqliteNextId, maxId + 1});
+    for (const auto& task : jsonTasks) {
+        nextId = max(nextId, task.getId() + 1);
+    }
+
+    size_t pulled = pullToJson.size();
+    bool jsonDirty = !pullToJson.empty() || !removeFromJson.empty() || jsonNextId != nextId;
+    if (pushToSqlite.empty() && removeFromSqlite.empty() && !jsonDirty &&
+        baseChanged.empty() && baseRemoved.empty() && sqliteNextId == nextId) {
+        return true;
+    }
+
+    // SQLite changes and the new sync state commit together; the JSON file is
+    // written before that commit, so a failure never records unsynced hashes
+    if (!sqliteStore.beginTransaction()) {
+        return false;
+    }
+
+    bool ok = sqliteStore.upsertTasks(pushToSqlite) >= 0;
+    for (int id : removeFromSqlite) {
+        ok = ok && sqliteStore.deleteTask(id);
+    }
+    ok = ok && (sqliteNextId == nextId || sqliteStore.setSetting("next_id", to_string(nextId)));
+
+    if (ok && jsonDirty) {
+        vector<Task> merged;
+        merged.reserve(jsonTasks.size() + pullToJson.size());
+        for (const auto& task : jsonTasks) {
+            int id = task.getId();
+            if (removeFromJson.count(id)) {
+                continue;
+            }
+            if (pullToJson.count(id)) {
+                optional<Task> stored = sqliteStore.getTaskById(id);
+                ok = ok && stored.has_value();
+                if (stored) {
+                    merged.push_back(*stored);
+                }
+                pullToJson.erase(id);
+            } else {
+                merged.push_back(task);
+            }
+        }
+
+        // Tasks created on the SQLite side go to the end in id order
+        vector<int> added(pullToJson.begin(), pullToJson.end());
+        sort(added.begin(), added.end());
+        for (int id : added) {
+            optional<Task> stored = sqliteStore.getTaskById(id);
+            ok = ok && stored.has_value();
+            if (stored) {
+                merged.push_back(*stored);
+            }
+        }
+
+        ok = ok && jsonStore.saveTasks(merged, nextId);
+    }
+
+    ok = ok && sqliteStore.updateSyncState(baseChanged, baseRemoved);
+    if (!ok) {
+        cerr << "Sync failed; no changes recorded" << endl;
+        sqliteStore.rollbackTransaction();
+        return false;
+    }
+    if (!sqliteStore.commitTransaction()) {
+        return false;
+    }
+
+    report.toSqlite = pushToSqlite.size();
+    report.deletedFromSqlite = removeFromSqlite.size();
+    report.toJson = pulled;
+    report.deletedFromJson = removeFromJson.size();
+    return true;
+}
@@ -2,42 +2,176 @@
 #include <sstream>
 #include <thread>
 #include <chrono>
+#include <atomic>
 #include "TaskManager.hpp"
+#include "ConfigHandler.hpp"
+#include "SQLiteConnectionPool.hpp"
+#include "TaskCommandQueue.hpp"
+#include "ResponseCache.hpp"
+#include "TaskJsonCache.hpp"
+#include "TaskRequest.hpp"
+#include "RequestQueue.hpp"
+#ifdef HAVE_POSTGRESQL
+#include "PostgresTaskStore.hpp"
+#endif
+
+// httplib's default backlog of 5 drops connections in a burst before the
+// server has even accepted them; clients then wait a second to retry
+#define CPPHTTPLIB_LISTEN_BACKLOG 1024
 #include "httplib.h"
 
 using namespace std;
 using namespace httplib;
 
-// Global TaskManager instance
-TaskManager taskManager;
+// Global storage: SQLite pool (storage_backend=sqlite only) and TaskManager.
+// Declared in this order so the manager flushes before the pool closes, and
+// the PostgreSQL change listener stops before the manager goes away.
+// Handlers run on httplib's thread pool, so they only use the TaskManager
+// calls that lock and return copies. Writes go through one writer thread,
+// which saves each batch of queued commands once.
+string storageBackend = "json";
+unique_ptr<SQLiteConnectionPool> taskStore;
+unique_ptr<TaskManager> taskManager;
+#ifdef HAVE_POSTGRESQL
+unique_ptr<PostgresTaskStore> postgresStore;
+#endif
+unique_ptr<TaskCommandQueue> writeQueue;
+
+// Serialized GET bodies, valid until the store version changes
+ResponseCache responseCache;
+
+// Per-task JSON fragments, reused while a task is unchanged
+TaskJsonCache jsonCache;
+
+// Cached bodies smaller than this are sent uncompressed (compress_min_bytes)
+size_t compressMinBytes = 1024;
+
+// Open GET /api/events streams. Each one holds a server thread while it is
+// open, so the thread pool is sized for max_event_subscribers of them on top
+// of the threads for ordinary requests.
+atomic<int> eventSubscribers(0);
+int maxEventSubscribers = 1024;
+
+// Runs accepted connections (server_threads workers, max_in_flight admitted)
+unique_ptr<RequestQueue> requestQueue;
+
+// httplib's connection queue, backed by requestQueue. httplib deletes this
+// adapter when listen() returns; the queue itself stays up for metrics.
+class AdmissionQueue : public TaskQueue {
+public:
+    bool enqueue(function<void()> fn) override {
+        return requestQueue->enqueue(move(fn));
+    }
+    void shutdown() override {
+        requestQueue->shutdown();
+    }
+};
+
+// Helper: Event id "<epoch>:<seq>" for a change log position. The epoch
+// tells a resuming client whether seq numbers still refer to this process.
+string eventId(uint64_t seq) {
+    return to_string(taskManager->getChangeLog().getEpoch()) + ":" + to_string(seq);
+}
 
 // Helper: Convert Task to JSON
 string taskToJson(const Task& task) {
-    ostringstream json;
-    json << "{";
-    json << "\"id\":" << task.getId() << ",";
-    json << "\"title\":\"" << task.getTitle() << "\",";
-    json << "\"description\":\"" << task.getDescription() << "\",";
-    json << "\"priority\":\"" << task.getPriorityString() << "\",";
-    json << "\"status\":\"" << task.getStatusString() << "\",";
-    json << "\"createdAt\":" << task.getCreatedAt() << ",";
-    json << "\"dueDate\":" << task.getDueDate() << ",";
-    json << "\"isCompleted\":" << (task.isCompleted() ? "true" : "false") << ",";
-    json << "\"isOverdue\":" << (task.isOverdue() ? "true" : "false");
-    json << "}";
-    return json.str();
-}
-
-// Helper: Convert all tasks to JSON array
-string tasksToJson(const vector<Task>& tasks) {
-    ostringstream json;
-    json << "[";
-    for (size_t i = 0; i < tasks.size(); i++) {
-        json << taskToJson(tasks[i]);
-        if (i < tasks.size() - 1) json << ",";
-    }
-    json << "]";
-    return json.str();
+    time_t validUntil = 0;
+    return TaskJsonCache::toJson(task, time(nullptr), validUntil);
+}
+
+// Helper: Current response cache entry for key, built on a miss. build()
+// returns false when there is nothing to serve (null is returned). The
+// version is read before building, so a write racing the build only makes
+// the entry older.
+shared_ptr<const ResponseCache::Entry> cachedEntry(
+        const string& key, const function<bool(string& body, time_t now, time_t& validUntil)>& build) {
+    time_t now = time(nullptr);
+    uint64_t version = taskManager->getVersion();
+    shared_ptr<const ResponseCache::Entry> entry = responseCache.get(key, version, now);
+    if (!entry) {
+        string body;
+        time_t validUntil = 0;
+        if (!build(body, now, validUntil)) {
+            return nullptr;
+        }
+        entry = responseCache.put(key, version, validUntil, move(body));
+    }
+    return entry;
+}
+
+// Helper: Answer a GET from the response cache (see cachedEntry). Large
+// bodies are sent gzip/deflate-compressed when the client accepts it; the
+// compressed body is kept on the cache entry, so each version of a response
+// is compressed at most once per encoding.
+bool serveCached(const Request& req, Response& res, const string& key,
+                 const function<bool(string& body, time_t now, time_t& validUntil)>& build) {
+    shared_ptr<const ResponseCache::Entry> entry = cachedEntry(key, build);
+    if (!entry) {
+        return false;
+    }
+    
+    // Small bodies are not worth compressing, unless identity;q=0 asks for it
+    ResponseCache::Encoding encoding = ResponseCache::Encoding::IDENTITY;
+    string acceptEncoding = req.get_header_value("Accept-Encoding");
+    if (entry->body.size() >= compressMinBytes || ResponseCache::refusesIdentity(acceptEncoding)) {
+        encoding = ResponseCache::negotiate(acceptEncoding);
+    }
+    const string* body = &entry->body;
+    if (encoding != ResponseCache::Encoding::IDENTITY) {
+        const string& compressed = entry->compressed(encoding);
+        if (compressed.empty()) {
+            encoding = ResponseCache::Encoding::IDENTITY;
+        } else {
+            body = &compressed;
+        }
+    }
+    string etag = ResponseCache::encodedETag(entry->etag, encoding);
+    
+    // Position to resume the change feed from; the body includes at least
+    // every write up to it
+    res.set_header("X-Event-Id", eventId(entry->version));
+    res.set_header("ETag", etag);
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("Vary", "Accept-Encoding");
+    if (req.has_header("If-None-Match") &&
+        ResponseCache::matchesETag(req.get_header_value("If-None-Match"), etag)) {
+        res.status = 304;
+        return true;
+    }
+    if (encoding != ResponseCache::Encoding::IDENTITY) {
+        res.set_header("Content-Encoding", ResponseCache::encodingName(encoding));
+    }
+    res.set_content(*body, "application/json");
+    return true;
+}
+
+// Helper: Builds the full task list for the response cache
+function<bool(string&, time_t, time_t&)> taskListBuilder(TaskJsonCache::FieldMask fields) {
+    return [fields](string& body, time_t now, time_t& validUntil) {
+        // Serializing a snapshot holds no lock, so writers are not blocked
+        shared_ptr<const TaskSnapshot> snapshot = taskManager->getSnapshot();
+        if (snapshot) {
+            body = jsonCache.toJson(*snapshot, now, validUntil, fields);
+        } else {
+            body = TaskJsonCache::toJson(taskManager->queryTasks(TaskQuery()), now, validUntil, fields);
+        }
+        return true;
+    };
+}
+
+// Helper: Send an uncached JSON body, compressed like serveCached() does
+void sendJson(const Request& req, Response& res, string body) {
+    res.set_header("Vary", "Accept-Encoding");
+    string acceptEncoding = req.get_header_value("Accept-Encoding");
+    if (body.size() >= compressMinBytes || ResponseCache::refusesIdentity(acceptEncoding)) {
+        ResponseCache::Encoding encoding = ResponseCache::negotiate(acceptEncoding);
+        string compressed;
+        if (encoding != ResponseCache::Encoding::IDENTITY && ResponseCache::compress(body, encoding, compressed)) {
+            res.set_header("Content-Encoding", ResponseCache::encodingName(encoding));
+            body = move(compressed);
+        }
+    }
+    res.set_content(body, "application/json");
 }
 
 // Helper: Parse priority from string
@@ -47,6 +181,303 @@ Priority parsePriority(const string& str) {
     return Priority::MEDIUM;
 }
 
+// Helper: Parse a status/priority filter; accepts the display and enum spellings
+optional<Status> parseStatusFilter(const string& str) {
+    if (str == "Pending" || str == "PENDING") return Status::PENDING;
+    if (str == "In Progress" || str == "IN_PROGRESS") return Status::IN_PROGRESS;
+    if (str == "Completed" || str == "COMPLETED") return Status::COMPLETED;
+    return nullopt;
+}
+
+optional<Priority> parsePriorityFilter(const string& str) {
+    if (str == "Low" || str == "LOW") return Priority::LOW;
+    if (str == "Medium" || str == "MEDIUM") return Priority::MEDIUM;
+    if (str == "High" || str == "HIGH") return Priority::HIGH;
+    return nullopt;
+}
+
+// Helper: Field mask from the optional `fields` parameter (all fields if absent)
+bool parseFieldsParam(const Request& req, TaskJsonCache::FieldMask& fields) {
+    fields = TaskJsonCache::ALL_FIELDS;
+    return !req.has_param("fields") ||
+           TaskJsonCache::parseFields(req.get_param_value("fields"), fields);
+}
+
+// Helper: Build a TaskQuery from GET /api/tasks parameters. Returns the name
+// of the first invalid parameter, or an empty string.
+string parseTaskQuery(const Request& req, TaskQuery& query) {
+    auto number = [](const string& str, long long& out) {
+        if (str.empty()) return false;
+        size_t used = 0;
+        try {
+            out = stoll(str, &used);
+        } catch (const exception&) {
+            return false;
+        }
+        return used == str.size();
+    };
+    long long value = 0;
+    
+    if (req.has_param("sort")) {
+        string sort = req.get_param_value("sort");
+        query.descending = !sort.empty() && sort[0] == '-';
+        if (query.descending) sort.erase(0, 1);
+        if (!parseSortField(sort, query.sortBy)) return "sort";
+    }
+    if (req.has_param("limit")) {
+        if (!number(req.get_param_value("limit"), value) || value < 0 || value > INT32_MAX) return "limit";
+        query.limit = static_cast<int>(value);
+    }
+    if (req.has_param("after")) {
+        // "<key>:<id>" as returned in X-Next-Cursor; a bare id when sorting by id
+        string after = req.get_param_value("after");
+        size_t colon = after.find(':');
+        long long key = 0;
+        long long id = 0;
+        if (colon == string::npos) {
+            if (!number(after, id)) return "after";
+            key = id;
+        } else if (!number(after.substr(0, colon), key) || !number(after.substr(colon + 1), id)) {
+            return "after";
+        }
+        if (id < 0 || id > INT32_MAX) return "after";
+        query.after = TaskCursor{key, static_cast<int>(id)};
+    }
+    if (req.has_param("status")) {
+        query.status = parseStatusFilter(req.get_param_value("status"));
+        if (!query.status) return "status";
+    }
+    if (req.has_param("priority")) {
+        query.priority = parsePriorityFilter(req.get_param_value("priority"));
+        if (!query.priority) return "priority";
+    }
+    if (req.has_param("overdue")) {
+        string overdue = req.get_param_value("overdue");
+        if (overdue == "true" || overdue == "1") query.overdue = true;
+        else if (overdue == "false" || overdue == "0") query.overdue = false;
+        else return "overdue";
+    }
+    if (req.has_param("due_before")) {
+        if (!number(req.get_param_value("due_before"), value) || value <= 1) return "due_before";
+        query.dueTo = static_cast<time_t>(value - 1);
+    }
+    return "";
+}
+
+// Tasks per chunk of GET /api/tasks/stream
+const int STREAM_PAGE_SIZE = 256;
+
+// State of one GET /api/tasks/stream response. Tasks are read one page at a
+// time, each page after the cursor of the last, and only when httplib asks
+// for the next chunk, i.e. once the previous one has been written to the
+// socket. A slow client therefore holds one page in memory, not the result.
+struct TaskStream {
+    TaskQuery query;                            // `after` moves past each page sent
+    shared_ptr<const TaskSnapshot> snapshot;    // Pinned for the whole response; null in SQLite mode
+    int remaining = -1;                         // Tasks left under the client's limit (-1 = all)
+    TaskJsonCache::FieldMask fields = TaskJsonCache::ALL_FIELDS;
+};
+
+// Helper: Write the next page of a stream as NDJSON lines; false once the
+// client has gone
+bool writeStreamPage(TaskStream& stream, DataSink& sink) {
+    TaskQuery page = stream.query;
+    page.limit = stream.remaining < 0 ? STREAM_PAGE_SIZE : min(stream.remaining, STREAM_PAGE_SIZE);
+    vector<Task> tasks;
+    if (page.limit > 0) {
+        tasks = stream.snapshot ? stream.snapshot->query(page) : taskManager->queryTasks(page);
+    }
+    if (tasks.empty()) {
+        sink.done();
+        return true;
+    }
+    
+    string lines;
+    time_t validUntil = 0;
+    for (const auto& task : tasks) {
+        lines += TaskJsonCache::toJson(task, page.now, validUntil, stream.fields);
+        lines += '\n';
+    }
+    stream.query.after = page.cursorAt(tasks.back());
+    stream.query.offset = 0;
+    if (stream.remaining > 0) {
+        stream.remaining -= static_cast<int>(tasks.size());
+    }
+    
+    if (!sink.write(lines.data(), lines.size())) {
+        return false;
+    }
+    if (static_cast<int>(tasks.size()) < page.limit) {
+        sink.done();    // A short page is the last one
+    }
+    return true;
+}
+
+// Events per chunk of GET /api/events. A quiet stream checks every
+// EVENT_POLL that its client is still connected, so a closed tab frees its
+// thread within seconds, and sends a comment every EVENT_HEARTBEAT to keep
+// proxies from timing the stream out.
+const size_t EVENT_BATCH_SIZE = 256;
+const chrono::seconds EVENT_POLL(5);
+const chrono::seconds EVENT_HEARTBEAT(15);
+
+// Position of one GET /api/events stream in the change log
+struct EventStream {
+    uint64_t after = 0;     // Last seq sent
+    bool reload = false;    // Send a reload event before anything else
+    chrono::steady_clock::time_point lastWrite = chrono::steady_clock::now();
+};
+
+// Helper: Where a client resumes the change feed. Accepts an id from
+// X-Event-Id or a previous event; false if it belongs to another run of the
+// server (or is not an id), in which case the client must reload.
+bool parseEventId(const string& id, uint64_t& seq) {
+    size_t colon = id.find(':');
+    if (colon == string::npos) return false;
+    try {
+        size_t used = 0;
+        uint64_t epoch = stoull(id.substr(0, colon), &used);
+        if (used != colon || epoch != taskManager->getChangeLog().getEpoch()) return false;
+        seq = stoull(id.substr(colon + 1), &used);
+        return used == id.size() - colon - 1;
+    } catch (const exception&) {
+        return false;
+    }
+}
+
+// Helper: Write the next events of a stream as SSE frames, waiting for one
+// if the client is up to date; false once the client has gone
+bool writeEvents(EventStream& stream, DataSink& sink) {
+    const TaskChangeLog& log = taskManager->getChangeLog();
+    vector<shared_ptr<const TaskChangeLog::Event>> events;
+    if (stream.reload || !log.since(stream.after, EVENT_BATCH_SIZE, events)) {
+        // Unknown position or fell behind the log: start over from now
+        stream.reload = false;
+        stream.after = log.latest();
+        string frame = "id: " + eventId(stream.after) + "\ndata: {\"seq\":" +
+                       to_string(stream.after) + ",\"type\":\"reload\"}\n\n";
+        return sink.write(frame.data(), frame.size());
+    }
+    
+    if (events.empty()) {
+        if (log.waitFor(stream.after, EVENT_POLL)) {
+            return true;    // Called again right away to send it
+        }
+        if (!sink.is_writable()) {
+            return false;
+        }
+        if (chrono::steady_clock::now() - stream.lastWrite < EVENT_HEARTBEAT) {
+            return true;
+        }
+        stream.lastWrite = chrono::steady_clock::now();
+        const char heartbeat[] = ":\n\n";
+        return sink.write(heartbeat, sizeof(heartbeat) - 1);
+    }
+    
+    string frames;
+    for (const auto& event : events) {
+        frames += "id: " + eventId(event->seq) + "\ndata: " + event->json + "\n\n";
+    }
+    stream.after = events.back()->seq;
+    stream.lastWrite = chrono::steady_clock::now();
+    return sink.write(frames.data(), frames.size());
+}
+
+// Helper: Answer GET /api/tasks?since=<X-Event-Id> with the tasks written and
+// the ids deleted since then. When the change log no longer covers that
+// position (too old, another server run, or a whole-list change), every task
+// is sent with "full":true, from the same cache as GET /api/tasks. Either
+// way "version" is the position to pass as `since` next time.
+void serveDelta(const Request& req, Response& res, TaskJsonCache::FieldMask fields) {
+    uint64_t after = 0;
+    uint64_t upTo = 0;
+    vector<Task> changed;
+    vector<int> deleted;
+    string body;
+    if (parseEventId(req.get_param_value("since"), after) &&
+        taskManager->getChangeLog().changesSince(after, changed, deleted, upTo)) {
+        time_t validUntil = 0;
+        body = "{\"full\":false,\"version\":\"" + eventId(upTo) + "\",\"tasks\":" +
+               TaskJsonCache::toJson(changed, time(nullptr), validUntil, fields) + ",\"deleted\":[";
+        for (size_t i = 0; i < deleted.size(); i++) {
+            if (i > 0) body += ",";
+            body += to_string(deleted[i]);
+        }
+        body += "]}";
+    } else {
+        shared_ptr<const ResponseCache::Entry> list =
+            cachedEntry("tasks/" + to_string(fields), taskListBuilder(fields));
+        upTo = list->version;
+        body = "{\"full\":true,\"version\":\"" + eventId(upTo) + "\",\"tasks\":" + list->body +
+               ",\"deleted\":[]}";
+    }
+    
+    res.set_header("X-Event-Id", eventId(upTo));
+    res.set_header("Cache-Control", "no-cache");
+    sendJson(req, res, move(body));
+}
+
+// Helper: 400 for a request body TaskRequest could not decode. Reader
+// errors never contain quotes or backslashes, so they are sent as is.
+void sendInvalidJson(Response& res, const string& error) {
+    res.status = 400;
+    res.set_content("{\"error\":\"Invalid JSON: " + error + "\"}", "application/json");
+}
+
+const size_t MAX_BATCH_OPERATIONS = 1000;
+
+// Helper: Validate one batch operation; returns an error message or ""
+string parseBatchOperation(const TaskRequest& request, TaskManager::BatchStep& step) {
+    using Kind = TaskManager::BatchStep::Kind;
+    if (!request.op) return "missing op";
+    const string& op = *request.op;
+    
+    if (op == "create") {
+        step.kind = Kind::CREATE;
+        if (!request.title || !request.description) return "missing required fields";
+        step.title = *request.title;
+        step.description = *request.description;
+        if (request.priority) step.priority = parsePriority(*request.priority);
+        return "";
+    }
+    
+    if (op == "update") step.kind = Kind::EDIT;
+    else if (op == "delete") step.kind = Kind::REMOVE;
+    else if (op == "get") step.kind = Kind::READ;
+    else return "unknown op";
+    
+    if (!request.id) return "missing id";
+    step.id = *request.id;
+    if (step.kind == Kind::EDIT) {
+        // Same fields as PUT /api/tasks/:id
+        optional<string> title = request.title;
+        bool complete = request.status == optional<string>("COMPLETED");
+        step.edit = [title, complete](Task& stored) {
+            if (title) stored.setTitle(*title);
+            if (complete) stored.markComplete();
+        };
+    }
+    return "";
+}
+
+// Helper: Result object of one applied batch operation
+string batchResultJson(const TaskManager::BatchStep& step, const optional<Task>& task) {
+    using Kind = TaskManager::BatchStep::Kind;
+    switch (step.kind) {
+        case Kind::CREATE:
+            return R"({"op":"create","status":201,"task":)" + taskToJson(*task) + "}";
+        case Kind::EDIT:
+            return R"({"op":"update","id":)" + to_string(step.id) + R"(,"status":200,"task":)" +
+                   taskToJson(*task) + "}";
+        case Kind::REMOVE:
+            return R"({"op":"delete","id":)" + to_string(step.id) + R"(,"status":200})";
+        case Kind::READ:
+        default:
+            return R"({"op":"get","id":)" + to_string(step.id) + R"(,"status":200,"task":)" +
+                   taskToJson(*task) + "}";
+    }
+}
+
 int main() {
     Server svr;
 
@@ -55,11 +486,78 @@ int main() {
     cout << "==================================" << endl;
     cout << endl;
 
-    // CORS Middleware
+    // Storage backend
+    ConfigHandler config;
+    config.applyEnvironment();
+    storageBackend = config.getStorageBackend();
+    if (storageBackend == "sqlite") {
+        taskStore.reset(new SQLiteConnectionPool("../data/tasks.db",
+                                                 config.getSqliteReadConnections(),
+                                                 config.getSqliteSynchronous()));
+        if (!taskStore->open()) {
+            cerr << "❌ Failed to open SQLite store!" << endl;
+            return 1;
+        }
+        size_t budget = static_cast<size_t>(config.getCacheMemoryMB()) * 1024 * 1024;
+        taskManager.reset(new TaskManager(*taskStore, budget, config.getCacheWriteBack()));
+        cout << "💾 SQLite store with " << config.getCacheMemoryMB() << " MB task cache" << endl;
+    } else if (storageBackend == "postgresql") {
+#ifdef HAVE_POSTGRESQL
+        postgresStore.reset(new PostgresTaskStore(config.getPostgresHost(), config.getPostgresPort(),
+                                                  config.getPostgresDatabase(), config.getPostgresUser(),
+                                                  config.getPostgresPassword()));
+        if (!postgresStore->open()) {
+            cerr << "❌ Failed to open PostgreSQL store!" << endl;
+            return 1;
+        }
+        taskManager.reset(new TaskManager(postgresStore->binding()));
+        if (!postgresStore->startListening(*taskManager)) {
+            cerr << "❌ Failed to listen for PostgreSQL changes!" << endl;
+            return 1;
+        }
+        cout << "🐘 PostgreSQL store, following changes from other processes" << endl;
+#else
+        cerr << "❌ storage_backend=postgresql needs a build with libpq" << endl;
+        return 1;
+#endif
+    } else {
+        storageBackend = "json";
+        taskManager.reset(new TaskManager());
+    }
+    writeQueue.reset(new TaskCommandQueue(*taskManager));
+    compressMinBytes = static_cast<size_t>(config.getCompressMinBytes());
+    maxEventSubscribers = max(config.getMaxEventSubscribers(), 0);
+    taskManager->setChangeLogCapacity(static_cast<size_t>(max(config.getChangeLogEvents(), 1)));
+    
+    // Event streams park a thread each, so they get threads of their own
+    // outside the worker and in-flight limits
+    requestQueue.reset(new RequestQueue(static_cast<size_t>(max(config.getServerThreads(), 1)),
+                                        static_cast<size_t>(max(config.getMaxInFlight(), 1)),
+                                        static_cast<size_t>(maxEventSubscribers)));
+    svr.new_task_queue = [] { return new AdmissionQueue(); };
+    svr.set_keep_alive_max_count(static_cast<size_t>(max(config.getKeepAliveMaxCount(), 1)));
+    svr.set_keep_alive_timeout(max(config.getKeepAliveTimeoutSec(), 0));
+    svr.set_read_timeout(max(config.getReadTimeoutSec(), 1));
+    svr.set_write_timeout(max(config.getWriteTimeoutSec(), 1));
+    // Headers and body go out in separate writes; with Nagle's algorithm the
+    // body waits for the client's delayed ACK of the headers (~40 ms)
+    svr.set_tcp_nodelay(config.getTcpNodelay());
+
+    // CORS Middleware and load shedding
     svr.set_pre_routing_handler([](const Request& req, Response& res) {
         res.set_header("Access-Control-Allow-Origin", "*");
         res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-        res.set_header("Access-Control-Allow-Headers", "Content-Type");
+        res.set_header("Access-Control-Allow-Headers", "Content-Type, If-None-Match, Last-Event-ID");
+        res.set_header("Access-Control-Expose-Headers", "ETag, X-Next-Cursor, X-Event-Id, Retry-After");
+        
+        // Over max_in_flight: answer now rather than after the backlog. The
+        // 503 closes the connection. Metrics stay readable under load.
+        if (RequestQueue::shedding() && req.path != "/api/metrics") {
+            res.status = 503;
+            res.set_header("Retry-After", "1");
+            res.set_content(R"({"error":"Server busy"})", "application/json");
+            return Server::HandlerResponse::Handled;
+        }
         
         if (req.method == "OPTIONS") {
             res.status = 204;
@@ -74,30 +572,139 @@ int main() {
             "name": "Task Manager API",
             "version": "1.0",
             "endpoints": {
-                "GET /api/tasks": "Get all tasks",
+                "GET /api/tasks": "Get all tasks; filter, sort and page with query parameters; ?since= for changes only",
+                "GET /api/tasks/stream": "Stream matching tasks as newline-delimited JSON",
                 "GET /api/tasks/:id": "Get task by ID",
                 "POST /api/tasks": "Create new task",
+                "POST /api/tasks/batch": "Apply create/update/delete/get operations atomically",
                 "PUT /api/tasks/:id": "Update task",
                 "DELETE /api/tasks/:id": "Delete task",
-                "GET /api/stats": "Get statistics"
+                "GET /api/events": "Server-Sent Events feed of task changes",
+                "GET /api/stats": "Get statistics",
+                "GET /api/metrics": "Get cache metrics"
             }
         })", "application/json");
     });
 
-    // GET /api/tasks - Get all tasks
-    svr.Get("/api/tasks", [](const Request&, Response& res) {
-        auto& tasks = taskManager.getAllTasks();
-        res.set_content(tasksToJson(tasks), "application/json");
+    // GET /api/tasks - Get all tasks, or one filtered/sorted page
+    svr.Get("/api/tasks", [](const Request& req, Response& res) {
+        TaskJsonCache::FieldMask fields;
+        if (!parseFieldsParam(req, fields)) {
+            res.status = 400;
+            res.set_content(R"({"error":"Invalid query parameter: fields"})", "application/json");
+            return;
+        }
+        
+        if (req.has_param("since")) {
+            if (req.params.size() > (req.has_param("fields") ? 2u : 1u)) {
+                res.status = 400;
+                res.set_content(R"({"error":"since can only be combined with fields"})", "application/json");
+                return;
+            }
+            serveDelta(req, res, fields);
+            return;
+        }
+        
+        if (req.params.size() > (req.has_param("fields") ? 1u : 0u)) {
+            // Evaluated by TaskManager's indexes, which stop once the page is
+            // full, so pages are cheap enough not to cache
+            TaskQuery query;
+            string invalid = parseTaskQuery(req, query);
+            if (!invalid.empty()) {
+                res.status = 400;
+                res.set_content("{\"error\":\"Invalid query parameter: " + invalid + "\"}", "application/json");
+                return;
+            }
+            
+            vector<Task> page = taskManager->queryTasks(query);
+            if (query.limit > 0 && static_cast<int>(page.size()) == query.limit) {
+                TaskCursor next = query.cursorAt(page.back());
+                res.set_header("X-Next-Cursor", to_string(next.key) + ":" + to_string(next.id));
+            }
+            time_t validUntil = 0;
+            res.set_content(TaskJsonCache::toJson(page, time(nullptr), validUntil, fields), "application/json");
+            return;
+        }
+        
+        serveCached(req, res, "tasks/" + to_string(fields), taskListBuilder(fields));
+    });
+
+    // GET /api/tasks/stream - Every matching task as newline-delimited JSON,
+    // sent in chunks from one snapshot. Takes the same parameters as
+    // GET /api/tasks; limit caps the whole stream.
+    svr.Get("/api/tasks/stream", [](const Request& req, Response& res) {
+        auto stream = make_shared<TaskStream>();
+        string invalid = parseFieldsParam(req, stream->fields) ? parseTaskQuery(req, stream->query) : "fields";
+        if (!invalid.empty()) {
+            res.status = 400;
+            res.set_content("{\"error\":\"Invalid query parameter: " + invalid + "\"}", "application/json");
+            return;
+        }
+        stream->remaining = stream->query.limit;
+        stream->query.now = stream->query.currentTime();   // One clock for filters and isOverdue
+        stream->snapshot = taskManager->getSnapshot();
+        
+        res.set_header("Cache-Control", "no-store");
+        res.set_chunked_content_provider("application/x-ndjson", [stream](size_t, DataSink& sink) {
+            return writeStreamPage(*stream, sink);
+        });
+    });
+
+    // GET /api/events - Server-Sent Events feed of task changes. Resumes
+    // after Last-Event-ID (sent by EventSource on reconnect) or `since`
+    // (X-Event-Id of a list response); otherwise starts with new changes.
+    svr.Get("/api/events", [](const Request& req, Response& res) {
+        if (++eventSubscribers > maxEventSubscribers) {
+            eventSubscribers--;
+            res.status = 503;
+            res.set_header("Retry-After", "5");
+            res.set_content(R"({"error":"Too many event subscribers"})", "application/json");
+            return;
+        }
+        // The stream holds this thread until the client leaves; stop
+        // counting it as a request in flight
+        RequestQueue::markLongLived();
+        
+        auto stream = make_shared<EventStream>();
+        string resume = req.has_header("Last-Event-ID") ? req.get_header_value("Last-Event-ID")
+                                                        : req.get_param_value("since");
+        if (resume.empty()) {
+            stream->after = taskManager->getChangeLog().latest();
+        } else {
+            stream->reload = !parseEventId(resume, stream->after);
+        }
+        
+        res.set_header("Cache-Control", "no-cache");
+        res.set_chunked_content_provider("text/event-stream",
+            [stream](size_t, DataSink& sink) {
+                return writeEvents(*stream, sink);
+            },
+            [](bool) {
+                eventSubscribers--;
+            });
     });
 
     // GET /api/tasks/:id - Get task by ID
     svr.Get(R"(/api/tasks/(\d+))", [](const Request& req, Response& res) {
         int id = stoi(req.matches[1]);
-        Task* task = taskManager.findTaskById(id);
+        TaskJsonCache::FieldMask fields;
+        if (!parseFieldsParam(req, fields)) {
+            res.status = 400;
+            res.set_content(R"({"error":"Invalid query parameter: fields"})", "application/json");
+            return;
+        }
         
-        if (task) {
-            res.set_content(taskToJson(*task), "application/json");
-        } else {
+        bool found = serveCached(req, res, "task/" + to_string(id) + "/" + to_string(fields),
+                                 [id, fields](string& body, time_t now, time_t& validUntil) {
+            optional<Task> task = taskManager->getTask(id);
+            if (!task) {
+                return false;
+            }
+            body = TaskJsonCache::toJson(*task, now, validUntil, fields);
+            return true;
+        });
+        
+        if (!found) {
             res.status = 404;
             res.set_content(R"({"error":"Task not found"})", "application/json");
         }
@@ -105,83 +712,128 @@ int main() {
 
     // POST /api/tasks - Create new task
     svr.Post("/api/tasks", [](const Request& req, Response& res) {
-        // Simple JSON parsing (for production, use a JSON library)
-        string body = req.body;
-        
-        // Extract title (basic parsing)
-        size_t titlePos = body.find("\"title\":\"");
-        size_t descPos = body.find("\"description\":\"");
-        size_t priPos = body.find("\"priority\":\"");
-        
-        if (titlePos == string::npos || descPos == string::npos) {
+        TaskRequest request;
+        string error;
+        if (!TaskRequest::parse(req.body, request, error)) {
+            sendInvalidJson(res, error);
+            return;
+        }
+        if (!request.title || !request.description) {
             res.status = 400;
             res.set_content(R"({"error":"Missing required fields"})", "application/json");
             return;
         }
+        const string& title = *request.title;
+        const string& description = *request.description;
+        Priority priority = request.priority ? parsePriority(*request.priority) : Priority::MEDIUM;
         
-        // Extract values
-        titlePos += 9;
-        size_t titleEnd = body.find("\"", titlePos);
-        string title = body.substr(titlePos, titleEnd - titlePos);
+        // Create task
+        optional<Task> task = writeQueue->submit<optional<Task>>([&](TaskManager& manager) {
+            int id = manager.addTask(title, description, priority);
+            return id > 0 ? manager.getTask(id) : nullopt;
+        }).get();
+        if (!task) {
+            res.status = 500;
+            res.set_content(R"({"error":"Failed to store task"})", "application/json");
+            return;
+        }
         
-        descPos += 15;
-        size_t descEnd = body.find("\"", descPos);
-        string description = body.substr(descPos, descEnd - descPos);
+        res.status = 201;
+        res.set_content(taskToJson(*task), "application/json");
+    });
+
+    // POST /api/tasks/batch - Apply many operations atomically. Every
+    // operation is validated first; then all run as one command on the
+    // writer thread, under one lock with one save, and are published at once.
+    // If any task is missing or the save fails, nothing is applied.
+    svr.Post("/api/tasks/batch", [](const Request& req, Response& res) {
+        vector<TaskRequest> requests;
+        string error;
+        if (!TaskRequest::parseList(req.body, requests, MAX_BATCH_OPERATIONS, error)) {
+            sendInvalidJson(res, error);
+            return;
+        }
+        if (requests.size() > MAX_BATCH_OPERATIONS) {
+            res.status = 413;
+            res.set_content("{\"error\":\"At most " + to_string(MAX_BATCH_OPERATIONS) +
+                            " operations per batch\"}", "application/json");
+            return;
+        }
         
-        Priority priority = Priority::MEDIUM;
-        if (priPos != string::npos) {
-            priPos += 12;
-            size_t priEnd = body.find("\"", priPos);
-            string priStr = body.substr(priPos, priEnd - priPos);
-            priority = parsePriority(priStr);
+        vector<TaskManager::BatchStep> steps(requests.size());
+        for (size_t i = 0; i < requests.size(); i++) {
+            string problem = parseBatchOperation(requests[i], steps[i]);
+            if (!problem.empty()) {
+                res.status = 400;
+                res.set_content("{\"error\":\"Operation " + to_string(i) + ": " + problem + "\"}",
+                                "application/json");
+                return;
+            }
         }
         
-        // Create task
-        int id = taskManager.addTask(title, description, priority);
-        Task* task = taskManager.findTaskById(id);
+        vector<optional<Task>> tasks;
+        int failedStep = -1;
+        bool applied = writeQueue->submit<bool>([&](TaskManager& manager) {
+            return manager.applyBatch(steps, tasks, failedStep);
+        }).get();
+        if (!applied && failedStep >= 0) {
+            res.status = 404;
+            res.set_content("{\"error\":\"Operation " + to_string(failedStep) + ": task not found\"}",
+                            "application/json");
+            return;
+        }
+        if (!applied) {
+            res.status = 500;
+            res.set_content(R"({"error":"Failed to store batch"})", "application/json");
+            return;
+        }
         
-        res.status = 201;
-        res.set_content(taskToJson(*task), "application/json");
+        string body = "{\"results\":[";
+        for (size_t i = 0; i < steps.size(); i++) {
+            if (i > 0) body += ",";
+            body += batchResultJson(steps[i], tasks[i]);
+        }
+        body += "]}";
+        res.set_content(body, "application/json");
     });
 
     // PUT /api/tasks/:id - Update task
     svr.Put(R"(/api/tasks/(\d+))", [](const Request& req, Response& res) {
         int id = stoi(req.matches[1]);
-        Task* task = taskManager.findTaskById(id);
         
-        if (!task) {
-            res.status = 404;
-            res.set_content(R"({"error":"Task not found"})", "application/json");
+        // Parse outside the lock; the edit itself runs under it
+        TaskRequest request;
+        string error;
+        if (!TaskRequest::parse(req.body, request, error)) {
+            sendInvalidJson(res, error);
             return;
         }
+        const optional<string>& title = request.title;
+        bool complete = request.status == optional<string>("COMPLETED");
         
-        string body = req.body;
-        
-        // Update fields if present
-        size_t titlePos = body.find("\"title\":\"");
-        if (titlePos != string::npos) {
-            titlePos += 9;
-            size_t titleEnd = body.find("\"", titlePos);
-            task->setTitle(body.substr(titlePos, titleEnd - titlePos));
-        }
+        optional<Task> task = writeQueue->submit<optional<Task>>([&](TaskManager& manager) {
+            return manager.updateTask(id, [&](Task& stored) {
+                if (title) stored.setTitle(*title);
+                if (complete) stored.markComplete();
+            });
+        }).get();
         
-        size_t statusPos = body.find("\"status\":\"");
-        if (statusPos != string::npos) {
-            statusPos += 10;
-            size_t statusEnd = body.find("\"", statusPos);
-            string statusStr = body.substr(statusPos, statusEnd - statusPos);
-            if (statusStr == "COMPLETED") task->markComplete();
+        if (!task) {
+            res.status = 404;
+            res.set_content(R"({"error":"Task not found"})", "application/json");
+            return;
         }
-        
-        taskManager.saveToFile();
         res.set_content(taskToJson(*task), "application/json");
     });
 
     // DELETE /api/tasks/:id - Delete task
     svr.Delete(R"(/api/tasks/(\d+))", [](const Request& req, Response& res) {
         int id = stoi(req.matches[1]);
+        bool deleted = writeQueue->submit<bool>([id](TaskManager& manager) {
+            return manager.deleteTask(id);
+        }).get();
         
-        if (taskManager.deleteTask(id)) {
+        if (deleted) {
             res.set_content(R"({"success":true,"message":"Task deleted"})", "application/json");
         } else {
             res.status = 404;
@@ -190,37 +842,100 @@ int main() {
     });
 
     // GET /api/stats - Get statistics
-    svr.Get("/api/stats", [](const Request&, Response& res) {
-        auto& tasks = taskManager.getAllTasks();
-        int total = tasks.size();
-        int pending = 0, inProgress = 0, completed = 0;
-        int low = 0, medium = 0, high = 0;
-        
-        for (const auto& task : tasks) {
-            switch (task.getStatus()) {
-                case Status::PENDING: pending++; break;
-                case Status::IN_PROGRESS: inProgress++; break;
-                case Status::COMPLETED: completed++; break;
-            }
-            switch (task.getPriority()) {
-                case Priority::LOW: low++; break;
-                case Priority::MEDIUM: medium++; break;
-                case Priority::HIGH: high++; break;
-            }
-        }
+    svr.Get("/api/stats", [](const Request& req, Response& res) {
+        serveCached(req, res, "stats", [](string& body, time_t, time_t&) {
+            // Counted per filter so a SQLite store answers from its indexes
+            auto countWhere = [](optional<Status> status, optional<Priority> priority) {
+                TaskQuery query;
+                query.status = status;
+                query.priority = priority;
+                return taskManager->countTasks(query);
+            };
+            int total = countWhere(nullopt, nullopt);
+            int pending = countWhere(Status::PENDING, nullopt);
+            int inProgress = countWhere(Status::IN_PROGRESS, nullopt);
+            int completed = countWhere(Status::COMPLETED, nullopt);
+            int low = countWhere(nullopt, Priority::LOW);
+            int medium = countWhere(nullopt, Priority::MEDIUM);
+            int high = countWhere(nullopt, Priority::HIGH);
+            
+            ostringstream json;
+            json << "{";
+            json << "\"total\":" << total << ",";
+            json << "\"byStatus\":{";
+            json << "\"pending\":" << pending << ",";
+            json << "\"inProgress\":" << inProgress << ",";
+            json << "\"completed\":" << completed;
+            json << "},";
+            json << "\"byPriority\":{";
+            json << "\"low\":" << low << ",";
+            json << "\"medium\":" << medium << ",";
+            json << "\"high\":" << high;
+            json << "}";
+            json << "}";
+            
+            body = json.str();
+            return true;
+        });
+    });
+
+    // GET /api/metrics - Cache, write queue and request queue counters
+    svr.Get("/api/metrics", [](const Request&, Response& res) {
+        TaskCache::Stats stats = taskManager->getCacheStats();
+        TaskCommandQueue::Stats writes = writeQueue->getStats();
+        ResponseCache::Stats responses = responseCache.getStats();
+        TaskJsonCache::Stats fragments = jsonCache.getStats();
+        RequestQueue::Stats requests = requestQueue->getStats();
         
         ostringstream json;
         json << "{";
-        json << "\"total\":" << total << ",";
-        json << "\"byStatus\":{";
-        json << "\"pending\":" << pending << ",";
-        json << "\"inProgress\":" << inProgress << ",";
-        json << "\"completed\":" << completed;
+        json << "\"storage\":\"" << storageBackend << "\",";
+        json << "\"version\":" << taskManager->getVersion() << ",";
+        json << "\"cache\":{";
+        json << "\"hits\":" << stats.hits << ",";
+        json << "\"misses\":" << stats.misses << ",";
+        json << "\"evictions\":" << stats.evictions << ",";
+        json << "\"writeBacks\":" << stats.writeBacks << ",";
+        json << "\"entries\":" << stats.entries << ",";
+        json << "\"bytes\":" << stats.bytes << ",";
+        json << "\"capacityBytes\":" << stats.capacityBytes;
+        json << "},";
+        json << "\"writeQueue\":{";
+        json << "\"submitted\":" << writes.submitted << ",";
+        json << "\"applied\":" << writes.applied << ",";
+        json << "\"batches\":" << writes.batches << ",";
+        json << "\"depth\":" << writes.depth << ",";
+        json << "\"maxDepth\":" << writes.maxDepth << ",";
+        json << "\"avgBatchSize\":" << writes.avgBatchSize << ",";
+        json << "\"avgQueueWaitMicros\":" << writes.avgQueueWaitMicros << ",";
+        json << "\"maxQueueWaitMicros\":" << writes.maxQueueWaitMicros << ",";
+        json << "\"avgBatchMicros\":" << writes.avgBatchMicros << ",";
+        json << "\"maxBatchMicros\":" << writes.maxBatchMicros;
+        json << "},";
+        json << "\"responseCache\":{";
+        json << "\"hits\":" << responses.hits << ",";
+        json << "\"misses\":" << responses.misses << ",";
+        json << "\"evictions\":" << responses.evictions << ",";
+        json << "\"entries\":" << responses.entries << ",";
+        json << "\"bytes\":" << responses.bytes;
+        json << "},";
+        json << "\"jsonFragments\":{";
+        json << "\"hits\":" << fragments.hits << ",";
+        json << "\"misses\":" << fragments.misses << ",";
+        json << "\"entries\":" << fragments.entries;
         json << "},";
-        json << "\"byPriority\":{";
-        json << "\"low\":" << low << ",";
-        json << "\"medium\":" << medium << ",";
-        json << "\"high\":" << high;
+        json << "\"requests\":{";
+        json << "\"admitted\":" << requests.admitted << ",";
+        json << "\"shed\":" << requests.shed << ",";
+        json << "\"refused\":" << requests.refused << ",";
+        json << "\"running\":" << requests.running << ",";
+        json << "\"queued\":" << requests.queued << ",";
+        json << "\"maxQueued\":" << requests.maxQueued << ",";
+        json << "\"eventStreams\":" << requests.longLived << ",";
+        json << "\"threads\":" << requests.threads << ",";
+        json << "\"avgQueueWaitMicros\":" << requests.avgQueueWaitMicros << ",";
+        json << "\"p99QueueWaitMicros\":" << requests.p99QueueWaitMicros << ",";
+        json << "\"maxQueueWaitMicros\":" << requests.maxQueueWaitMicros;
         json << "}";
         json << "}";
         
@@ -228,17 +943,23 @@ int main() {
     });
 
     // Start server
-    const char* host = "0.0.0.0";
-    int port = 8080;
+    string host = config.getHost();
+    int port = config.getPort();
     
     cout << "🚀 Server starting on http://" << host << ":" << port << endl;
     cout << "📋 API endpoints available:" << endl;
     cout << "   GET    /api/tasks       - List all tasks" << endl;
+    cout << "   GET    /api/tasks/stream - Stream tasks as NDJSON" << endl;
     cout << "   GET    /api/tasks/:id   - Get task by ID" << endl;
     cout << "   POST   /api/tasks       - Create task" << endl;
+    cout << "   POST   /api/tasks/batch - Batch create/update/delete/get" << endl;
     cout << "   PUT    /api/tasks/:id   - Update task" << endl;
     cout << "   DELETE /api/tasks/:id   - Delete task" << endl;
+    cout << "   GET    /api/events      - Task change feed (SSE)" << endl;
     cout << "   GET    /api/stats       - Get statistics" << endl;
+    cout << "   GET    /api/metrics     - Get cache metrics" << endl;
+    cout << "⚙️  " << max(config.getServerThreads(), 1) << " workers, "
+         << max(config.getMaxInFlight(), 1) << " requests in flight max" << endl;
     cout << "\nPress Ctrl+C to stop the server..." << endl;
     cout << endl;
 
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include "ConfigHandler.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+class ConfigHandlerTest : public ::testing::Test {
+protected:
+    const string configPath = "test_config.ini";
+
+    void SetUp() override {
+        std::filesystem::remove(configPath);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(configPath);
+        unsetenv("PORT");
+        unsetenv("TASK_API_SERVER_THREADS");
+    }
+};
+
+// Test unparsable, overflowing and non-positive numbers fall back to the
+// default instead of throwing
+TEST_F(ConfigHandlerTest, InvalidNumbersUseDefaults) {
+    {
+        ofstream file(configPath);
+        file << "max_in_flight=0\n";
+        file << "read_timeout_sec=-5\n";
+        file << "change_log_events=12x\n";
+        file << "keep_alive_max_count=250\n";
+    }
+    ConfigHandler config(configPath);
+    setenv("PORT", "abc", 1);
+    setenv("TASK_API_SERVER_THREADS", "99999999999", 1);
+    config.applyEnvironment();
+
+    EXPECT_EQ(config.getPort(), 8080);
+    EXPECT_EQ(config.getServerThreads(), 16);
+    EXPECT_EQ(config.getMaxInFlight(), 256);
+    EXPECT_EQ(config.getReadTimeoutSec(), 5);
+    EXPECT_EQ(config.getChangeLogEvents(), 4096);
+    EXPECT_EQ(config.getKeepAliveMaxCount(), 250);
+}
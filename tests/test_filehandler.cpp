@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "FileHandler.hpp"
+#include <filesystem>
+
+class FileHandlerTest : public ::testing::Test {
+protected:
+    const string filePath = "test_filehandler.json";
+
+    void TearDown() override {
+        std::filesystem::remove(filePath);
+    }
+};
+
+// Test streaming returns every task with its stored fields, in file order
+TEST_F(FileHandlerTest, StreamKeepsAllFields) {
+    vector<Task> tasks;
+    for (int i = 1; i <= 3; i++) {
+        Task task(i * 10, "Title \"" + to_string(i) + "\"", "Desc", Priority::HIGH);
+        task.setStatus(Status::COMPLETED);
+        task.setCreatedAt(1700000000 + i);
+        task.setDueDate(1800000000 + i);
+        tasks.push_back(task);
+    }
+
+    FileHandler handler(filePath);
+    ASSERT_TRUE(handler.saveTasks(tasks, 31));
+
+    vector<Task> streamed;
+    int nextId = 0;
+    ASSERT_TRUE(handler.streamTasks([&streamed](const Task& task) {
+        streamed.push_back(task);
+        return streamed.size() < 2;  // Stop after two tasks
+    }, nextId));
+
+    ASSERT_EQ(streamed.size(), 2u);
+    EXPECT_EQ(nextId, 31);
+    EXPECT_EQ(streamed[1].getId(), 20);
+    EXPECT_EQ(streamed[1].getTitle(), "Title \"2\"");
+    EXPECT_EQ(streamed[1].getStatus(), Status::COMPLETED);
+    EXPECT_EQ(streamed[1].getCreatedAt(), 1700000002);
+    EXPECT_EQ(streamed[1].getDueDate(), 1800000002);
+
+    vector<Task> loaded;
+    ASSERT_TRUE(handler.loadTasks(loaded, nextId));
+    EXPECT_EQ(loaded.size(), 3u);
+}
+
+// Test text with line breaks and other control characters survives a save,
+// since the loader reads one field per line
+TEST_F(FileHandlerTest, ControlCharactersRoundTrip) {
+    const string title = "Line 1\nLine 2\t\"quoted\" \\ end";
+    const string description = string("Bell\x07 and \x1f") + " caf\xc3\xa9";
+    vector<Task> tasks = {Task(1, title, description), Task(2, "Next", "Desc")};
+
+    FileHandler handler(filePath);
+    ASSERT_TRUE(handler.saveTasks(tasks, 3));
+
+    vector<Task> loaded;
+    int nextId = 0;
+    ASSERT_TRUE(handler.loadTasks(loaded, nextId));
+    ASSERT_EQ(loaded.size(), 2u);
+    EXPECT_EQ(loaded[0].getTitle(), title);
+    EXPECT_EQ(loaded[0].getDescription(), description);
+    EXPECT_EQ(loaded[1].getTitle(), "Next");
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "JsonReader.hpp"
+#include "TaskRequest.hpp"
+#include "TaskJsonCache.hpp"
+
+// Records every callback as text, and whether strings pointed into the input
+class RecordingHandler : public JsonHandler {
+public:
+    string_view input;
+    vector<string> events;
+    int views = 0;
+
+    bool startObject() override { events.push_back("{"); return true; }
+    bool endObject() override { events.push_back("}"); return true; }
+    bool startArray() override { events.push_back("["); return true; }
+    bool endArray() override { events.push_back("]"); return true; }
+    bool key(string_view name) override { return text("key:", name); }
+    bool stringValue(string_view value) override { return text("str:", value); }
+    bool numberValue(string_view text) override { events.push_back("num:" + string(text)); return true; }
+    bool boolValue(bool value) override { events.push_back(value ? "true" : "false"); return true; }
+    bool nullValue() override { events.push_back("null"); return true; }
+
+private:
+    bool text(const string& kind, string_view value) {
+        if (value.data() >= input.data() && value.data() < input.data() + input.size()) {
+            views++;
+        }
+        events.push_back(kind + string(value));
+        return true;
+    }
+};
+
+// Test tokens arrive in order, escapes are decoded and plain strings are not copied
+TEST(JsonReaderTest, ReportsTokensAndDecodesEscapes) {
+    string json = " { \"b\" : [1, -2.5e3, true, false, null],\n"
+                  "   \"a\\\"q\":\"line\\nbreak \\u00e9 \\ud83d\\ude00 \\/\" } ";
+    RecordingHandler handler;
+    handler.input = json;
+    string error;
+
+    ASSERT_TRUE(JsonReader::parse(json, handler, error)) << error;
+    vector<string> expected = {"{", "key:b", "[", "num:1", "num:-2.5e3", "true", "false", "null", "]",
+                               "key:a\"q", "str:line\nbreak \xc3\xa9 \xf0\x9f\x98\x80 /", "}"};
+    EXPECT_EQ(handler.events, expected);
+    EXPECT_EQ(handler.views, 1);    // Only "b" had no escapes
+}
+
+// Test malformed documents are rejected with the offending byte
+TEST(JsonReaderTest, RejectsMalformedInput) {
+    const char* bad[] = {
+        "", "{", "{\"a\":1,}", "{\"a\" 1}", "{'a':1}", "[1 2]", "[01]", "[1.]", "[-]",
+        "[\"tab\there\"]", "[\"\\x\"]", "[\"\\ud800\"]", "[\"open]", "[tru]", "{} {}", "{\"a\":1}x"
+    };
+    for (const char* json : bad) {
+        JsonHandler handler;
+        string error;
+        EXPECT_FALSE(JsonReader::parse(json, handler, error)) << json;
+        EXPECT_NE(error.find("at byte"), string::npos) << json;
+    }
+
+    string deep(JsonReader::MAX_DEPTH + 1, '[');
+    deep += string(JsonReader::MAX_DEPTH + 1, ']');
+    JsonHandler handler;
+    string error;
+    EXPECT_FALSE(JsonReader::parse(deep, handler, error));
+    EXPECT_NE(error.find("nesting too deep"), string::npos);
+}
+
+// Test request bodies decode regardless of member order and whitespace, and
+// that API output parses back to the stored text
+TEST(JsonReaderTest, DecodesTaskRequests) {
+    TaskRequest request;
+    string error;
+    ASSERT_TRUE(TaskRequest::parse("{\n  \"priority\": \"HIGH\", \"extra\": {\"title\": 1},\n"
+                                   "  \"description\": null, \"title\" : \"Say \\\"hi\\\"\" }",
+                                   request, error)) << error;
+    EXPECT_EQ(request.title, optional<string>("Say \"hi\""));
+    EXPECT_EQ(request.priority, optional<string>("HIGH"));
+    EXPECT_FALSE(request.description);
+    EXPECT_FALSE(request.id);
+
+    EXPECT_FALSE(TaskRequest::parse("{\"title\":5}", request, error));
+    EXPECT_NE(error.find("title must be a string"), string::npos);
+    EXPECT_FALSE(TaskRequest::parse("[]", request, error));
+    EXPECT_NE(error.find("expected a JSON object"), string::npos);
+
+    vector<TaskRequest> requests;
+    ASSERT_TRUE(TaskRequest::parseList("[{\"op\":\"get\",\"id\":7}, {\"id\":8,\"op\":\"delete\"}]",
+                                       requests, 10, error)) << error;
+    ASSERT_EQ(requests.size(), 2u);
+    EXPECT_EQ(requests[1].id, optional<int>(8));
+    EXPECT_EQ(requests[1].op, optional<string>("delete"));
+
+    EXPECT_FALSE(TaskRequest::parseList("[{\"op\":\"get\"},{\"id\":1.5}]", requests, 10, error));
+    EXPECT_NE(error.find("item 1: id must be an integer"), string::npos);
+    EXPECT_FALSE(TaskRequest::parseList("[1]", requests, 10, error));
+
+    // Reading stops at maxCount + 1, even if the rest is malformed
+    ASSERT_TRUE(TaskRequest::parseList("[{},{},{},{\"id\":", requests, 2, error));
+    EXPECT_EQ(requests.size(), 3u);
+
+    Task task(1, "Tab\there \"q\" \\", string("Line\nbreak\x01"));
+    time_t validUntil = 0;
+    ASSERT_TRUE(TaskRequest::parse(TaskJsonCache::toJson(task, 0, validUntil), request, error)) << error;
+    EXPECT_EQ(request.title, optional<string>(task.getTitle()));
+    EXPECT_EQ(request.description, optional<string>(task.getDescription()));
+}
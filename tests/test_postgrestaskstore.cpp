@@ -0,0 +1,108 @@
+// Needs a PostgreSQL server: PGHOST, PGPORT, PGUSER and PGPASSWORD as for
+// psql, and PGDATABASE (default taskmanager_test), whose task tables are
+// dropped and recreated. Skipped when no server is reachable.
+#ifdef HAVE_POSTGRESQL
+
+#include <gtest/gtest.h>
+#include "PostgresTaskStore.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+static string envOr(const char* name, const string& fallback) {
+    const char* value = getenv(name);
+    return value && *value ? value : fallback;
+}
+
+class PostgresTaskStoreTest : public ::testing::Test {
+protected:
+    const string host = envOr("PGHOST", "localhost");
+    const string port = envOr("PGPORT", "5432");
+    const string dbname = envOr("PGDATABASE", "taskmanager_test");
+    const string user = envOr("PGUSER", "postgres");
+    const string password = envOr("PGPASSWORD", "");
+
+    // Stands in for another process writing to the same database
+    unique_ptr<DatabaseHandler> other;
+
+    void SetUp() override {
+        other.reset(new DatabaseHandler(host, port, dbname, user, password));
+        if (!other->connect()) {
+            GTEST_SKIP() << "No PostgreSQL server at " << host << ":" << port << "/" << dbname;
+        }
+        ASSERT_TRUE(other->dropSchema());
+        ASSERT_TRUE(other->createSchema());
+        ASSERT_TRUE(other->saveTasks({}, 1));
+    }
+
+    // Notifications arrive asynchronously
+    bool waitFor(const function<bool()>& done) {
+        auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+        while (!done()) {
+            if (chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            this_thread::sleep_for(chrono::milliseconds(20));
+        }
+        return true;
+    }
+};
+
+// Test the manager saves its writes and follows other processes' writes
+TEST_F(PostgresTaskStoreTest, SavesAndFollowsOtherWriters) {
+    PostgresTaskStore store(host, port, dbname, user, password);
+    ASSERT_TRUE(store.open());
+    TaskManager manager(store.binding());
+    ASSERT_TRUE(store.startListening(manager));
+
+    int id = manager.addTask("Write report", "Q3 numbers", Priority::HIGH);
+    optional<Task> saved = other->getTaskById(id);
+    ASSERT_TRUE(saved.has_value());
+    EXPECT_EQ(saved->getTitle(), "Write report");
+    EXPECT_EQ(saved->getPriority(), Priority::HIGH);
+
+    // Our own write is not echoed back as a new version
+    uint64_t version = manager.getVersion();
+    this_thread::sleep_for(chrono::milliseconds(300));
+    EXPECT_EQ(manager.getVersion(), version);
+
+    ASSERT_TRUE(manager.deleteTask(id));
+    EXPECT_FALSE(other->getTaskById(id).has_value());
+
+    // Row writes from elsewhere are patched in
+    int remote = other->insertTask(Task(0, "Remote", "From psql", Priority::LOW));
+    ASSERT_GT(remote, id);
+    EXPECT_TRUE(waitFor([&] { return manager.getTask(remote).has_value(); }));
+    ASSERT_TRUE(other->deleteTask(remote));
+    EXPECT_TRUE(waitFor([&] { return !manager.getTask(remote).has_value(); }));
+
+    // A bulk save elsewhere makes the manager reload
+    ASSERT_TRUE(other->saveTasks({Task(50, "Bulk", "Imported", Priority::MEDIUM)}, 51));
+    EXPECT_TRUE(waitFor([&] { return manager.getTask(50).has_value(); }));
+    EXPECT_EQ(manager.getTaskCount(), 1);
+    store.stop();
+}
+
+// Test a group commit reaches the database in one save
+TEST_F(PostgresTaskStoreTest, GroupCommitSavesOnce) {
+    PostgresTaskStore store(host, port, dbname, user, password);
+    ASSERT_TRUE(store.open());
+    TaskManager manager(store.binding());
+
+    manager.beginBatch();
+    int first = manager.addTask("One", "", Priority::LOW);
+    manager.addTask("Two", "", Priority::LOW);
+    ASSERT_TRUE(manager.updateTask(first, [](Task& task) { task.markComplete(); }).has_value());
+    EXPECT_TRUE(other->getAllTasks().empty());
+    ASSERT_TRUE(manager.endBatch());
+
+    vector<Task> rows = other->getAllTasks();
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0].getStatus(), Status::COMPLETED);
+
+    // Reloading keeps what was saved
+    ASSERT_TRUE(manager.loadFromFile());
+    EXPECT_EQ(manager.getTaskCount(), 2);
+}
+
+#endif // HAVE_POSTGRESQL
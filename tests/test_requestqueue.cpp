@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "RequestQueue.hpp"
+#include <atomic>
+#include <future>
+
+// Test jobs past the in-flight limit skip the queue and run shed, and that
+// the wait of a queued job is recorded
+TEST(RequestQueueTest, ShedsPastInFlightLimit) {
+    RequestQueue queue(1, 2);
+    promise<void> started, release;
+    shared_future<void> released = release.get_future().share();
+    atomic<int> shedRuns(0);
+    promise<bool> secondShed, thirdShed;
+
+    ASSERT_TRUE(queue.enqueue([&]() {
+        started.set_value();
+        released.wait();
+    }));
+    started.get_future().wait();
+    ASSERT_TRUE(queue.enqueue([&]() { secondShed.set_value(RequestQueue::shedding()); }));
+    ASSERT_TRUE(queue.enqueue([&]() {
+        shedRuns++;
+        thirdShed.set_value(RequestQueue::shedding());
+    }));
+
+    // The shed job runs while the worker is still busy
+    EXPECT_TRUE(thirdShed.get_future().get());
+    RequestQueue::Stats stats = queue.getStats();
+    EXPECT_EQ(stats.admitted, 2u);
+    EXPECT_EQ(stats.shed, 1u);
+    EXPECT_EQ(stats.running, 1u);
+    EXPECT_EQ(stats.queued, 1u);
+
+    this_thread::sleep_for(chrono::milliseconds(20));
+    release.set_value();
+    EXPECT_FALSE(secondShed.get_future().get());
+    queue.shutdown();
+
+    stats = queue.getStats();
+    EXPECT_EQ(shedRuns, 1);
+    EXPECT_GE(stats.maxQueueWaitMicros, 20000.0);
+    EXPECT_GE(stats.p99QueueWaitMicros, stats.maxQueueWaitMicros);
+    EXPECT_FALSE(RequestQueue::shedding());
+}
+
+// Test a long-lived job gives back its worker and in-flight slot, and that
+// its replacement thread is started only then and exits afterwards
+TEST(RequestQueueTest, LongLivedJobsFreeTheirSlot) {
+    RequestQueue queue(1, 1, 1);
+    EXPECT_EQ(queue.getStats().threads, 1u);
+    promise<void> streaming, release, done;
+    shared_future<void> released = release.get_future().share();
+
+    ASSERT_TRUE(queue.enqueue([&]() {
+        RequestQueue::markLongLived();
+        streaming.set_value();
+        released.wait();
+    }));
+    streaming.get_future().wait();
+    EXPECT_EQ(queue.getStats().threads, 2u);
+
+    promise<bool> shed;
+    ASSERT_TRUE(queue.enqueue([&]() { shed.set_value(RequestQueue::shedding()); }));
+    EXPECT_FALSE(shed.get_future().get());
+    EXPECT_EQ(queue.getStats().longLived, 1u);
+    EXPECT_EQ(queue.getStats().shed, 0u);
+
+    // Past the long-lived limit no further thread is started
+    promise<void> second, releaseSecond;
+    shared_future<void> secondReleased = releaseSecond.get_future().share();
+    ASSERT_TRUE(queue.enqueue([&]() {
+        RequestQueue::markLongLived();
+        second.set_value();
+        secondReleased.wait();
+    }));
+    second.get_future().wait();
+    EXPECT_EQ(queue.getStats().threads, 2u);
+    releaseSecond.set_value();
+
+    release.set_value();
+    queue.shutdown();
+    EXPECT_EQ(queue.getStats().longLived, 0u);
+    EXPECT_EQ(queue.getStats().running, 0u);
+    EXPECT_EQ(queue.getStats().threads, 1u);
+}
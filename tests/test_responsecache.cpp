@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "ResponseCache.hpp"
+#include <zlib.h>
+
+// Test entries are served only for their version and dropped by newer ones
+TEST(ResponseCacheTest, InvalidatedByNewerVersion) {
+    ResponseCache cache;
+    cache.put("tasks", 3, 0, "[1]");
+    cache.put("stats", 3, 0, "{}");
+
+    ASSERT_NE(cache.get("tasks", 3, 1000), nullptr);
+    EXPECT_EQ(cache.get("tasks", 3, 1000)->body, "[1]");
+    EXPECT_EQ(cache.get("tasks", 4, 1000), nullptr);
+
+    cache.put("tasks", 4, 0, "[1,2]");
+    EXPECT_EQ(cache.get("stats", 3, 1000), nullptr);     // Older entries gone
+    EXPECT_EQ(cache.getStats().entries, 1u);
+
+    // A body built from a stale version is not stored over a newer one
+    cache.put("stats", 2, 0, "{old}");
+    EXPECT_EQ(cache.get("stats", 2, 1000), nullptr);
+}
+
+// Test clock-dependent bodies expire when a task turns overdue
+TEST(ResponseCacheTest, ExpiresAtValidUntil) {
+    ResponseCache cache;
+    cache.put("task/1", 1, 2000, "{\"isOverdue\":false}");
+
+    EXPECT_NE(cache.get("task/1", 1, 1999), nullptr);
+    EXPECT_EQ(cache.get("task/1", 1, 2000), nullptr);
+}
+
+// Test ETags follow the body and match If-None-Match lists
+TEST(ResponseCacheTest, ETagMatching) {
+    string etag = ResponseCache::makeETag("[1,2]");
+    EXPECT_EQ(etag, ResponseCache::makeETag("[1,2]"));
+    EXPECT_NE(etag, ResponseCache::makeETag("[1,3]"));
+
+    EXPECT_TRUE(ResponseCache::matchesETag(etag, etag));
+    EXPECT_TRUE(ResponseCache::matchesETag("\"abc\", W/" + etag, etag));
+    EXPECT_TRUE(ResponseCache::matchesETag("*", etag));
+    EXPECT_FALSE(ResponseCache::matchesETag("\"abc\"", etag));
+}
+
+// Test Accept-Encoding negotiation, including q=0 refusals
+TEST(ResponseCacheTest, NegotiatesEncoding) {
+    using Encoding = ResponseCache::Encoding;
+    EXPECT_EQ(ResponseCache::negotiate(""), Encoding::IDENTITY);
+    EXPECT_EQ(ResponseCache::negotiate("gzip, deflate, br"), Encoding::GZIP);
+    EXPECT_EQ(ResponseCache::negotiate("deflate"), Encoding::DEFLATE);
+    EXPECT_EQ(ResponseCache::negotiate("gzip;q=0.5, deflate"), Encoding::DEFLATE);
+    EXPECT_EQ(ResponseCache::negotiate("gzip;q=0"), Encoding::IDENTITY);
+    EXPECT_EQ(ResponseCache::negotiate("br, *"), Encoding::GZIP);
+    EXPECT_EQ(ResponseCache::negotiate("gzip;q=0.5, identity"), Encoding::IDENTITY);
+
+    // * only weighs codings that are not listed
+    EXPECT_EQ(ResponseCache::negotiate("gzip;q=0, *"), Encoding::DEFLATE);
+    EXPECT_EQ(ResponseCache::negotiate("gzip;q=0, deflate;q=0, *"), Encoding::IDENTITY);
+    EXPECT_EQ(ResponseCache::negotiate("*;q=0, deflate"), Encoding::DEFLATE);
+
+    // identity;q=0 refuses an uncompressed body
+    EXPECT_FALSE(ResponseCache::refusesIdentity("gzip, deflate"));
+    EXPECT_TRUE(ResponseCache::refusesIdentity("identity;q=0"));
+    EXPECT_TRUE(ResponseCache::refusesIdentity("gzip, *;q=0"));
+    EXPECT_FALSE(ResponseCache::refusesIdentity("identity, *;q=0"));
+    EXPECT_EQ(ResponseCache::negotiate("deflate;q=0.2, identity;q=0"), Encoding::DEFLATE);
+    EXPECT_EQ(ResponseCache::negotiate("identity;q=0"), Encoding::IDENTITY);
+
+    string etag = ResponseCache::makeETag("[1]");
+    EXPECT_EQ(ResponseCache::encodedETag(etag, Encoding::IDENTITY), etag);
+    EXPECT_NE(ResponseCache::encodedETag(etag, Encoding::GZIP), etag);
+    EXPECT_FALSE(ResponseCache::matchesETag(ResponseCache::encodedETag(etag, Encoding::GZIP), etag));
+}
+
+// Test compressed bodies inflate back to the original and are kept on the entry
+TEST(ResponseCacheTest, CompressesBodyOnce) {
+    string body = "[";
+    for (int i = 0; i < 200; i++) {
+        body += "{\"id\":" + to_string(i) + ",\"title\":\"Task\",\"status\":\"Pending\"},";
+    }
+    body += "{}]";
+
+    ResponseCache cache;
+    auto entry = cache.put("tasks", 1, 0, body);
+    const string& gzipped = entry->compressed(ResponseCache::Encoding::GZIP);
+    ASSERT_FALSE(gzipped.empty());
+    EXPECT_LT(gzipped.size(), body.size() / 4);
+    EXPECT_EQ(&gzipped, &entry->compressed(ResponseCache::Encoding::GZIP));
+    EXPECT_EQ(static_cast<unsigned char>(gzipped[0]), 0x1f);     // gzip magic
+
+    // 15+32 lets inflate detect either the gzip or the zlib wrapper
+    for (auto encoding : {ResponseCache::Encoding::GZIP, ResponseCache::Encoding::DEFLATE}) {
+        const string& packed = entry->compressed(encoding);
+        string inflated(body.size(), '\0');
+        z_stream stream = {};
+        ASSERT_EQ(inflateInit2(&stream, 15 + 32), Z_OK);
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(packed.data()));
+        stream.avail_in = packed.size();
+        stream.next_out = reinterpret_cast<Bytef*>(&inflated[0]);
+        stream.avail_out = inflated.size();
+        EXPECT_EQ(inflate(&stream, Z_FINISH), Z_STREAM_END);
+        inflateEnd(&stream);
+        EXPECT_EQ(inflated, body);
+    }
+}
+
+// Test entries of one version are capped by count and bytes, least recently
+// used first
+TEST(ResponseCacheTest, EvictsLeastRecentlyUsed) {
+    ResponseCache cache(3, 1024 * 1024);
+    cache.put("task/1", 1, 0, "{1}");
+    cache.put("task/2", 1, 0, "{2}");
+    cache.put("task/3", 1, 0, "{3}");
+    ASSERT_NE(cache.get("task/1", 1, 1000), nullptr);   // task/2 is now oldest
+    cache.put("task/4", 1, 0, "{4}");
+
+    EXPECT_EQ(cache.get("task/2", 1, 1000), nullptr);
+    EXPECT_NE(cache.get("task/1", 1, 1000), nullptr);
+    EXPECT_NE(cache.get("task/4", 1, 1000), nullptr);
+    EXPECT_EQ(cache.getStats().entries, 3u);
+    EXPECT_EQ(cache.getStats().evictions, 1u);
+
+    ResponseCache small(100, 2048);
+    for (int i = 0; i < 10; i++) {
+        small.put("list/" + to_string(i), 1, 0, string(600, 'x'));
+    }
+    EXPECT_LE(small.getStats().bytes, 2048u);
+    EXPECT_LT(small.getStats().entries, 4u);
+    EXPECT_NE(small.get("list/9", 1, 1000), nullptr);
+
+    // One body past the budget is still kept on its own
+    small.put("big", 1, 0, string(4096, 'x'));
+    EXPECT_EQ(small.getStats().entries, 1u);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "SQLiteConnectionPool.hpp"
+#include <atomic>
+#include <filesystem>
+#include <thread>
+
+class SQLiteConnectionPoolTest : public ::testing::Test {
+protected:
+    const string dbPath = "test_connectionpool.db";
+
+    void removeDatabaseFiles() {
+        std::filesystem::remove(dbPath);
+        std::filesystem::remove(dbPath + "-wal");
+        std::filesystem::remove(dbPath + "-shm");
+    }
+
+    void SetUp() override {
+        removeDatabaseFiles();
+    }
+
+    void TearDown() override {
+        removeDatabaseFiles();
+    }
+};
+
+// Test readers see committed writes and cannot modify the database
+TEST_F(SQLiteConnectionPoolTest, ReadersSeeWriterCommits) {
+    SQLiteConnectionPool pool(dbPath, 2);
+    ASSERT_TRUE(pool.open());
+
+    {
+        auto writer = pool.acquireWriter();
+        EXPECT_GT(writer->insertTask(Task(0, "Pooled", "Desc", Priority::HIGH)), 0);
+    }
+
+    auto reader = pool.acquireReader();
+    EXPECT_TRUE(reader->isReadOnly());
+    EXPECT_EQ(reader->getAllTasks().size(), 1u);
+    EXPECT_LT(reader->insertTask(Task(0, "Rejected", "Desc", Priority::LOW)), 0);
+}
+
+// Test concurrent readers and a writer never observe a torn save
+TEST_F(SQLiteConnectionPoolTest, ConcurrentReadersAndWriter) {
+    SQLiteConnectionPool pool(dbPath, 4);
+    ASSERT_TRUE(pool.open());
+
+    atomic<bool> done(false);
+    atomic<int> badReads(0);
+
+    thread writerThread([&] {
+        for (int round = 1; round <= 20; round++) {
+            vector<Task> tasks;
+            for (int i = 1; i <= 50; i++) {
+                tasks.emplace_back(i, "Round " + to_string(round), "Desc", Priority::MEDIUM);
+            }
+            auto writer = pool.acquireWriter();
+            writer->saveTasks(tasks, 51);
+        }
+        done = true;
+    });
+
+    vector<thread> readers;
+    for (int r = 0; r < 8; r++) {
+        readers.emplace_back([&] {
+            while (!done) {
+                auto reader = pool.acquireReader();
+                vector<Task> tasks = reader->getAllTasks();
+                for (const auto& task : tasks) {
+                    if (task.getTitle() != tasks.front().getTitle()) {
+                        badReads++;
+                        break;
+                    }
+                }
+            }
+        });
+    }
+
+    writerThread.join();
+    for (auto& t : readers) t.join();
+
+    EXPECT_EQ(badReads.load(), 0);
+}
@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+#include "SQLiteHandler.hpp"
+#include <filesystem>
+
+class SQLiteHandlerTest : public ::testing::Test {
+protected:
+    const string dbPath = "test_sqlitehandler.db";
+    SQLiteHandler* db;
+
+    void removeDatabaseFiles() {
+        std::filesystem::remove(dbPath);
+        std::filesystem::remove(dbPath + "-wal");
+        std::filesystem::remove(dbPath + "-shm");
+    }
+
+    void SetUp() override {
+        removeDatabaseFiles();
+        db = new SQLiteHandler(dbPath);
+        ASSERT_TRUE(db->connect());
+    }
+
+    void TearDown() override {
+        delete db;
+        removeDatabaseFiles();
+    }
+
+    vector<Task> makeTasks(int count) {
+        vector<Task> tasks;
+        for (int i = 1; i <= count; i++) {
+            Task task(i, "Task " + to_string(i), "Description " + to_string(i),
+                      i % 2 == 0 ? Priority::HIGH : Priority::LOW);
+            task.setCreatedAt(1700000000 + i);
+            tasks.push_back(task);
+        }
+        return tasks;
+    }
+};
+
+// Test save/load round trip keeps ids and all fields
+TEST_F(SQLiteHandlerTest, SaveLoadRoundTrip) {
+    vector<Task> tasks = makeTasks(3);
+    tasks[1].setStatus(Status::IN_PROGRESS);
+    tasks[2].setDueDate(1800000000);
+
+    ASSERT_TRUE(db->saveTasks(tasks, 4));
+
+    vector<Task> loaded;
+    int nextId = 0;
+    ASSERT_TRUE(db->loadTasks(loaded, nextId));
+
+    ASSERT_EQ(loaded.size(), 3u);
+    EXPECT_EQ(nextId, 4);
+    EXPECT_EQ(loaded[1].getId(), 2);
+    EXPECT_EQ(loaded[1].getStatus(), Status::IN_PROGRESS);
+    EXPECT_EQ(loaded[1].getPriority(), Priority::HIGH);
+    EXPECT_EQ(loaded[1].getCreatedAt(), 1700000002);
+    EXPECT_EQ(loaded[2].getDueDate(), 1800000000);
+}
+
+// Test saving again updates changed rows and removes missing ids
+TEST_F(SQLiteHandlerTest, SaveDiffsAgainstStoredRows) {
+    vector<Task> tasks = makeTasks(5);
+    ASSERT_TRUE(db->saveTasks(tasks, 6));
+
+    tasks.erase(tasks.begin() + 1);        // drop id 2
+    tasks[0].setTitle("Renamed");          // change id 1
+    ASSERT_TRUE(db->saveTasks(tasks, 6));
+
+    vector<Task> loaded = db->getAllTasks();
+    ASSERT_EQ(loaded.size(), 4u);
+    EXPECT_EQ(loaded[0].getTitle(), "Renamed");
+    EXPECT_EQ(loaded[1].getId(), 3);
+}
+
+// Test quotes in text survive insert and update
+TEST_F(SQLiteHandlerTest, QuotedTextIsStoredVerbatim) {
+    Task task(1, "It's done", "Say \"hi\"", Priority::MEDIUM);
+    int id = db->insertTask(task);
+    ASSERT_GT(id, 0);
+
+    vector<Task> loaded = db->getAllTasks();
+    ASSERT_EQ(loaded.size(), 1u);
+    EXPECT_EQ(loaded[0].getTitle(), "It's done");
+    EXPECT_EQ(loaded[0].getDescription(), "Say \"hi\"");
+}
+
+// Test synchronous level validation
+TEST_F(SQLiteHandlerTest, SynchronousLevel) {
+    EXPECT_TRUE(db->setSynchronous("full"));
+    EXPECT_EQ(db->getSynchronous(), "FULL");
+    EXPECT_FALSE(db->setSynchronous("sometimes"));
+    EXPECT_EQ(db->getSynchronous(), "FULL");
+}
+
+// Test filters, sort order and paging are applied in SQL
+TEST_F(SQLiteHandlerTest, QueryFilterSortAndPage) {
+    vector<Task> tasks = makeTasks(10);
+    for (auto& task : tasks) {
+        task.setDueDate(1800000000 - task.getId() * 100);
+    }
+    ASSERT_TRUE(db->saveTasks(tasks, 11));
+
+    TaskQuery query;
+    query.priority = Priority::HIGH;
+    query.sortBy = TaskSortField::DUE_DATE;
+    query.limit = 2;
+    query.offset = 1;
+
+    vector<Task> page = db->queryTasks(query);
+    ASSERT_EQ(page.size(), 2u);
+    EXPECT_EQ(page[0].getId(), 8);  // Even ids are HIGH; 10 has the earliest due date
+    EXPECT_EQ(page[1].getId(), 6);
+
+    query.dueFrom = 1800000000 - 400;
+    EXPECT_EQ(db->countTasks(query), 2);  // Ids 2 and 4
+}
+
+// Test cursor pages resume after the last row and the overdue filter
+TEST_F(SQLiteHandlerTest, KeysetPagingAndOverdue) {
+    vector<Task> tasks = makeTasks(10);
+    for (auto& task : tasks) {
+        // Ids 3, 6 and 9 have no due date and sort last
+        task.setDueDate(task.getId() % 3 == 0 ? 0 : 1000 + (task.getId() % 4) * 10);
+    }
+    tasks[0].markComplete();
+    ASSERT_TRUE(db->saveTasks(tasks, 11));
+
+    TaskQuery query;
+    query.sortBy = TaskSortField::DUE_DATE;
+    query.limit = 3;
+    vector<int> ids;
+    for (vector<Task> page = db->queryTasks(query); !page.empty(); page = db->queryTasks(query)) {
+        for (const auto& task : page) ids.push_back(task.getId());
+        query.after = query.cursorAt(page.back());
+    }
+    EXPECT_EQ(ids, vector<int>({4, 8, 1, 5, 2, 10, 7, 3, 6, 9}));
+
+    query = TaskQuery();
+    query.sortBy = TaskSortField::PRIORITY;
+    query.descending = true;
+    query.after = TaskCursor{static_cast<int>(Priority::HIGH), 4};
+    query.limit = 2;
+    vector<Task> page = db->queryTasks(query);
+    ASSERT_EQ(page.size(), 2u);
+    EXPECT_EQ(page[0].getId(), 2);      // Rest of HIGH, then LOW from the top
+    EXPECT_EQ(page[1].getId(), 9);
+
+    query = TaskQuery();
+    query.overdue = true;
+    query.now = 1025;
+    EXPECT_EQ(db->countTasks(query), 5);  // Ids 2, 4, 5, 8, 10; id 1 is completed
+}
+
+// Test full-text search ranks title matches first and follows updates/deletes
+TEST_F(SQLiteHandlerTest, FullTextSearchStaysInSync) {
+    vector<Task> tasks;
+    tasks.emplace_back(1, "Write report", "Quarterly numbers", Priority::HIGH);
+    tasks.emplace_back(2, "Groceries", "Buy paper for the report printer", Priority::LOW);
+    tasks.emplace_back(3, "Dentist", "Book appointment", Priority::MEDIUM);
+    ASSERT_TRUE(db->saveTasks(tasks, 4));
+
+    vector<TaskSearchResult> hits = db->searchTasks("repo");
+    ASSERT_EQ(hits.size(), 2u);
+    EXPECT_EQ(hits[0].task.getId(), 1);
+    EXPECT_NE(hits[1].snippet.find("[report]"), string::npos);
+
+    tasks[2].setTitle("Dentist report");
+    tasks.erase(tasks.begin());
+    ASSERT_TRUE(db->saveTasks(tasks, 4));
+
+    hits = db->searchTasks("report");
+    ASSERT_EQ(hits.size(), 2u);
+    EXPECT_EQ(hits[0].task.getId(), 3);
+    EXPECT_TRUE(db->searchTasks("quarterly").empty());
+}
+
+// Test a legacy TEXT-encoded database stays readable and migrates to v2
+TEST_F(SQLiteHandlerTest, MigratesLegacyTextSchema) {
+    delete db;
+    removeDatabaseFiles();
+
+    sqlite3* raw;
+    ASSERT_EQ(sqlite3_open(dbPath.c_str(), &raw), SQLITE_OK);
+    const char* legacy = R"(
+        CREATE TABLE tasks (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            title TEXT NOT NULL, description TEXT NOT NULL,
+            priority TEXT NOT NULL, status TEXT NOT NULL,
+            created_at INTEGER NOT NULL, due_date INTEGER DEFAULT 0);
+        INSERT INTO tasks VALUES (1, 'Old', 'Legacy row', 'HIGH', 'IN_PROGRESS', 1700000000, 0);
+        INSERT INTO tasks VALUES (2, 'Other', 'Legacy row', 'LOW', 'COMPLETED', 1700000001, 0);
+        INSERT INTO tasks VALUES (3, 'Gone', 'Deleted later', 'LOW', 'PENDING', 1700000002, 0);
+        DELETE FROM tasks WHERE id = 3;
+    )";
+    ASSERT_EQ(sqlite3_exec(raw, legacy, nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(raw);
+
+    // Old layout is readable without migrating
+    SQLiteHandler reader(dbPath);
+    ASSERT_TRUE(reader.connect(true));
+    EXPECT_EQ(reader.getSchemaVersion(), 1);
+    vector<Task> before = reader.getAllTasks();
+    ASSERT_EQ(before.size(), 2u);
+    EXPECT_EQ(before[0].getPriority(), Priority::HIGH);
+    reader.disconnect();
+
+    // Opening a writer connection migrates the layout
+    db = new SQLiteHandler(dbPath);
+    ASSERT_TRUE(db->connect());
+    EXPECT_EQ(db->getSchemaVersion(), 2);
+
+    vector<Task> after = db->getAllTasks();
+    ASSERT_EQ(after.size(), 2u);
+    EXPECT_EQ(after[0].getStatus(), Status::IN_PROGRESS);
+    EXPECT_EQ(after[1].getStatus(), Status::COMPLETED);
+
+    TaskQuery query;
+    query.status = Status::COMPLETED;
+    EXPECT_EQ(db->countTasks(query), 1);
+    EXPECT_EQ(db->searchTasks("legacy").size(), 2u);
+    EXPECT_EQ(db->insertTask(Task(0, "New", "Desc", Priority::LOW)), 4);  // Id 3 not reused
+}
+
+// Test a bulk load survives a reconnect and rebuilds indexes and search at the end
+TEST_F(SQLiteHandlerTest, BulkLoadDefersIndexes) {
+    ASSERT_TRUE(db->beginBulkLoad());
+    EXPECT_TRUE(db->isBulkLoadPending());
+    EXPECT_EQ(db->upsertTasks(makeTasks(5)), 5);
+
+    // Reconnecting mid-load keeps the indexes dropped
+    delete db;
+    db = new SQLiteHandler(dbPath);
+    ASSERT_TRUE(db->connect());
+    EXPECT_TRUE(db->isBulkLoadPending());
+    EXPECT_TRUE(db->searchTasks("task").empty());
+
+    ASSERT_TRUE(db->finishBulkLoad());
+    EXPECT_FALSE(db->isBulkLoadPending());
+    EXPECT_EQ(db->searchTasks("task").size(), 5u);
+
+    // Triggers are back: later writes reach the search index
+    Task extra(6, "Bulk follow-up", "After load", Priority::LOW);
+    ASSERT_EQ(db->upsertTasks({extra}), 1);
+    EXPECT_EQ(db->searchTasks("follow").size(), 1u);
+}
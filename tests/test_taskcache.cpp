@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "TaskCache.hpp"
+#include "TaskManager.hpp"
+#include "SQLiteConnectionPool.hpp"
+#include <filesystem>
+
+// Budget that fits roughly `count` small tasks
+static size_t budgetFor(int count) {
+    return count * TaskCache::estimateSize(Task(1, "Task", "Desc"));
+}
+
+// Test least recently used entries are evicted first and counted
+TEST(TaskCacheTest, EvictsLeastRecentlyUsed) {
+    TaskCache cache(budgetFor(2));
+    cache.put(Task(1, "Task", "Desc"));
+    cache.put(Task(2, "Task", "Desc"));
+
+    ASSERT_NE(cache.get(1), nullptr);   // 2 becomes least recent
+    cache.put(Task(3, "Task", "Desc"));
+
+    EXPECT_EQ(cache.get(2), nullptr);
+    EXPECT_NE(cache.get(1), nullptr);
+
+    TaskCache::Stats stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.entries, 2u);
+}
+
+// Test modified entries are written back when evicted
+TEST(TaskCacheTest, WritesBackModifiedOnEviction) {
+    TaskCache cache(budgetFor(1));
+    vector<int> written;
+    cache.setWriteBackHandler([&written](const Task& task) {
+        written.push_back(task.getId());
+        return true;
+    });
+
+    cache.put(Task(1, "Task", "Desc"));
+    cache.get(1)->markComplete();
+    cache.put(Task(2, "Task", "Desc"));   // evicts modified 1
+    cache.put(Task(3, "Task", "Desc"));   // evicts clean 2
+
+    ASSERT_EQ(written.size(), 1u);
+    EXPECT_EQ(written[0], 1);
+    EXPECT_TRUE(cache.collectModified().empty());
+}
+
+// Test edits stay modified until a write-back or flush succeeds
+TEST(TaskCacheTest, KeepsEditsWhenWriteBackFails) {
+    TaskCache cache(budgetFor(1));
+    bool failing = true;
+    cache.setWriteBackHandler([&failing](const Task&) { return !failing; });
+
+    cache.put(Task(1, "Task", "Desc"));
+    cache.get(1)->markComplete();
+    cache.put(Task(2, "Task", "Desc"));   // write-back of 1 fails; 1 stays
+    ASSERT_NE(cache.get(1), nullptr);
+    EXPECT_TRUE(cache.get(1)->isCompleted());
+    EXPECT_EQ(cache.getStats().evictions, 0u);
+
+    // A flush that never reached the store leaves the entry modified
+    vector<Task> modified = cache.collectModified();
+    ASSERT_EQ(modified.size(), 1u);
+    EXPECT_EQ(cache.collectModified().size(), 1u);
+    cache.markClean(modified);
+    EXPECT_TRUE(cache.collectModified().empty());
+
+    failing = false;
+    cache.get(2)->setTitle("Edited");
+    cache.put(Task(3, "Task", "Desc"));
+    EXPECT_EQ(cache.getStats().writeBacks, 1u);
+    EXPECT_EQ(cache.getStats().entries, 1u);
+}
+
+// Test TaskManager keeps only the budget in memory over a SQLite store
+TEST(TaskCacheTest, TaskManagerReadsThroughSQLite) {
+    const string dbPath = "test_taskcache.db";
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(dbPath + suffix);
+
+    {
+        SQLiteConnectionPool pool(dbPath, 2);
+        ASSERT_TRUE(pool.open());
+        TaskManager manager(pool, budgetFor(3));
+
+        vector<int> ids;
+        for (int i = 0; i < 10; i++) {
+            ids.push_back(manager.addTask("Task", "Desc", Priority::LOW));
+        }
+        EXPECT_EQ(manager.getTaskCount(), 10);
+        EXPECT_LE(manager.getCacheStats().entries, 3u);
+
+        ASSERT_TRUE(manager.markTaskComplete(ids[0]));   // miss, read through
+        EXPECT_GE(manager.getCacheStats().misses, 1u);
+
+        TaskQuery completed;
+        completed.status = Status::COMPLETED;
+        EXPECT_EQ(manager.countTasks(completed), 1);
+
+        EXPECT_TRUE(manager.deleteTask(ids[1]));
+        EXPECT_EQ(manager.findTaskById(ids[1]), nullptr);
+        EXPECT_EQ(manager.getTaskCount(), 9);
+    }
+
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(dbPath + suffix);
+}
+
+// Test remote changes refresh cached tasks and a reload empties the cache
+TEST(TaskCacheTest, TaskManagerAppliesRemoteChanges) {
+    const string dbPath = "test_taskcache_remote.db";
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(dbPath + suffix);
+
+    {
+        SQLiteConnectionPool pool(dbPath, 1);
+        ASSERT_TRUE(pool.open());
+        TaskManager manager(pool, budgetFor(10));
+        int id = manager.addTask("Before", "Desc", Priority::LOW);
+        ASSERT_NE(manager.findTaskById(id), nullptr);
+
+        // Another process rewrote the row and announced it
+        Task remote(id, "After", "Desc", Priority::HIGH);
+        {
+            auto writer = pool.acquireWriter();
+            ASSERT_TRUE(writer->updateTask(remote));
+        }
+        TaskChange change;
+        change.kind = TaskChange::Kind::UPSERT;
+        change.id = id;
+        change.task = remote;
+        EXPECT_TRUE(manager.applyChange(change));
+        EXPECT_EQ(manager.findTaskById(id)->getTitle(), "After");
+
+        EXPECT_TRUE(manager.applyChange(TaskChange()));
+        EXPECT_EQ(manager.getCacheStats().entries, 0u);
+    }
+
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(dbPath + suffix);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "TaskChangeLog.hpp"
+#include "TaskManager.hpp"
+#include <thread>
+
+// Test readers page through events and are told when they fell behind
+TEST(TaskChangeLogTest, KeepsNewestEvents) {
+    TaskChangeLog log(3);
+    for (uint64_t seq = 1; seq <= 5; seq++) {
+        log.append(seq, TaskChange{TaskChange::Kind::UPSERT, static_cast<int>(seq), Task(seq, "T", "D")});
+    }
+    EXPECT_EQ(log.latest(), 5u);
+
+    vector<shared_ptr<const TaskChangeLog::Event>> events;
+    EXPECT_FALSE(log.since(1, 10, events));     // Event 2 is gone
+    ASSERT_TRUE(log.since(2, 10, events));
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0]->seq, 3u);
+    EXPECT_EQ(events[0]->json.find("{\"seq\":3,\"type\":\"upsert\",\"id\":3,\"task\":{\"id\":3,"), 0u);
+
+    events.clear();
+    ASSERT_TRUE(log.since(3, 1, events));
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0]->seq, 4u);
+
+    events.clear();
+    log.append(6, TaskChange{TaskChange::Kind::DELETE, 2, nullopt});
+    ASSERT_TRUE(log.since(5, 10, events));
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0]->json, "{\"seq\":6,\"type\":\"delete\",\"id\":2}");
+    EXPECT_NE(TaskChangeLog().getEpoch(), 0u);
+}
+
+// Test every manager write is logged under its version and wakes waiters
+TEST(TaskChangeLogTest, ManagerLogsWrites) {
+    TaskManager manager;
+    const TaskChangeLog& log = manager.getChangeLog();
+    uint64_t start = manager.getVersion();
+    EXPECT_EQ(log.latest(), start);
+    EXPECT_FALSE(log.waitFor(start, chrono::milliseconds(1)));
+
+    thread writer([&manager] {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        int id = manager.addTask("Logged", "Desc");
+        manager.deleteTask(id);
+    });
+    EXPECT_TRUE(log.waitFor(start, chrono::seconds(10)));
+    writer.join();
+
+    vector<shared_ptr<const TaskChangeLog::Event>> events;
+    ASSERT_TRUE(log.since(start, 10, events));
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0]->change.kind, TaskChange::Kind::UPSERT);
+    EXPECT_EQ(events[0]->change.task->getTitle(), "Logged");
+    EXPECT_EQ(events[1]->change.kind, TaskChange::Kind::DELETE);
+    EXPECT_EQ(events[1]->seq, manager.getVersion());
+}
+
+// Test a delta keeps the last write per task and falls back when it cannot
+TEST(TaskChangeLogTest, NetsChangesSinceAVersion) {
+    TaskChangeLog log(4);
+    Task first(1, "First", "D");
+    log.append(1, TaskChange{TaskChange::Kind::UPSERT, 1, first});
+    log.append(2, TaskChange{TaskChange::Kind::UPSERT, 2, Task(2, "Second", "D")});
+    first.setTitle("Renamed");
+    log.append(3, TaskChange{TaskChange::Kind::UPSERT, 1, first});
+    log.append(4, TaskChange{TaskChange::Kind::DELETE, 2, nullopt});
+
+    vector<Task> changed;
+    vector<int> deleted;
+    uint64_t upTo = 0;
+    ASSERT_TRUE(log.changesSince(0, changed, deleted, upTo));
+    ASSERT_EQ(changed.size(), 1u);
+    EXPECT_EQ(changed[0].getTitle(), "Renamed");
+    EXPECT_EQ(deleted, vector<int>{2});
+    EXPECT_EQ(upTo, 4u);
+
+    changed.clear();
+    deleted.clear();
+    ASSERT_TRUE(log.changesSince(4, changed, deleted, upTo));     // Up to date
+    EXPECT_TRUE(changed.empty() && deleted.empty());
+    EXPECT_FALSE(log.changesSince(5, changed, deleted, upTo));    // From the future
+
+    log.append(5, TaskChange{TaskChange::Kind::UPSERT, 3, Task(3, "Third", "D")});
+    EXPECT_FALSE(log.changesSince(0, changed, deleted, upTo));    // Seq 1 dropped
+    ASSERT_TRUE(log.changesSince(1, changed, deleted, upTo));
+    EXPECT_EQ(changed.size(), 2u);
+
+    log.append(6, TaskChange());
+    EXPECT_FALSE(log.changesSince(4, changed, deleted, upTo));    // Reload in between
+    log.setCapacity(1);
+    changed.clear();
+    EXPECT_FALSE(log.changesSince(4, changed, deleted, upTo));    // Seq 5 dropped
+    EXPECT_TRUE(log.changesSince(6, changed, deleted, upTo));
+    EXPECT_TRUE(changed.empty());
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "TaskCommandQueue.hpp"
+#include "SQLiteConnectionPool.hpp"
+#include <filesystem>
+
+class TaskCommandQueueTest : public ::testing::Test {
+protected:
+    const string dbPath = "test_commandqueue.db";
+
+    void removeDatabaseFiles() {
+        for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(dbPath + suffix);
+    }
+
+    void SetUp() override {
+        removeDatabaseFiles();
+    }
+
+    void TearDown() override {
+        removeDatabaseFiles();
+    }
+};
+
+// Test commands from one producer apply in order and complete their futures
+TEST_F(TaskCommandQueueTest, AppliesInSubmissionOrder) {
+    SQLiteConnectionPool pool(dbPath, 1);
+    ASSERT_TRUE(pool.open());
+    TaskManager manager(pool, 1024 * 1024);
+    TaskCommandQueue queue(manager);
+
+    future<int> created = queue.submit<int>([](TaskManager& m) {
+        return m.addTask("First", "Desc", Priority::LOW);
+    });
+    int id = created.get();
+    ASSERT_GT(id, 0);
+
+    future<optional<Task>> renamed = queue.submit<optional<Task>>([id](TaskManager& m) {
+        return m.updateTask(id, [](Task& task) { task.setTitle("Second"); });
+    });
+    future<bool> deleted = queue.submit<bool>([id](TaskManager& m) { return m.deleteTask(id); });
+
+    ASSERT_TRUE(renamed.get().has_value());
+    EXPECT_TRUE(deleted.get());
+    EXPECT_FALSE(manager.getTask(id).has_value());
+
+    TaskCommandQueue::Stats stats = queue.getStats();
+    EXPECT_EQ(stats.submitted, 3u);
+    EXPECT_EQ(stats.applied, 3u);
+    EXPECT_EQ(stats.depth, 0u);
+}
+
+// Test many producers are serialized, batched, and exceptions reach the caller
+TEST_F(TaskCommandQueueTest, ManyProducersBatchAndReportErrors) {
+    SQLiteConnectionPool pool(dbPath, 1);
+    ASSERT_TRUE(pool.open());
+    TaskManager manager(pool, 1024 * 1024, true);
+    TaskCommandQueue queue(manager, 64);
+
+    vector<thread> producers;
+    for (int p = 0; p < 4; p++) {
+        producers.emplace_back([&queue]() {
+            vector<future<int>> ids;
+            for (int i = 0; i < 50; i++) {
+                ids.push_back(queue.submit<int>([](TaskManager& m) {
+                    return m.addTask("Queued", "Desc", Priority::MEDIUM);
+                }));
+            }
+            for (auto& id : ids) {
+                id.get();
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    EXPECT_EQ(manager.getTaskCount(), 200);
+    TaskCommandQueue::Stats stats = queue.getStats();
+    EXPECT_EQ(stats.applied, 200u);
+    EXPECT_LE(stats.batches, 200u);
+    EXPECT_GE(stats.avgBatchSize, 1.0);
+
+    future<int> failing = queue.submit<int>([](TaskManager&) -> int {
+        throw runtime_error("rejected");
+    });
+    EXPECT_THROW(failing.get(), runtime_error);
+
+    // Still usable after a failed command and after stop()
+    queue.stop();
+    EXPECT_GT(queue.submit<int>([](TaskManager& m) { return m.addTask("Late", "Desc"); }).get(), 0);
+}
+
+// Test a failed batch rolls its transaction back in SQLite mode
+TEST_F(TaskCommandQueueTest, BatchRollsBackInStore) {
+    SQLiteConnectionPool pool(dbPath, 1);
+    ASSERT_TRUE(pool.open());
+    TaskManager manager(pool, 1024 * 1024);
+    int id = manager.addTask("Stored", "Desc", Priority::LOW);
+
+    using Kind = TaskManager::BatchStep::Kind;
+    vector<TaskManager::BatchStep> steps(3);
+    steps[0].kind = Kind::CREATE;
+    steps[0].title = "Added";
+    steps[1].kind = Kind::REMOVE;
+    steps[1].id = id;
+    steps[2].kind = Kind::EDIT;
+    steps[2].id = id + 1000;
+    steps[2].edit = [](Task& task) { task.setTitle("Missing"); };
+
+    vector<optional<Task>> results;
+    int failedStep = -1;
+    EXPECT_FALSE(manager.applyBatch(steps, results, failedStep));
+    EXPECT_EQ(failedStep, 2);
+    EXPECT_EQ(manager.getTaskCount(), 1);
+    EXPECT_TRUE(manager.getTask(id).has_value());
+
+    steps.pop_back();
+    ASSERT_TRUE(manager.applyBatch(steps, results, failedStep));
+    EXPECT_EQ(manager.getTaskCount(), 1);
+    EXPECT_FALSE(manager.getTask(id).has_value());
+    EXPECT_EQ(manager.getTask(results[0]->getId())->getTitle(), "Added");
+}
+
+// Test commands submitted while stop() runs are all applied and completed
+TEST_F(TaskCommandQueueTest, StopWhileSubmittingCompletesEveryFuture) {
+    SQLiteConnectionPool pool(dbPath, 1);
+    ASSERT_TRUE(pool.open());
+    TaskManager manager(pool, 1024 * 1024, true);
+    TaskCommandQueue queue(manager, 8);
+
+    atomic<int> applied(0);
+    vector<thread> producers;
+    for (int p = 0; p < 4; p++) {
+        producers.emplace_back([&queue, &applied]() {
+            vector<future<int>> pending;
+            for (int i = 0; i < 200; i++) {
+                pending.push_back(queue.submit<int>([&applied](TaskManager&) { return ++applied; }));
+            }
+            for (auto& result : pending) {
+                result.get();   // Hangs if a command was lost
+            }
+        });
+    }
+    queue.stop();
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    EXPECT_EQ(applied.load(), 800);
+    EXPECT_EQ(queue.getStats().depth, 0u);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "TaskIndex.hpp"
+#include <climits>
+
+static vector<int> scanIds(const TaskIndex& index, TaskIndex::Key from, bool descending) {
+    vector<int> ids;
+    index.scan(from, descending, [&ids](const TaskIndex::Key& key) {
+        ids.push_back(key.id);
+        return true;
+    });
+    return ids;
+}
+
+// Test keys stay ordered across block splits and erases, in both directions
+TEST(TaskIndexTest, OrderedAcrossBlocks) {
+    const int built = 3 * TaskIndex::BLOCK_SIZE;
+    vector<TaskIndex::Key> keys;
+    for (int id = 1; id <= built; id++) {
+        keys.push_back({id % 3, id});
+    }
+    TaskIndex index = TaskIndex::build(keys);
+    for (int id = built + 1; id <= built + 2 * static_cast<int>(TaskIndex::BLOCK_SIZE); id++) {
+        index.insert({1, id});      // Forces splits inside the value-1 range
+    }
+    index.erase({0, 3});
+    index.erase({0, 3});            // Absent keys are ignored
+    EXPECT_EQ(index.size(), 5 * TaskIndex::BLOCK_SIZE - 1);
+
+    // Value 1 runs on into the value-2 keys
+    vector<int> ones = scanIds(index, {1, INT_MIN}, false);
+    ASSERT_EQ(ones.size(), 4 * TaskIndex::BLOCK_SIZE);
+    EXPECT_EQ(ones[0], 1);
+    EXPECT_EQ(ones[TaskIndex::BLOCK_SIZE - 1], built - 2);
+    EXPECT_EQ(ones[TaskIndex::BLOCK_SIZE], built + 1);
+    EXPECT_EQ(ones[3 * TaskIndex::BLOCK_SIZE - 1], built + 2 * static_cast<int>(TaskIndex::BLOCK_SIZE));
+    EXPECT_EQ(ones[3 * TaskIndex::BLOCK_SIZE], 2);
+
+    vector<int> zeros = scanIds(index, {0, INT_MAX}, true);
+    ASSERT_EQ(zeros.size(), TaskIndex::BLOCK_SIZE - 1);
+    EXPECT_EQ(zeros.front(), built);
+    EXPECT_EQ(zeros.back(), 6);
+}
+
+// Test a copy shares blocks until written and never sees the other's writes
+TEST(TaskIndexTest, CopiesAreIndependent) {
+    TaskIndex original = TaskIndex::build({{5, 1}, {7, 2}});
+    TaskIndex copy = original;
+    copy.insert({6, 3});
+    copy.erase({5, 1});
+
+    EXPECT_EQ(scanIds(original, {LLONG_MIN, INT_MIN}, false), vector<int>({1, 2}));
+    EXPECT_EQ(scanIds(copy, {LLONG_MIN, INT_MIN}, false), vector<int>({3, 2}));
+}
+
+// Test range counts match a scan, including ranges that end inside a block
+TEST(TaskIndexTest, CountsValueRanges) {
+    const int built = 3 * TaskIndex::BLOCK_SIZE;
+    vector<TaskIndex::Key> keys;
+    for (int id = 1; id <= built; id++) {
+        keys.push_back({id % 7, id});
+    }
+    TaskIndex index = TaskIndex::build(keys);
+    index.erase({3, 3});
+
+    for (long long low = -1; low <= 7; low++) {
+        for (long long high = low - 1; high <= 7; high++) {
+            size_t scanned = 0;
+            index.scan({low, INT_MIN}, false, [&scanned, high](const TaskIndex::Key& key) {
+                if (key.value > high) return false;
+                scanned++;
+                return true;
+            });
+            ASSERT_EQ(index.count(low, high), scanned) << low << ".." << high;
+        }
+    }
+    EXPECT_EQ(index.count(LLONG_MIN, LLONG_MAX), index.size());
+    EXPECT_EQ(TaskIndex().count(0, 1), 0u);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "TaskJsonCache.hpp"
+
+// Test the object layout the web client reads
+TEST(TaskJsonCacheTest, SerializesTask) {
+    Task task(3, "Title", "Desc", Priority::HIGH);
+    task.setCreatedAt(1700000000);
+    time_t validUntil = 0;
+
+    EXPECT_EQ(TaskJsonCache::toJson(task, 1700000000, validUntil),
+              "{\"id\":3,\"title\":\"Title\",\"description\":\"Desc\",\"priority\":\"" +
+              task.getPriorityString() + "\",\"status\":\"" + task.getStatusString() +
+              "\",\"createdAt\":1700000000,\"dueDate\":0,\"isCompleted\":false,\"isOverdue\":false}");
+    EXPECT_EQ(validUntil, 0);
+}
+
+// Test only the written task is re-rendered and isOverdue follows the clock
+TEST(TaskJsonCacheTest, ReusesFragmentsOfUnchangedTasks) {
+    vector<Task> tasks;
+    for (int i = 1; i <= 300; i++) {
+        tasks.emplace_back(i, "Task", "Desc");
+    }
+    tasks[0].setDueDate(2000);
+    auto v1 = TaskSnapshot::build(tasks, 1);
+
+    TaskJsonCache cache;
+    time_t validUntil = 0;
+    string before = cache.toJson(*v1, 1000, validUntil);
+    EXPECT_EQ(cache.getStats().misses, 300u);
+    EXPECT_EQ(validUntil, 2001);
+    EXPECT_NE(before.find("\"isOverdue\":false"), string::npos);
+
+    Task renamed = tasks[299];
+    renamed.setTitle("Renamed");
+    auto v2 = v1->withTask(renamed, 2);
+
+    validUntil = 0;
+    string after = cache.toJson(*v2, 3000, validUntil);
+    EXPECT_EQ(cache.getStats().misses, 301u);
+    EXPECT_EQ(cache.getStats().hits, 299u);
+    EXPECT_NE(after.find("Renamed"), string::npos);
+    EXPECT_NE(after.find("\"isOverdue\":true"), string::npos);   // Task 1 is now overdue
+    EXPECT_EQ(validUntil, 0);
+}
+
+// Test a field list keeps only the named members, in the usual order
+TEST(TaskJsonCacheTest, ProjectsRequestedFields) {
+    TaskJsonCache::FieldMask fields = 0;
+    EXPECT_TRUE(TaskJsonCache::parseFields("status,id,title", fields));
+    EXPECT_FALSE(TaskJsonCache::parseFields("id,secret", fields));
+    EXPECT_FALSE(TaskJsonCache::parseFields("", fields));
+    EXPECT_TRUE(TaskJsonCache::parseFields("id,title,description,priority,status,createdAt,"
+                                           "dueDate,isCompleted,isOverdue", fields));
+    EXPECT_EQ(fields, TaskJsonCache::ALL_FIELDS);
+
+    Task task(3, "Title", "A long description", Priority::HIGH);
+    task.setDueDate(2000);
+    ASSERT_TRUE(TaskJsonCache::parseFields("status,id,title", fields));
+    time_t validUntil = 0;
+    EXPECT_EQ(TaskJsonCache::toJson(vector<Task>{task}, 1000, validUntil, fields),
+              "[{\"id\":3,\"title\":\"Title\",\"status\":\"" + task.getStatusString() + "\"}]");
+    EXPECT_EQ(validUntil, 0);       // Without isOverdue the body never expires
+
+    ASSERT_TRUE(TaskJsonCache::parseFields("isOverdue", fields));
+    EXPECT_EQ(TaskJsonCache::toJson(task, 1000, validUntil, fields), "{\"isOverdue\":false}");
+    EXPECT_EQ(validUntil, 2001);
+
+    auto snapshot = TaskSnapshot::build({task}, 1);
+    TaskJsonCache cache;
+    EXPECT_EQ(cache.toJson(*snapshot, 3000, validUntil, fields), "[{\"isOverdue\":true}]");
+    EXPECT_EQ(cache.getStats().entries, 0u);   // Projections skip the fragment cache
+}
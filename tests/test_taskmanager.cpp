@@ -145,3 +145,198 @@ TEST_F(TaskManagerTest, SortById) {
     auto& tasks = manager->getAllTasks();
     EXPECT_LE(tasks[0].getId(), tasks.back().getId());
 }
+
+// Test remote changes patch the in-memory list
+TEST_F(TaskManagerTest, ApplyRemoteChange) {
+    int id = manager->addTask("Local", "Desc", Priority::LOW);
+    
+    TaskChange update;
+    update.kind = TaskChange::Kind::UPSERT;
+    update.id = id;
+    update.task = Task(id, "Remote edit", "Desc", Priority::HIGH);
+    EXPECT_TRUE(manager->applyChange(update));
+    EXPECT_EQ(manager->findTaskById(id)->getTitle(), "Remote edit");
+    
+    TaskChange insert = update;
+    insert.id = id + 100;
+    insert.task = Task(id + 100, "Remote new", "Desc", Priority::LOW);
+    EXPECT_TRUE(manager->applyChange(insert));
+    EXPECT_NE(manager->findTaskById(id + 100), nullptr);
+    EXPECT_GT(manager->addTask("Next", "Desc"), id + 100);
+    
+    TaskChange removal;
+    removal.kind = TaskChange::Kind::DELETE;
+    removal.id = id + 100;
+    EXPECT_TRUE(manager->applyChange(removal));
+    EXPECT_EQ(manager->findTaskById(id + 100), nullptr);
+    
+    EXPECT_FALSE(manager->applyChange(TaskChange()));  // Reload needs the source
+}
+
+// Test a batch applies every step or none and is published as one block
+TEST_F(TaskManagerTest, ApplyBatchIsAllOrNothing) {
+    int keep = manager->addTask("Keep", "Desc", Priority::LOW);
+    int drop = manager->addTask("Drop", "Desc", Priority::LOW);
+    uint64_t before = manager->getVersion();
+    int count = manager->getTaskCount();
+    
+    using Kind = TaskManager::BatchStep::Kind;
+    vector<TaskManager::BatchStep> steps(4);
+    steps[0].kind = Kind::CREATE;
+    steps[0].title = "Added";
+    steps[1].kind = Kind::EDIT;
+    steps[1].id = keep;
+    steps[1].edit = [](Task& task) { task.setTitle("Edited"); };
+    steps[2].kind = Kind::REMOVE;
+    steps[2].id = drop;
+    steps[3].kind = Kind::READ;
+    steps[3].id = drop;     // Already removed by step 2
+    
+    vector<optional<Task>> results;
+    int failedStep = -1;
+    EXPECT_FALSE(manager->applyBatch(steps, results, failedStep));
+    EXPECT_EQ(failedStep, 3);
+    EXPECT_EQ(manager->getVersion(), before);
+    EXPECT_EQ(manager->getTask(keep)->getTitle(), "Keep");
+    EXPECT_TRUE(manager->getTask(drop).has_value());
+    EXPECT_EQ(manager->getTaskCount(), count);
+    
+    steps[3].id = keep;
+    ASSERT_TRUE(manager->applyBatch(steps, results, failedStep));
+    ASSERT_TRUE(results[0].has_value());
+    EXPECT_EQ(manager->getTask(results[0]->getId())->getTitle(), "Added");
+    EXPECT_EQ(results[3]->getTitle(), "Edited");
+    EXPECT_FALSE(results[2].has_value());
+    EXPECT_FALSE(manager->getTask(drop).has_value());
+    EXPECT_EQ(manager->getVersion(), before + 3);
+    EXPECT_EQ(manager->getSnapshot()->getVersion(), before + 3);
+    
+    vector<shared_ptr<const TaskChangeLog::Event>> events;
+    ASSERT_TRUE(manager->getChangeLog().since(before, 10, events));
+    EXPECT_EQ(events.size(), 3u);
+}
+
+// Test an external store receives only what changed since its last save
+TEST(TaskManagerExternalStoreTest, SavesOnlyChanges) {
+    vector<Task> stored = {Task(1, "Stored", "Desc", Priority::LOW)};
+    vector<int> lastWritten, lastDeleted;
+    int saves = 0;
+    bool failSaves = false;
+    bool failLoads = false;
+    
+    TaskManager::ExternalStore store;
+    store.load = [&](vector<Task>& tasks, int& nextId) {
+        if (failLoads) {
+            tasks.push_back(Task(99, "Partial", "", Priority::LOW));
+            return false;
+        }
+        tasks = stored;
+        nextId = 2;
+        return true;
+    };
+    store.save = [&](const vector<Task>& written, const vector<int>& deleted, int) {
+        saves++;
+        if (failSaves) return false;
+        lastWritten.clear();
+        for (const auto& task : written) lastWritten.push_back(task.getId());
+        lastDeleted = deleted;
+        return true;
+    };
+    
+    TaskManager manager(store);
+    ASSERT_EQ(manager.getTaskCount(), 1);
+    EXPECT_EQ(saves, 0);
+    
+    int id = manager.addTask("New", "Desc", Priority::HIGH);
+    EXPECT_EQ(lastWritten, vector<int>{id});
+    EXPECT_TRUE(lastDeleted.empty());
+    
+    // A group commit saves once; a task added and deleted in it is a delete
+    manager.beginBatch();
+    manager.markTaskComplete(1);
+    int temporary = manager.addTask("Temporary", "", Priority::LOW);
+    manager.deleteTask(temporary);
+    EXPECT_EQ(saves, 1);
+    ASSERT_TRUE(manager.endBatch());
+    EXPECT_EQ(saves, 2);
+    EXPECT_EQ(lastWritten, vector<int>{1});
+    EXPECT_EQ(lastDeleted, vector<int>{temporary});
+    
+    // Failed saves keep the changes for the next attempt
+    failSaves = true;
+    manager.deleteTask(id);
+    failSaves = false;
+    manager.updateTask(1, [](Task& task) { task.setTitle("Renamed"); });
+    EXPECT_EQ(lastWritten, vector<int>{1});
+    EXPECT_EQ(lastDeleted, vector<int>{id});
+    
+    // Bulk operations send only the tasks they touched
+    int open = manager.addTask("Open", "", Priority::LOW);
+    EXPECT_EQ(manager.deleteAllCompleted(), 1);
+    EXPECT_TRUE(lastWritten.empty());
+    EXPECT_EQ(lastDeleted, vector<int>{1});
+    
+    // A reload whose save or load fails keeps the list and the dirty ids
+    failSaves = true;
+    manager.updateTask(open, [](Task& task) { task.setTitle("Unsaved"); });
+    EXPECT_FALSE(manager.loadFromFile());
+    failSaves = false;
+    failLoads = true;
+    EXPECT_FALSE(manager.loadFromFile());
+    EXPECT_EQ(lastWritten, vector<int>{open});
+    ASSERT_TRUE(manager.getTask(open).has_value());
+    EXPECT_EQ(manager.getTask(open)->getTitle(), "Unsaved");
+    EXPECT_FALSE(manager.getTask(99).has_value());
+    failLoads = false;
+    EXPECT_TRUE(manager.loadFromFile());
+    EXPECT_EQ(manager.getTaskCount(), 1);
+}
+
+// Test a batch whose save fails leaves the list as it was, in the same order
+TEST(TaskManagerExternalStoreTest, FailedBatchSaveRestoresList) {
+    bool failSaves = true;
+    TaskManager::ExternalStore store;
+    store.load = [](vector<Task>& tasks, int& nextId) {
+        for (int id : {4, 1, 3, 5, 2}) {
+            tasks.push_back(Task(id, "Task " + to_string(id), "Desc", Priority::LOW));
+        }
+        nextId = 6;
+        return true;
+    };
+    store.save = [&failSaves](const vector<Task>&, const vector<int>&, int) {
+        return !failSaves;
+    };
+    TaskManager manager(store);
+    auto listed = [&manager]() {
+        vector<string> titles;
+        for (const auto& task : manager.getAllTasks()) titles.push_back(task.getTitle());
+        return titles;
+    };
+    const vector<string> original = listed();
+    
+    using Kind = TaskManager::BatchStep::Kind;
+    vector<TaskManager::BatchStep> steps(5);
+    steps[0].kind = Kind::EDIT;
+    steps[0].id = 3;
+    steps[0].edit = [](Task& task) { task.setTitle("Edited"); };
+    steps[1].kind = Kind::REMOVE;
+    steps[1].id = 3;
+    steps[2].kind = Kind::CREATE;
+    steps[2].title = "Added";
+    steps[3].kind = Kind::EDIT;
+    steps[3].id = 2;
+    steps[3].edit = [](Task& task) { task.setTitle("Also edited"); };
+    steps[4].kind = Kind::REMOVE;
+    steps[4].id = 4;
+    
+    vector<optional<Task>> results;
+    int failedStep = 0;
+    EXPECT_FALSE(manager.applyBatch(steps, results, failedStep));
+    EXPECT_EQ(failedStep, -1);
+    EXPECT_EQ(listed(), original);
+    
+    failSaves = false;
+    ASSERT_TRUE(manager.applyBatch(steps, results, failedStep));
+    EXPECT_EQ(results[2]->getId(), 6);
+    EXPECT_EQ(listed(), vector<string>({"Task 1", "Task 5", "Also edited", "Added"}));
+}
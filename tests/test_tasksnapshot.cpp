@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include "TaskSnapshot.hpp"
+#include "TaskManager.hpp"
+#include <chrono>
+#include <climits>
+
+static vector<Task> makeTasks(int count) {
+    vector<Task> tasks;
+    for (int i = count; i >= 1; i--) {
+        tasks.emplace_back(i, "Task " + to_string(i), "Desc", Priority::LOW);
+    }
+    return tasks;
+}
+
+// Test lookups and iteration follow id order regardless of input order
+TEST(TaskSnapshotTest, BuildFindAndIterate) {
+    auto snapshot = TaskSnapshot::build(makeTasks(600), 7);
+    EXPECT_EQ(snapshot->getVersion(), 7u);
+    EXPECT_EQ(snapshot->size(), 600u);
+    ASSERT_NE(snapshot->find(300), nullptr);
+    EXPECT_EQ(snapshot->find(300)->getTitle(), "Task 300");
+    EXPECT_EQ(snapshot->find(601), nullptr);
+    EXPECT_EQ(snapshot->find(-1), nullptr);
+
+    int previous = 0;
+    bool ordered = true;
+    snapshot->forEach([&previous, &ordered](const Task& task) {
+        ordered = ordered && task.getId() > previous;
+        previous = task.getId();
+        return true;
+    });
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(previous, 600);
+}
+
+// Test a write leaves the old version intact and shares untouched chunks
+TEST(TaskSnapshotTest, WritesCopyOnlyTheirChunk) {
+    auto v1 = TaskSnapshot::build(makeTasks(600), 1);
+
+    Task renamed(10, "Renamed", "Desc", Priority::HIGH);
+    auto v2 = v1->withTask(renamed, 2);
+    auto v3 = v2->withoutTask(11, 3)->withTask(Task(1000, "New", "Desc"), 4);
+
+    EXPECT_EQ(v1->find(10)->getTitle(), "Task 10");
+    EXPECT_EQ(v2->find(10)->getTitle(), "Renamed");
+    EXPECT_NE(v2->find(11), nullptr);
+    EXPECT_EQ(v3->find(11), nullptr);
+    EXPECT_EQ(v3->size(), 600u);
+    EXPECT_EQ(v3->getVersion(), 4u);
+
+    // Id 500 lives in another chunk, so every version points at the same task
+    EXPECT_EQ(v1->find(500), v3->find(500));
+    EXPECT_NE(v1->find(20), v2->find(20));
+}
+
+// Test a snapshot held by a reader does not change as the manager is written
+TEST(TaskSnapshotTest, ManagerPublishesVersions) {
+    TaskManager manager;
+    int id = manager.addTask("Snapshot", "Desc", Priority::LOW);
+
+    shared_ptr<const TaskSnapshot> before = manager.getSnapshot();
+    uint64_t version = manager.getVersion();
+    ASSERT_NE(before, nullptr);
+    EXPECT_EQ(before->getVersion(), version);
+
+    manager.updateTask(id, [](Task& task) { task.setTitle("Changed"); });
+    manager.deleteTask(id);
+
+    EXPECT_EQ(before->find(id)->getTitle(), "Snapshot");
+    EXPECT_EQ(manager.getVersion(), version + 2);
+    EXPECT_EQ(manager.getSnapshot()->find(id), nullptr);
+    EXPECT_FALSE(manager.getTask(id).has_value());
+}
+
+// Reference order for TaskQuery: key then id, undated tasks last either way
+static bool referenceLess(const Task& a, const Task& b, const TaskQuery& query) {
+    long long ka = TaskQuery::sortKey(a, query.sortBy);
+    long long kb = TaskQuery::sortKey(b, query.sortBy);
+    if (query.sortBy == TaskSortField::DUE_DATE && (ka == 0) != (kb == 0)) {
+        return kb == 0;
+    }
+    if (ka != kb) return query.descending ? ka > kb : ka < kb;
+    return query.descending ? a.getId() > b.getId() : a.getId() < b.getId();
+}
+
+// Test cursor pages from the indexes equal a filtered, sorted full scan
+TEST(TaskSnapshotTest, IndexedPagesMatchFullSort) {
+    vector<Task> tasks;
+    for (int i = 1; i <= 700; i++) {
+        Task task(i, "Task", "Desc", static_cast<Priority>(i % 3));
+        task.setStatus(static_cast<Status>((i / 3) % 3));
+        task.setCreatedAt(1000 + (i * 37) % 101);
+        task.setDueDate(i % 4 == 0 ? 0 : 5000 + (i * 13) % 50);
+        tasks.push_back(task);
+    }
+    auto snapshot = TaskSnapshot::build(tasks, 1);
+    // Writes after the build move index keys
+    Task moved = tasks[9];
+    moved.setDueDate(0);
+    moved.setPriority(Priority::HIGH);
+    snapshot = snapshot->withTask(moved, 2)->withoutTask(20, 3)->withTask(Task(900, "New", "Desc"), 4);
+
+    vector<TaskQuery> queries;
+    for (auto field : {TaskSortField::ID, TaskSortField::PRIORITY, TaskSortField::STATUS,
+                       TaskSortField::DUE_DATE, TaskSortField::CREATED_AT}) {
+        for (bool descending : {false, true}) {
+            TaskQuery query;
+            query.sortBy = field;
+            query.descending = descending;
+            queries.push_back(query);
+            query.status = Status::IN_PROGRESS;
+            queries.push_back(query);
+            query.status.reset();
+            query.priority = Priority::LOW;
+            queries.push_back(query);
+            query.priority.reset();
+            query.overdue = true;
+            query.now = 5025;
+            queries.push_back(query);
+            query.overdue = false;
+            query.dueTo = 5040;
+            queries.push_back(query);
+        }
+    }
+
+    for (TaskQuery query : queries) {
+        vector<Task> expected;
+        snapshot->forEach([&](const Task& task) {
+            if (query.matches(task)) expected.push_back(task);
+            return true;
+        });
+        sort(expected.begin(), expected.end(), [&query](const Task& a, const Task& b) {
+            return referenceLess(a, b, query);
+        });
+        EXPECT_EQ(snapshot->count(query), expected.size()) << static_cast<int>(query.sortBy);
+
+        // Walk pages of 37 through the cursor, the first one after an offset
+        vector<int> paged;
+        for (size_t i = 0; i < min<size_t>(5, expected.size()); i++) paged.push_back(expected[i].getId());
+        query.limit = 37;
+        query.offset = 5;
+        while (true) {
+            vector<Task> page = snapshot->query(query);
+            for (const auto& task : page) paged.push_back(task.getId());
+            if (page.size() < 37) break;
+            query.after = query.cursorAt(page.back());
+            query.offset = 0;
+        }
+
+        ASSERT_EQ(paged.size(), expected.size()) << static_cast<int>(query.sortBy);
+        for (size_t i = 0; i < expected.size(); i++) {
+            ASSERT_EQ(paged[i], expected[i].getId()) << static_cast<int>(query.sortBy) << " at " << i;
+        }
+    }
+}
+
+// Test cursors at the ends of the id range stop or move to the next key
+// instead of overflowing
+TEST(TaskSnapshotTest, CursorAtIdLimits) {
+    vector<Task> tasks;
+    for (int i = 1; i <= 30; i++) {
+        tasks.emplace_back(i, "Task", "Desc", static_cast<Priority>(i % 3));
+    }
+    auto snapshot = TaskSnapshot::build(tasks, 1);
+    long long medium = static_cast<long long>(Priority::MEDIUM);
+
+    TaskQuery query;
+    query.after = TaskCursor{0, INT_MAX};
+    EXPECT_TRUE(snapshot->query(query).empty());
+    query.descending = true;
+    query.after = TaskCursor{0, INT_MIN};
+    EXPECT_TRUE(snapshot->query(query).empty());
+
+    query.sortBy = TaskSortField::PRIORITY;
+    query.descending = false;
+    query.after = TaskCursor{medium, INT_MAX};
+    for (const auto& task : snapshot->query(query)) {
+        EXPECT_GT(static_cast<long long>(task.getPriority()), medium);
+    }
+    EXPECT_EQ(snapshot->query(query).size(), 10u);
+    query.descending = true;
+    query.after = TaskCursor{medium, INT_MIN};
+    for (const auto& task : snapshot->query(query)) {
+        EXPECT_LT(static_cast<long long>(task.getPriority()), medium);
+    }
+    EXPECT_EQ(snapshot->query(query).size(), 10u);
+
+    query.sortBy = TaskSortField::CREATED_AT;
+    query.descending = false;
+    query.after = TaskCursor{LLONG_MAX, INT_MAX};
+    EXPECT_TRUE(snapshot->query(query).empty());
+    query.descending = true;
+    query.after = TaskCursor{LLONG_MIN, INT_MIN};
+    EXPECT_TRUE(snapshot->query(query).empty());
+}
+
+// Test a huge id costs one chunk, not one per CHUNK_SIZE ids below it, and
+// still finds, iterates and pages in order
+TEST(TaskSnapshotTest, HugeIdsStaySparse) {
+    auto snapshot = TaskSnapshot::build(makeTasks(300), 1);
+    snapshot = snapshot->withTask(Task(INT_MAX, "Last", "Desc"), 2);
+    snapshot = snapshot->withTask(Task(INT_MAX / 2, "Middle", "Desc"), 3);
+    EXPECT_EQ(snapshot->size(), 302u);
+    ASSERT_NE(snapshot->find(INT_MAX), nullptr);
+    EXPECT_EQ(snapshot->find(INT_MAX)->getTitle(), "Last");
+    EXPECT_EQ(snapshot->find(INT_MAX - 1), nullptr);
+
+    // Copying the snapshot for a write stays cheap
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < 1000; i++) {
+        snapshot = snapshot->withTask(Task(1, "Task 1", "Desc"), 4 + i);
+    }
+    EXPECT_LT(chrono::steady_clock::now() - start, chrono::seconds(1));
+
+    vector<int> ids;
+    snapshot->forEach([&ids](const Task& task) {
+        ids.push_back(task.getId());
+        return true;
+    });
+    ASSERT_EQ(ids.size(), 302u);
+    EXPECT_EQ(ids[299], 300);
+    EXPECT_EQ(ids[300], INT_MAX / 2);
+    EXPECT_EQ(ids[301], INT_MAX);
+
+    TaskQuery query;
+    query.descending = true;
+    query.limit = 3;
+    vector<Task> page = snapshot->query(query);
+    ASSERT_EQ(page.size(), 3u);
+    EXPECT_EQ(page[0].getId(), INT_MAX);
+    EXPECT_EQ(page[2].getId(), 300);
+    query.after = query.cursorAt(page[1]);
+    EXPECT_EQ(snapshot->query(query)[0].getId(), 300);
+
+    query.descending = false;
+    query.after = query.cursorAt(Task(300, "", ""));
+    page = snapshot->query(query);
+    ASSERT_EQ(page.size(), 2u);
+    EXPECT_EQ(page[0].getId(), INT_MAX / 2);
+
+    snapshot = snapshot->withoutTask(INT_MAX, 2000)->withoutTask(INT_MAX / 2, 2001);
+    EXPECT_EQ(snapshot->size(), 300u);
+    EXPECT_EQ(snapshot->find(INT_MAX), nullptr);
+}
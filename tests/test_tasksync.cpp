@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "TaskSync.hpp"
+#include <filesystem>
+
+class TaskSyncTest : public ::testing::Test {
+protected:
+    const string jsonPath = "test_tasksync.json";
+    const string dbPath = "test_tasksync.db";
+    FileHandler* json;
+    SQLiteHandler* db;
+
+    void removeFiles() {
+        std::filesystem::remove(jsonPath);
+        std::filesystem::remove(dbPath);
+        std::filesystem::remove(dbPath + "-wal");
+        std::filesystem::remove(dbPath + "-shm");
+    }
+
+    void SetUp() override {
+        removeFiles();
+        json = new FileHandler(jsonPath);
+        db = new SQLiteHandler(dbPath);
+        ASSERT_TRUE(db->connect());
+    }
+
+    void TearDown() override {
+        delete db;
+        delete json;
+        removeFiles();
+    }
+
+    static Task makeTask(int id, const string& title) {
+        Task task(id, title, "", Priority::MEDIUM);
+        task.setCreatedAt(1700000000 + id);
+        return task;
+    }
+
+    vector<Task> loadJson() {
+        vector<Task> tasks;
+        int nextId = 0;
+        json->loadTasks(tasks, nextId);
+        return tasks;
+    }
+};
+
+// Test the first sync merges both stores without duplicating ids
+TEST_F(TaskSyncTest, FirstSyncMergesBothSides) {
+    ASSERT_TRUE(json->saveTasks({makeTask(1, "JSON only"), makeTask(2, "JSON copy")}, 3));
+    ASSERT_TRUE(db->saveTasks({makeTask(2, "SQLite copy"), makeTask(3, "SQLite only")}, 4));
+
+    TaskSync sync(*json, *db);
+    SyncReport report;
+    ASSERT_TRUE(sync.sync(report));
+
+    EXPECT_EQ(report.conflicts, 1);
+    EXPECT_EQ(report.toSqlite, 1);
+    EXPECT_EQ(report.toJson, 2);
+
+    vector<Task> merged = loadJson();
+    ASSERT_EQ(merged.size(), 3u);
+    EXPECT_EQ(merged[1].getTitle(), "SQLite copy");  // SQLite wins conflicts by default
+    EXPECT_EQ(merged[2].getId(), 3);
+    EXPECT_EQ(db->countTasks(TaskQuery()), 3);
+}
+
+// Test later syncs copy only the tasks edited since, in each direction
+TEST_F(TaskSyncTest, IncrementalEditsAndDeletes) {
+    ASSERT_TRUE(json->saveTasks({makeTask(1, "One"), makeTask(2, "Two"), makeTask(3, "Three")}, 4));
+    TaskSync sync(*json, *db);
+    SyncReport report;
+    ASSERT_TRUE(sync.sync(report));
+    EXPECT_EQ(report.toSqlite, 3);
+
+    // CLI edits task 1; the server deletes task 3 and adds task 4
+    vector<Task> edited = loadJson();
+    edited[0].setStatus(Status::COMPLETED);
+    ASSERT_TRUE(json->saveTasks(edited, 4));
+    ASSERT_TRUE(db->deleteTask(3));
+    ASSERT_EQ(db->upsertTasks({makeTask(4, "Four")}), 1);
+
+    ASSERT_TRUE(sync.sync(report));
+    EXPECT_EQ(report.toSqlite, 1);
+    EXPECT_EQ(report.toJson, 1);
+    EXPECT_EQ(report.deletedFromJson, 1);
+    EXPECT_EQ(report.unchanged, 1);
+    EXPECT_EQ(report.conflicts, 0);
+
+    EXPECT_EQ(db->getTaskById(1)->getStatus(), Status::COMPLETED);
+    vector<Task> merged = loadJson();
+    ASSERT_EQ(merged.size(), 3u);
+    EXPECT_EQ(merged[2].getTitle(), "Four");
+
+    // Nothing changed since: nothing is copied
+    ASSERT_TRUE(sync.sync(report));
+    EXPECT_EQ(report.toSqlite + report.toJson + report.deletedFromJson + report.deletedFromSqlite, 0);
+    EXPECT_EQ(report.unchanged, 3);
+}
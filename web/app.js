@@ -6,28 +6,122 @@ const API_BASE_URL = window.location.hostname === 'localhost'
 // Global state
 let allTasks = [];
 let currentFilter = { status: 'all', priority: 'all' };
+let eventSource = null;     // Change feed from /api/events
+let lastEventId = null;     // Feed position the loaded list is current to
 
 // Initialize
 document.addEventListener('DOMContentLoaded', () => {
-    loadTasks();
-    setInterval(loadTasks, 30000); // Auto-refresh every 30 seconds
+    connect();
 });
 
-// Load all tasks from API
+// Load the list (after the first time, only what changed), then apply
+// changes from the event feed
+async function connect() {
+    if (eventSource) {
+        eventSource.close();
+        eventSource = null;
+    }
+    if (!await (lastEventId ? syncTasks() : loadTasks())) {
+        setTimeout(connect, 30000); // Retry while the API is down
+        return;
+    }
+    
+    const since = lastEventId ? `?since=${encodeURIComponent(lastEventId)}` : '';
+    eventSource = new EventSource(`${API_BASE_URL}/events${since}`);
+    eventSource.onmessage = (message) => {
+        applyChange(JSON.parse(message.data));
+        lastEventId = message.lastEventId;
+    };
+    eventSource.onerror = () => {
+        // EventSource reconnects and resumes by itself; a refused stream
+        // (e.g. too many subscribers) is closed for good
+        if (eventSource.readyState === EventSource.CLOSED) {
+            setTimeout(connect, 30000);
+        }
+    };
+}
+
+function feedIsOpen() {
+    return eventSource !== null && eventSource.readyState === EventSource.OPEN;
+}
+
+// Load all tasks from API; returns false on failure
 async function loadTasks() {
     try {
         const response = await fetch(`${API_BASE_URL}/tasks`);
         if (!response.ok) throw new Error('Failed to fetch tasks');
         
+        lastEventId = response.headers.get('X-Event-Id');
         allTasks = await response.json();
         displayTasks(allTasks);
         updateStatistics();
+        return true;
     } catch (error) {
         console.error('Error loading tasks:', error);
         showError('Failed to load tasks. Make sure API server is running.');
+        return false;
+    }
+}
+
+// Bring the list up to date with the tasks written and deleted since
+// lastEventId; the server sends everything if it can no longer tell
+async function syncTasks() {
+    try {
+        const response = await fetch(`${API_BASE_URL}/tasks?since=${encodeURIComponent(lastEventId)}`);
+        if (!response.ok) throw new Error('Failed to sync tasks');
+        
+        const delta = await response.json();
+        if (delta.full) {
+            allTasks = delta.tasks;
+        } else {
+            const index = new Map(allTasks.map((t, i) => [t.id, i]));
+            for (const task of delta.tasks) {
+                if (index.has(task.id)) allTasks[index.get(task.id)] = task;
+                else allTasks.push(task);
+            }
+            const deleted = new Set(delta.deleted);
+            allTasks = allTasks.filter(t => !deleted.has(t.id));
+        }
+        lastEventId = delta.version;
+        displayTasks(allTasks);
+        updateStatistics();
+        return true;
+    } catch (error) {
+        console.error('Error syncing tasks:', error);
+        showError('Failed to load tasks. Make sure API server is running.');
+        return false;
     }
 }
 
+// Apply one event from the feed
+function applyChange(change) {
+    if (change.type === 'upsert') {
+        upsertTask(change.task);
+    } else if (change.type === 'delete') {
+        removeTask(change.id);
+    } else {
+        connect();  // Whole-list change or the feed lost track; resync
+    }
+}
+
+// Insert or replace a task in the local list and redraw
+function upsertTask(task) {
+    const index = allTasks.findIndex(t => t.id === task.id);
+    if (index >= 0) {
+        allTasks[index] = task;
+    } else {
+        allTasks.push(task);
+    }
+    displayTasks(allTasks);
+    updateStatistics();
+}
+
+function removeTask(id) {
+    allTasks = allTasks.filter(t => t.id !== id);
+    displayTasks(allTasks);
+    updateStatistics();
+}
+
 // Display tasks
 function displayTasks(tasks) {
     const container = document.getElementById('tasks-container');
@@ -131,7 +225,8 @@ async function saveTask(event) {
         if (!response.ok) throw new Error('Failed to save task');
         
         closeModal();
-        loadTasks();
+        const saved = await response.json();
+        if (!feedIsOpen()) upsertTask(saved);   // Otherwise the feed delivers it in order
         showSuccess(taskId ? 'Task updated!' : 'Task created!');
     } catch (error) {
         console.error('Error saving task:', error);
@@ -150,7 +245,7 @@ async function deleteTask(id) {
         
         if (!response.ok) throw new Error('Failed to delete task');
         
-        loadTasks();
+        if (!feedIsOpen()) removeTask(id);
         showSuccess('Task deleted!');
     } catch (error) {
         console.error('Error deleting task:', error);